@@ -1431,6 +1431,59 @@ enum aome_enc_control_id {
    */
   AV1E_SET_FP_MT_UNIT_TEST = 154,
 
+  /*!\brief Codec control function to run the first pass on a 2x decimated
+   * proxy of the source, unsigned int parameter
+   *
+   * - 0 = disable (default)
+   * - 1 = enable
+   *
+   * \note The first pass stats are normalized to the full resolution
+   * macroblock grid, so they remain usable by the second pass unchanged.
+   * Only the first pass of a two pass encode is downscaled. The lookahead
+   * analysis of a one pass encode always runs at full resolution.
+   */
+  AV1E_SET_FIRSTPASS_DOWNSCALE = 155,
+
+  /*!\brief Codec control function to set the encode time budget per frame
+   * in microseconds for the realtime mode, unsigned int parameter
+   *
+   * The encoder measures the time spent on each frame and raises the speed
+   * from the one set with AOME_SET_CPUUSED when the budget is exceeded, and
+   * lowers it back towards it when there is enough headroom. Scene changes
+   * are encoded one speed level higher.
+   *
+   * - 0 = disable (default)
+   *
+   * \note Only in effect in the realtime mode with AOME_SET_CPUUSED >= 7.
+   * With spatial layers, the budget applies to each layer's encode call.
+   */
+  AV1E_SET_FRAME_TIME_BUDGET = 156,
+
+  /*!\brief Codec control function to get the speed the last frame was
+   * encoded at, int * parameter
+   *
+   * This is the speed set with AOME_SET_CPUUSED, unless
+   * AV1E_SET_FRAME_TIME_BUDGET has raised it.
+   */
+  AV1E_GET_FRAME_SPEED = 157,
+
+  /*!\brief Codec control function to pipeline the spatial layers of an SVC
+   * encode, unsigned int parameter
+   *
+   * The loop filter, CDEF and the border extension of a spatial layer run on
+   * a worker thread, and the encode of the next spatial layer starts as soon
+   * as the superblock rows it needs from that reconstruction are ready.
+   *
+   * - 0 = disable (default)
+   * - 1 = enable
+   *
+   * \note Only in effect in the realtime mode when the upper layer predicts
+   * from the lower one with a zero motion vector, which needs the references
+   * set with AV1E_SET_SVC_REF_FRAME_CONFIG. The bitstream is the same as
+   * without it.
+   */
+  AV1E_SET_SVC_LAYER_PIPELINE = 158,
+
   // Any new encoder control IDs should be added above.
   // Maximum allowed encoder control ID is 229.
   // No encoder control ID should be added below.
@@ -2011,6 +2064,18 @@ AOM_CTRL_USE_TYPE(AV1E_SET_FP_MT, unsigned int)
 AOM_CTRL_USE_TYPE(AV1E_SET_FP_MT_UNIT_TEST, unsigned int)
 #define AOM_CTRL_AV1E_SET_FP_MT_UNIT_TEST
 
+AOM_CTRL_USE_TYPE(AV1E_SET_FIRSTPASS_DOWNSCALE, unsigned int)
+#define AOM_CTRL_AV1E_SET_FIRSTPASS_DOWNSCALE
+
+AOM_CTRL_USE_TYPE(AV1E_SET_FRAME_TIME_BUDGET, unsigned int)
+#define AOM_CTRL_AV1E_SET_FRAME_TIME_BUDGET
+
+AOM_CTRL_USE_TYPE(AV1E_GET_FRAME_SPEED, int *)
+#define AOM_CTRL_AV1E_GET_FRAME_SPEED
+
+AOM_CTRL_USE_TYPE(AV1E_SET_SVC_LAYER_PIPELINE, unsigned int)
+#define AOM_CTRL_AV1E_SET_SVC_LAYER_PIPELINE
+
 /*!\endcond */
 /*! @} - end defgroup aom_encoder */
 #ifdef __cplusplus
@@ -183,6 +183,47 @@ typedef struct av1_ext_ref_frame {
   int num;
 } av1_ext_ref_frame_t;
 
+/*!\brief Decoding stages timed by the decoder profiler.
+ *
+ * \sa AV1D_SET_PROFILING, AV1D_GET_PROFILE_STATS
+ */
+typedef enum aom_dec_profile_stage {
+  /*! Parsing of partitions, modes and coefficients. */
+  AOM_DEC_PROFILE_ENTROPY,
+  /*! Prediction and inverse transform. */
+  AOM_DEC_PROFILE_RECON,
+  /*! Deblocking loop filter. */
+  AOM_DEC_PROFILE_LOOP_FILTER,
+  /*! Constrained directional enhancement filter. */
+  AOM_DEC_PROFILE_CDEF,
+  /*! Loop restoration filter. */
+  AOM_DEC_PROFILE_LOOP_RESTORATION,
+  /*! Super-resolution upscaling. */
+  AOM_DEC_PROFILE_SUPERRES,
+  /*! Film grain synthesis. */
+  AOM_DEC_PROFILE_FILM_GRAIN,
+  /*! Number of profiled stages. */
+  AOM_DEC_PROFILE_STAGES
+} aom_dec_profile_stage_t;
+
+/*!\brief Structure to hold the decoder profiling statistics.
+ *
+ * Times are in microseconds. Entropy decoding and reconstruction times are
+ * summed over all threads, the other stages are measured in wall time.
+ */
+typedef struct aom_dec_profile_stats {
+  /*! Number of frames decoded since profiling was enabled. */
+  uint64_t frame_count;
+  /*! Compressed size in bytes of the decoded frames. */
+  uint64_t frame_bytes;
+  /*! Time spent in each stage, indexed by aom_dec_profile_stage_t. */
+  int64_t stage_time[AOM_DEC_PROFILE_STAGES];
+  /*! Compressed size in bytes of the last decoded frame. */
+  uint64_t last_frame_bytes;
+  /*! Time spent in each stage for the last decoded frame. */
+  int64_t last_frame_stage_time[AOM_DEC_PROFILE_STAGES];
+} aom_dec_profile_stats;
+
 /*!\enum aom_dec_control_id
  * \brief AOM decoder control functions
  *
@@ -447,6 +488,21 @@ enum aom_dec_control_id {
    * be used.
    */
   AV1D_GET_MI_INFO,
+
+  /*!\brief Codec control function to enable or disable the per-stage
+   * decoder profiler, unsigned int parameter.
+   *
+   * - 0 = disable (default)
+   * - 1 = enable
+   *
+   * Enabling the profiler resets the statistics.
+   */
+  AV1D_SET_PROFILING,
+
+  /*!\brief Codec control function to get the statistics gathered by the
+   * decoder profiler, aom_dec_profile_stats* parameter.
+   */
+  AV1D_GET_PROFILE_STATS,
 };
 
 /*!\cond */
@@ -563,6 +619,12 @@ AOM_CTRL_USE_TYPE(AV1D_SET_OUTPUT_ALL_LAYERS, int)
 
 AOM_CTRL_USE_TYPE(AV1_SET_INSPECTION_CALLBACK, aom_inspect_init *)
 #define AOM_CTRL_AV1_SET_INSPECTION_CALLBACK
+
+AOM_CTRL_USE_TYPE(AV1D_SET_PROFILING, unsigned int)
+#define AOM_CTRL_AV1D_SET_PROFILING
+
+AOM_CTRL_USE_TYPE(AV1D_GET_PROFILE_STATS, aom_dec_profile_stats *)
+#define AOM_CTRL_AV1D_GET_PROFILE_STATS
 /*!\endcond */
 /*! @} - end defgroup aom_decoder */
 #ifdef __cplusplus
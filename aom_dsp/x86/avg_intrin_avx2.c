@@ -459,6 +459,29 @@ void aom_highbd_hadamard_32x32_avx2(const int16_t *src_diff,
 }
 #endif  // CONFIG_AV1_HIGHBITDEPTH
 
+void aom_avg_8x8_quad_avx2(const uint8_t *s, int p, int x16_idx, int y16_idx,
+                           int *avg) {
+  const uint8_t *s_tmp = s + y16_idx * p + x16_idx;
+  const __m256i zero = _mm256_setzero_si256();
+  // Row i of the top 8x16 goes to the low lane and row i of the bottom 8x16
+  // to the high lane, so the sums end up as { 0, 1 | 2, 3 }.
+  __m256i sum = zero;
+  for (int i = 0; i < 8; i++) {
+    const __m256i rows = _mm256_inserti128_si256(
+        _mm256_castsi128_si256(_mm_loadu_si128((const __m128i *)s_tmp)),
+        _mm_loadu_si128((const __m128i *)(s_tmp + 8 * p)), 1);
+    sum = _mm256_add_epi32(sum, _mm256_sad_epu8(rows, zero));
+    s_tmp += p;
+  }
+  sum = _mm256_srli_epi32(_mm256_add_epi32(sum, _mm256_set1_epi32(32)), 6);
+  const __m128i top = _mm256_castsi256_si128(sum);
+  const __m128i bottom = _mm256_extracti128_si256(sum, 1);
+  avg[0] = _mm_cvtsi128_si32(top);
+  avg[1] = _mm_cvtsi128_si32(_mm_srli_si128(top, 8));
+  avg[2] = _mm_cvtsi128_si32(bottom);
+  avg[3] = _mm_cvtsi128_si32(_mm_srli_si128(bottom, 8));
+}
+
 int aom_satd_avx2(const tran_low_t *coeff, int length) {
   __m256i accum = _mm256_setzero_si256();
   int i;
@@ -139,6 +139,30 @@ unsigned int aom_avg_4x4_sse2(const uint8_t *s, int p) {
   return (avg + 8) >> 4;
 }
 
+void aom_avg_8x8_quad_sse2(const uint8_t *s, int p, int x16_idx, int y16_idx,
+                           int *avg) {
+  const uint8_t *s_tmp = s + y16_idx * p + x16_idx;
+  const __m128i zero = _mm_setzero_si128();
+  // Each 16-byte row sums to (left 8x1, right 8x1) in the two 64-bit halves.
+  __m128i top = zero;
+  __m128i bottom = zero;
+  for (int i = 0; i < 8; i++) {
+    top = _mm_add_epi32(
+        top, _mm_sad_epu8(_mm_loadu_si128((const __m128i *)s_tmp), zero));
+    bottom = _mm_add_epi32(
+        bottom,
+        _mm_sad_epu8(_mm_loadu_si128((const __m128i *)(s_tmp + 8 * p)), zero));
+    s_tmp += p;
+  }
+  const __m128i round = _mm_set1_epi32(32);
+  top = _mm_srli_epi32(_mm_add_epi32(top, round), 6);
+  bottom = _mm_srli_epi32(_mm_add_epi32(bottom, round), 6);
+  avg[0] = _mm_cvtsi128_si32(top);
+  avg[1] = _mm_cvtsi128_si32(_mm_srli_si128(top, 8));
+  avg[2] = _mm_cvtsi128_si32(bottom);
+  avg[3] = _mm_cvtsi128_si32(_mm_srli_si128(bottom, 8));
+}
+
 static INLINE void hadamard_col8_sse2(__m128i *in, int iter) {
   __m128i a0 = in[0];
   __m128i a1 = in[1];
@@ -9,10 +9,12 @@
  * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
  */
 
+#include <assert.h>
 #include <emmintrin.h>  // SSE2
 #include <smmintrin.h>  /* SSE4.1 */
 
 #include "config/aom_dsp_rtcd.h"
+#include "aom_mem/aom_mem.h"
 #include "aom_dsp/x86/intrapred_x86.h"
 #include "aom_dsp/x86/intrapred_utils.h"
 #include "aom_dsp/x86/lpf_common_sse2.h"
@@ -1310,3 +1312,194 @@ void av1_dr_prediction_z3_sse4_1(uint8_t *dst, ptrdiff_t stride, int bw, int bh,
     }
   }
 }
+
+#if CONFIG_AV1_HIGHBITDEPTH
+// High bit depth functions. The interpolation is done on 32-bit lanes, which
+// do not overflow for any bit depth.
+
+// Returns (a * (32 - shift) + b * shift + 16) >> 5 for each 32-bit lane.
+static INLINE __m128i highbd_dr_interp_sse4_1(__m128i a, __m128i b,
+                                              __m128i shift) {
+  const __m128i diff = _mm_sub_epi32(b, a);
+  __m128i val = _mm_add_epi32(_mm_slli_epi32(a, 5), _mm_set1_epi32(16));
+  val = _mm_add_epi32(val, _mm_mullo_epi32(diff, shift));
+  return _mm_srai_epi32(val, 5);
+}
+
+// Loads edge[i] and edge[i + 1] for the 4 lanes starting at edge, in steps of
+// 1 << upsample.
+static INLINE void highbd_dr_load_edge_sse4_1(const uint16_t *edge,
+                                              int upsample, __m128i *a,
+                                              __m128i *b) {
+  if (upsample) {
+    const __m128i v = _mm_loadu_si128((const __m128i *)edge);
+    *a = _mm_blend_epi16(v, _mm_setzero_si128(), 0xAA);
+    *b = _mm_srli_epi32(v, 16);
+  } else {
+    *a = _mm_cvtepu16_epi32(_mm_loadl_epi64((const __m128i *)edge));
+    *b = _mm_cvtepu16_epi32(_mm_loadl_epi64((const __m128i *)(edge + 1)));
+  }
+}
+
+// Zone 1 prediction from the given edge. Zone 3 is the same prediction from
+// the left edge, transposed.
+static void highbd_dr_z1_sse4_1(uint16_t *dst, ptrdiff_t stride, int bw,
+                                int bh, const uint16_t *edge, int upsample,
+                                int dx) {
+  const int max_base_x = ((bw + bh) - 1) << upsample;
+  const int frac_bits = 6 - upsample;
+  const int base_inc = 1 << upsample;
+  const __m128i max_base = _mm_set1_epi32(max_base_x);
+  const __m128i edge_max = _mm_set1_epi32(edge[max_base_x]);
+  const __m128i lane_base =
+      _mm_setr_epi32(0, base_inc, 2 * base_inc, 3 * base_inc);
+  int x = dx;
+  for (int r = 0; r < bh; ++r, dst += stride, x += dx) {
+    int base = x >> frac_bits;
+    if (base >= max_base_x) {
+      for (int i = r; i < bh; ++i) {
+        aom_memset16(dst, edge[max_base_x], bw);
+        dst += stride;
+      }
+      return;
+    }
+    const __m128i shift = _mm_set1_epi32(((x << upsample) & 0x3F) >> 1);
+    for (int c = 0; c < bw; c += 4, base += 4 * base_inc) {
+      if (base >= max_base_x) {
+        aom_memset16(dst + c, edge[max_base_x], bw - c);
+        break;
+      }
+      __m128i a, b;
+      highbd_dr_load_edge_sse4_1(edge + base, upsample, &a, &b);
+      const __m128i val = highbd_dr_interp_sse4_1(a, b, shift);
+      const __m128i in_range =
+          _mm_cmplt_epi32(_mm_add_epi32(_mm_set1_epi32(base), lane_base),
+                          max_base);
+      const __m128i res = _mm_blendv_epi8(edge_max, val, in_range);
+      _mm_storel_epi64((__m128i *)(dst + c), _mm_packus_epi32(res, res));
+    }
+  }
+}
+
+void av1_highbd_dr_prediction_z1_sse4_1(uint16_t *dst, ptrdiff_t stride,
+                                        int bw, int bh, const uint16_t *above,
+                                        const uint16_t *left,
+                                        int upsample_above, int dx, int dy,
+                                        int bd) {
+  (void)left;
+  (void)dy;
+  (void)bd;
+  assert(dy == 1);
+  assert(dx > 0);
+  highbd_dr_z1_sse4_1(dst, stride, bw, bh, above, upsample_above, dx);
+}
+
+void av1_highbd_dr_prediction_z2_sse4_1(uint16_t *dst, ptrdiff_t stride,
+                                        int bw, int bh, const uint16_t *above,
+                                        const uint16_t *left,
+                                        int upsample_above, int upsample_left,
+                                        int dx, int dy, int bd) {
+  (void)bd;
+  assert(dx > 0);
+  assert(dy > 0);
+
+  const int min_base_x = -(1 << upsample_above);
+  const int min_base_y = -(1 << upsample_left);
+  const int frac_bits_x = 6 - upsample_above;
+  const int frac_bits_y = 6 - upsample_left;
+  const __m128i lane = _mm_setr_epi32(0, 1, 2, 3);
+  const __m128i min_base_x_m1 = _mm_set1_epi32(min_base_x - 1);
+  const __m128i min_base_y_v = _mm_set1_epi32(min_base_y);
+  const __m128i shift_mask = _mm_set1_epi32(0x3F);
+
+  for (int r = 0; r < bh; ++r, dst += stride) {
+    const int y = r + 1;
+    for (int c = 0; c < bw; c += 4) {
+      const __m128i col = _mm_add_epi32(_mm_set1_epi32(c), lane);
+      // Positions on the above row.
+      const __m128i x = _mm_sub_epi32(_mm_slli_epi32(col, 6),
+                                      _mm_set1_epi32(y * dx));
+      const __m128i base_x = _mm_srai_epi32(x, frac_bits_x);
+      const __m128i use_above = _mm_cmpgt_epi32(base_x, min_base_x_m1);
+      const int above_mask = _mm_movemask_ps(_mm_castsi128_ps(use_above));
+
+      __m128i res_above = _mm_setzero_si128();
+      if (above_mask) {
+        // The lanes are consecutive positions on the above row, and those on
+        // the left of min_base_x are not used.
+        const int base0 = ((c << 6) - y * dx) >> frac_bits_x;
+        __m128i a, b;
+        highbd_dr_load_edge_sse4_1(above + base0, upsample_above, &a, &b);
+        const __m128i shift = _mm_srli_epi32(
+            _mm_and_si128(_mm_slli_epi32(x, upsample_above), shift_mask), 1);
+        res_above = highbd_dr_interp_sse4_1(a, b, shift);
+      }
+
+      __m128i res = res_above;
+      if (above_mask != 0xF) {
+        // Positions on the left column.
+        const __m128i yl = _mm_sub_epi32(
+            _mm_set1_epi32(r << 6),
+            _mm_mullo_epi32(_mm_add_epi32(col, _mm_set1_epi32(1)),
+                            _mm_set1_epi32(dy)));
+        const __m128i base_y =
+            _mm_max_epi32(_mm_srai_epi32(yl, frac_bits_y), min_base_y_v);
+        const int y0 = _mm_extract_epi32(base_y, 0);
+        const int y1 = _mm_extract_epi32(base_y, 1);
+        const int y2 = _mm_extract_epi32(base_y, 2);
+        const int y3 = _mm_extract_epi32(base_y, 3);
+        const __m128i a =
+            _mm_setr_epi32(left[y0], left[y1], left[y2], left[y3]);
+        const __m128i b = _mm_setr_epi32(left[y0 + 1], left[y1 + 1],
+                                         left[y2 + 1], left[y3 + 1]);
+        const __m128i shift = _mm_srli_epi32(
+            _mm_and_si128(_mm_slli_epi32(yl, upsample_left), shift_mask), 1);
+        const __m128i res_left = highbd_dr_interp_sse4_1(a, b, shift);
+        res = _mm_blendv_epi8(res_left, res_above, use_above);
+      }
+      _mm_storel_epi64((__m128i *)(dst + c), _mm_packus_epi32(res, res));
+    }
+  }
+}
+
+// Transposes a 4x4 block of 16-bit values.
+static INLINE void highbd_transpose4x4_sse4_1(const uint16_t *src,
+                                              ptrdiff_t src_stride,
+                                              uint16_t *dst,
+                                              ptrdiff_t dst_stride) {
+  const __m128i r0 = _mm_loadl_epi64((const __m128i *)(src + 0 * src_stride));
+  const __m128i r1 = _mm_loadl_epi64((const __m128i *)(src + 1 * src_stride));
+  const __m128i r2 = _mm_loadl_epi64((const __m128i *)(src + 2 * src_stride));
+  const __m128i r3 = _mm_loadl_epi64((const __m128i *)(src + 3 * src_stride));
+  const __m128i t0 = _mm_unpacklo_epi16(r0, r1);
+  const __m128i t1 = _mm_unpacklo_epi16(r2, r3);
+  const __m128i u0 = _mm_unpacklo_epi32(t0, t1);
+  const __m128i u1 = _mm_unpackhi_epi32(t0, t1);
+  _mm_storel_epi64((__m128i *)(dst + 0 * dst_stride), u0);
+  _mm_storel_epi64((__m128i *)(dst + 1 * dst_stride), _mm_srli_si128(u0, 8));
+  _mm_storel_epi64((__m128i *)(dst + 2 * dst_stride), u1);
+  _mm_storel_epi64((__m128i *)(dst + 3 * dst_stride), _mm_srli_si128(u1, 8));
+}
+
+void av1_highbd_dr_prediction_z3_sse4_1(uint16_t *dst, ptrdiff_t stride,
+                                        int bw, int bh, const uint16_t *above,
+                                        const uint16_t *left,
+                                        int upsample_left, int dx, int dy,
+                                        int bd) {
+  (void)above;
+  (void)dx;
+  (void)bd;
+  assert(dx == 1);
+  assert(dy > 0);
+
+  // Row c of tmp is column c of the prediction.
+  DECLARE_ALIGNED(16, uint16_t, tmp[64 * 64]);
+  highbd_dr_z1_sse4_1(tmp, bh, bh, bw, left, upsample_left, dy);
+  for (int c = 0; c < bw; c += 4) {
+    for (int r = 0; r < bh; r += 4) {
+      highbd_transpose4x4_sse4_1(tmp + c * bh + r, bh, dst + r * stride + c,
+                                 stride);
+    }
+  }
+}
+#endif  // CONFIG_AV1_HIGHBITDEPTH
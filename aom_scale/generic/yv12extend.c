@@ -211,6 +211,46 @@ void aom_extend_frame_borders_y_c(YV12_BUFFER_CONFIG *ybf) {
 }
 
 #if CONFIG_AV1_HIGHBITDEPTH
+// Extends the left and right borders of the luma rows [row_start, row_end) and
+// of the co-located chroma rows. The top border is extended with the first
+// rows and the bottom border with the last rows of the frame.
+void aom_extend_frame_borders_rows_c(YV12_BUFFER_CONFIG *ybf, int row_start,
+                                     int row_end, const int num_planes) {
+  const int ss_y = ybf->subsampling_y;
+  assert(ybf->y_height - ybf->y_crop_height < 16);
+  assert(ybf->y_width - ybf->y_crop_width < 16);
+  assert(ybf->y_height - ybf->y_crop_height >= 0);
+  assert(ybf->y_width - ybf->y_crop_width >= 0);
+  assert(row_start % 2 == 0);
+
+  if (row_end > ybf->y_crop_height) row_end = ybf->y_crop_height;
+  if (row_start >= row_end) return;
+  const int is_last = row_end == ybf->y_crop_height;
+
+  for (int plane = 0; plane < num_planes; ++plane) {
+    const int is_uv = plane > 0;
+    const int start = row_start >> (is_uv ? ss_y : 0);
+    const int end = is_last ? ybf->crop_heights[is_uv]
+                            : row_end >> (is_uv ? ss_y : 0);
+    const int border = ybf->border >> (is_uv ? ss_y : 0);
+    const int left = ybf->border >> (is_uv ? ybf->subsampling_x : 0);
+    const int top = row_start == 0 ? border : 0;
+    const int bottom =
+        is_last ? border + ybf->heights[is_uv] - ybf->crop_heights[is_uv] : 0;
+    const int right = left + ybf->widths[is_uv] - ybf->crop_widths[is_uv];
+    uint8_t *const buf = ybf->buffers[plane] + start * ybf->strides[is_uv];
+#if CONFIG_AV1_HIGHBITDEPTH
+    if (ybf->flags & YV12_FLAG_HIGHBITDEPTH) {
+      extend_plane_high(buf, ybf->strides[is_uv], ybf->crop_widths[is_uv],
+                        end - start, top, left, bottom, right);
+      continue;
+    }
+#endif
+    extend_plane(buf, ybf->strides[is_uv], ybf->crop_widths[is_uv],
+                 end - start, top, left, bottom, right);
+  }
+}
+
 static void memcpy_short_addr(uint8_t *dst8, const uint8_t *src8, int num) {
   uint16_t *dst = CONVERT_TO_SHORTPTR(dst8);
   uint16_t *src = CONVERT_TO_SHORTPTR(src8);
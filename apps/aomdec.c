@@ -106,15 +106,17 @@ static const arg_def_t outallarg = ARG_DEF(
     NULL, "all-layers", 0, "Output all decoded frames of a scalable bitstream");
 static const arg_def_t skipfilmgrain =
     ARG_DEF(NULL, "skip-film-grain", 0, "Skip film grain application");
+static const arg_def_t profilearg =
+    ARG_DEF(NULL, "profile", 0, "Show the time spent in each decoding stage");
 
 static const arg_def_t *all_args[] = {
-  &help,           &codecarg, &use_yv12,      &use_i420,
-  &flipuvarg,      &rawvideo, &noblitarg,     &progressarg,
-  &limitarg,       &skiparg,  &summaryarg,    &outputfile,
-  &threadsarg,     &rowmtarg, &verbosearg,    &scalearg,
-  &fb_arg,         &md5arg,   &framestatsarg, &continuearg,
-  &outbitdeptharg, &isannexb, &oppointarg,    &outallarg,
-  &skipfilmgrain,  NULL
+  &help,           &codecarg,   &use_yv12,      &use_i420,
+  &flipuvarg,      &rawvideo,   &noblitarg,     &progressarg,
+  &limitarg,       &skiparg,    &summaryarg,    &outputfile,
+  &threadsarg,     &rowmtarg,   &verbosearg,    &scalearg,
+  &fb_arg,         &md5arg,     &framestatsarg, &continuearg,
+  &outbitdeptharg, &isannexb,   &oppointarg,    &outallarg,
+  &skipfilmgrain,  &profilearg, NULL
 };
 
 #if CONFIG_LIBYUV
@@ -285,6 +287,23 @@ static void show_progress(int frame_in, int frame_out, uint64_t dx_time) {
           (double)frame_out * 1000000.0 / (double)dx_time);
 }
 
+static void show_profile_stats(const aom_dec_profile_stats *stats,
+                               uint64_t dx_time) {
+  static const char *const stage_names[AOM_DEC_PROFILE_STAGES] = {
+    "entropy", "recon",    "loop filter", "cdef",
+    "lr",      "superres", "film grain"
+  };
+  if (stats->frame_count == 0) return;
+  fprintf(stderr, "%" PRIu64 " frames, %" PRIu64 " bytes (%.1f bytes/frame)\n",
+          stats->frame_count, stats->frame_bytes,
+          (double)stats->frame_bytes / (double)stats->frame_count);
+  for (int i = 0; i < AOM_DEC_PROFILE_STAGES; ++i) {
+    fprintf(stderr, "  %-12s %10.2f ms %6.2f%%\n", stage_names[i],
+            stats->stage_time[i] / 1000.0,
+            dx_time ? 100.0 * stats->stage_time[i] / (double)dx_time : 0.0);
+  }
+}
+
 struct ExternalFrameBuffer {
   uint8_t *data;
   size_t size;
@@ -459,6 +478,7 @@ static int main_loop(int argc, const char **argv_) {
   int operating_point = 0;
   int output_all_layers = 0;
   int skip_film_grain = 0;
+  int profile = 0;
   int enable_row_mt = 0;
   aom_image_t *scaled_img = NULL;
   aom_image_t *img_shifted = NULL;
@@ -577,6 +597,8 @@ static int main_loop(int argc, const char **argv_) {
       output_all_layers = 1;
     } else if (arg_match(&arg, &skipfilmgrain, argi)) {
       skip_film_grain = 1;
+    } else if (arg_match(&arg, &profilearg, argi)) {
+      profile = 1;
     } else {
       argj++;
     }
@@ -721,6 +743,13 @@ static int main_loop(int argc, const char **argv_) {
     goto fail;
   }
 
+  if (profile &&
+      AOM_CODEC_CONTROL_TYPECHECKED(&decoder, AV1D_SET_PROFILING, 1u)) {
+    fprintf(stderr, "Failed to enable profiling: %s\n",
+            aom_codec_error(&decoder));
+    goto fail;
+  }
+
   if (arg_skip) fprintf(stderr, "Skipping first %d frames.\n", arg_skip);
   while (arg_skip) {
     if (read_frame(&input, &buf, &bytes_in_buffer, &buffer_size)) break;
@@ -971,6 +1000,13 @@ static int main_loop(int argc, const char **argv_) {
     fprintf(stderr, "\n");
   }
 
+  if (profile) {
+    aom_dec_profile_stats stats;
+    if (AOM_CODEC_CONTROL_TYPECHECKED(&decoder, AV1D_GET_PROFILE_STATS,
+                                      &stats) == AOM_CODEC_OK)
+      show_profile_stats(&stats, dx_time);
+  }
+
   if (frames_corrupted) {
     fprintf(stderr, "WARNING: %d frames corrupted.\n", frames_corrupted);
   } else {
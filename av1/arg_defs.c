@@ -651,6 +651,17 @@ const av1_codec_arg_definitions_t g_av1_codec_arg_defs = {
       "Automatically turn off several intra coding tools for allintra mode. "
       "Only in effect if --deltaq-mode=3."),
 
+  .firstpass_downscale = ARG_DEF(
+      NULL, "firstpass-downscale", 1,
+      "Run the first pass of a two pass encode on a 2x decimated source "
+      "(0: false (default), 1: true)"),
+
+  .frame_time_budget = ARG_DEF(
+      NULL, "frame-time-budget", 1,
+      "Encode time budget per frame in microseconds for realtime mode, the "
+      "speed is raised from --cpu-used as needed to meet it (0: off "
+      "(default))"),
+
   .two_pass_input =
       ARG_DEF(NULL, "two-pass-input", 1,
               "The input file for the second pass for three-pass encoding."),
@@ -187,6 +187,13 @@ struct av1_extracfg {
   // "--enable_cfl_intra",
   // "--enable_diagonal_intra".
   int auto_intra_tools_off;
+  // When set to 1, the first pass analyses a 2x decimated proxy of the source.
+  unsigned int firstpass_downscale;
+  // Encode time budget per frame in microseconds for the realtime mode.
+  unsigned int frame_time_budget;
+  // When set to 1, the next spatial layer starts on the filtered rows of the
+  // current one while its filtering completes.
+  unsigned int svc_layer_pipeline;
 };
 
 #if CONFIG_REALTIME_ONLY
@@ -343,6 +350,9 @@ static const struct av1_extracfg default_extra_cfg = {
   NULL,            // two_pass_output
   NULL,            // second_pass_log
   0,               // auto_intra_tools_off
+  0,               // firstpass_downscale
+  0,               // frame_time_budget
+  0,               // svc_layer_pipeline
 };
 #else
 static const struct av1_extracfg default_extra_cfg = {
@@ -489,6 +499,9 @@ static const struct av1_extracfg default_extra_cfg = {
   NULL,            // two_pass_output
   NULL,            // second_pass_log
   0,               // auto_intra_tools_off
+  0,               // firstpass_downscale
+  0,               // frame_time_budget
+  0,               // svc_layer_pipeline
 };
 #endif
 
@@ -838,6 +851,8 @@ static aom_codec_err_t validate_config(aom_codec_alg_priv_t *ctx,
 
   RANGE_CHECK(extra_cfg, deltaq_strength, 0, 1000);
   RANGE_CHECK_HI(extra_cfg, loopfilter_control, 3);
+  RANGE_CHECK_HI(extra_cfg, firstpass_downscale, 1);
+  RANGE_CHECK_HI(extra_cfg, svc_layer_pipeline, 1);
   RANGE_CHECK_HI(extra_cfg, enable_cdef, 2);
 
   return AOM_CODEC_OK;
@@ -1210,6 +1225,7 @@ static aom_codec_err_t set_encoder_config(AV1EncoderConfig *oxcf,
   algo_cfg->enable_tpl_model =
       resize_cfg->resize_mode ? 0 : extra_cfg->enable_tpl_model;
   algo_cfg->loopfilter_control = extra_cfg->loopfilter_control;
+  algo_cfg->firstpass_downscale = extra_cfg->firstpass_downscale;
 
   // Set two-pass stats configuration.
   oxcf->twopass_stats_in = cfg->rc_twopass_stats_in;
@@ -1237,6 +1253,8 @@ static aom_codec_err_t set_encoder_config(AV1EncoderConfig *oxcf,
   kf_cfg->enable_intrabc = extra_cfg->enable_intrabc;
 
   oxcf->speed = extra_cfg->cpu_used;
+  oxcf->frame_time_budget = extra_cfg->frame_time_budget;
+  oxcf->svc_layer_pipeline = extra_cfg->svc_layer_pipeline;
 
   // Set Color related configuration.
   color_cfg->color_primaries = extra_cfg->color_primaries;
@@ -1537,6 +1555,14 @@ static aom_codec_err_t ctrl_get_baseline_gf_interval(aom_codec_alg_priv_t *ctx,
   return AOM_CODEC_OK;
 }
 
+static aom_codec_err_t ctrl_get_frame_speed(aom_codec_alg_priv_t *ctx,
+                                            va_list args) {
+  int *const arg = va_arg(args, int *);
+  if (arg == NULL) return AOM_CODEC_INVALID_PARAM;
+  *arg = ctx->ppi->cpi->speed;
+  return AOM_CODEC_OK;
+}
+
 static aom_codec_err_t update_extra_cfg(aom_codec_alg_priv_t *ctx,
                                         struct av1_extracfg *extra_cfg) {
   const aom_codec_err_t res = validate_config(ctx, &ctx->cfg, extra_cfg);
@@ -2537,6 +2563,27 @@ static aom_codec_err_t ctrl_set_auto_intra_tools_off(aom_codec_alg_priv_t *ctx,
   return update_extra_cfg(ctx, &extra_cfg);
 }
 
+static aom_codec_err_t ctrl_set_firstpass_downscale(aom_codec_alg_priv_t *ctx,
+                                                    va_list args) {
+  struct av1_extracfg extra_cfg = ctx->extra_cfg;
+  extra_cfg.firstpass_downscale = CAST(AV1E_SET_FIRSTPASS_DOWNSCALE, args);
+  return update_extra_cfg(ctx, &extra_cfg);
+}
+
+static aom_codec_err_t ctrl_set_frame_time_budget(aom_codec_alg_priv_t *ctx,
+                                                  va_list args) {
+  struct av1_extracfg extra_cfg = ctx->extra_cfg;
+  extra_cfg.frame_time_budget = CAST(AV1E_SET_FRAME_TIME_BUDGET, args);
+  return update_extra_cfg(ctx, &extra_cfg);
+}
+
+static aom_codec_err_t ctrl_set_svc_layer_pipeline(aom_codec_alg_priv_t *ctx,
+                                                   va_list args) {
+  struct av1_extracfg extra_cfg = ctx->extra_cfg;
+  extra_cfg.svc_layer_pipeline = CAST(AV1E_SET_SVC_LAYER_PIPELINE, args);
+  return update_extra_cfg(ctx, &extra_cfg);
+}
+
 static aom_codec_err_t encoder_init(aom_codec_ctx_t *ctx) {
   aom_codec_err_t res = AOM_CODEC_OK;
 
@@ -3228,6 +3275,7 @@ static aom_codec_err_t ctrl_get_reference(aom_codec_alg_priv_t *ctx,
   av1_ref_frame_t *const frame = va_arg(args, av1_ref_frame_t *);
 
   if (frame != NULL) {
+    av1_svc_layer_filter_finish(ctx->ppi->cpi);
     YV12_BUFFER_CONFIG *fb = get_ref_frame(&ctx->ppi->cpi->common, frame->idx);
     if (fb == NULL) return AOM_CODEC_ERROR;
 
@@ -3948,6 +3996,12 @@ static aom_codec_err_t encoder_set_option(aom_codec_alg_priv_t *ctx,
   } else if (arg_match_helper(&arg, &g_av1_codec_arg_defs.loopfilter_control,
                               argv, err_string)) {
     extra_cfg.loopfilter_control = arg_parse_int_helper(&arg, err_string);
+  } else if (arg_match_helper(&arg, &g_av1_codec_arg_defs.firstpass_downscale,
+                              argv, err_string)) {
+    extra_cfg.firstpass_downscale = arg_parse_uint_helper(&arg, err_string);
+  } else if (arg_match_helper(&arg, &g_av1_codec_arg_defs.frame_time_budget,
+                              argv, err_string)) {
+    extra_cfg.frame_time_budget = arg_parse_uint_helper(&arg, err_string);
   } else {
     match = 0;
     snprintf(err_string, ARG_ERR_MSG_MAX_LEN, "Cannot find aom option %s",
@@ -4119,6 +4173,9 @@ static aom_codec_ctrl_fn_map_t encoder_ctrl_maps[] = {
   { AV1E_SET_LOOPFILTER_CONTROL, ctrl_set_loopfilter_control },
   { AV1E_SET_AUTO_INTRA_TOOLS_OFF, ctrl_set_auto_intra_tools_off },
   { AV1E_SET_RTC_EXTERNAL_RC, ctrl_set_rtc_external_rc },
+  { AV1E_SET_FIRSTPASS_DOWNSCALE, ctrl_set_firstpass_downscale },
+  { AV1E_SET_FRAME_TIME_BUDGET, ctrl_set_frame_time_budget },
+  { AV1E_SET_SVC_LAYER_PIPELINE, ctrl_set_svc_layer_pipeline },
 
   // Getters
   { AOME_GET_LAST_QUANTIZER, ctrl_get_quantizer },
@@ -4132,6 +4189,7 @@ static aom_codec_ctrl_fn_map_t encoder_ctrl_maps[] = {
   { AV1E_SET_CHROMA_SUBSAMPLING_Y, ctrl_set_chroma_subsampling_y },
   { AV1E_GET_SEQ_LEVEL_IDX, ctrl_get_seq_level_idx },
   { AV1E_GET_BASELINE_GF_INTERVAL, ctrl_get_baseline_gf_interval },
+  { AV1E_GET_FRAME_SPEED, ctrl_get_frame_speed },
 
   CTRL_MAP_END,
 };
@@ -21,6 +21,7 @@
 #include "aom/aom_decoder.h"
 #include "aom_dsp/bitreader_buffer.h"
 #include "aom_dsp/aom_dsp_common.h"
+#include "aom_ports/aom_timer.h"
 #include "aom_ports/mem_ops.h"
 #include "aom_util/aom_thread.h"
 
@@ -48,6 +49,7 @@ struct aom_codec_alg_priv {
   int byte_alignment;
   int skip_loop_filter;
   int skip_film_grain;
+  unsigned int profiling;
   int decode_tile_row;
   int decode_tile_col;
   unsigned int tile_mode;
@@ -387,6 +389,7 @@ static void init_buffer_callbacks(aom_codec_alg_priv_t *ctx) {
   cm->features.byte_alignment = ctx->byte_alignment;
   pbi->skip_loop_filter = ctx->skip_loop_filter;
   pbi->skip_film_grain = ctx->skip_film_grain;
+  pbi->profiling = ctx->profiling;
 
   if (ctx->get_ext_fb_cb != NULL && ctx->release_ext_fb_cb != NULL) {
     pool->get_fb_cb = ctx->get_ext_fb_cb;
@@ -873,8 +876,15 @@ static aom_image_t *decoder_get_frame(aom_codec_alg_priv_t *ctx,
         img->temporal_id = output_frame_buf->temporal_id;
         img->spatial_id = output_frame_buf->spatial_id;
         if (pbi->skip_film_grain) grain_params->apply_grain = 0;
+        struct aom_usec_timer timer;
+        if (pbi->profiling) aom_usec_timer_start(&timer);
         aom_image_t *res =
             add_grain_if_needed(ctx, img, &ctx->image_with_grain, grain_params);
+        if (pbi->profiling) {
+          aom_usec_timer_mark(&timer);
+          av1_dec_profile_add(pbi, AOM_DEC_PROFILE_FILM_GRAIN,
+                              aom_usec_timer_elapsed(&timer));
+        }
         if (!res) {
           aom_internal_error(&pbi->error, AOM_CODEC_CORRUPT_FRAME,
                              "Grain systhesis failed\n");
@@ -1543,6 +1553,37 @@ static aom_codec_err_t ctrl_set_skip_film_grain(aom_codec_alg_priv_t *ctx,
   return AOM_CODEC_OK;
 }
 
+static aom_codec_err_t ctrl_set_profiling(aom_codec_alg_priv_t *ctx,
+                                          va_list args) {
+  ctx->profiling = va_arg(args, unsigned int) != 0;
+
+  if (ctx->frame_worker) {
+    AVxWorker *const worker = ctx->frame_worker;
+    FrameWorkerData *const frame_worker_data = (FrameWorkerData *)worker->data1;
+    AV1Decoder *const pbi = frame_worker_data->pbi;
+    if (ctx->profiling && !pbi->profiling) av1_zero(pbi->profile_stats);
+    pbi->profiling = ctx->profiling;
+  }
+
+  return AOM_CODEC_OK;
+}
+
+static aom_codec_err_t ctrl_get_profile_stats(aom_codec_alg_priv_t *ctx,
+                                              va_list args) {
+  aom_dec_profile_stats *const stats = va_arg(args, aom_dec_profile_stats *);
+  if (stats == NULL) return AOM_CODEC_INVALID_PARAM;
+
+  if (ctx->frame_worker) {
+    AVxWorker *const worker = ctx->frame_worker;
+    FrameWorkerData *const frame_worker_data = (FrameWorkerData *)worker->data1;
+    *stats = frame_worker_data->pbi->profile_stats;
+  } else {
+    memset(stats, 0, sizeof(*stats));
+  }
+
+  return AOM_CODEC_OK;
+}
+
 static aom_codec_err_t ctrl_get_accounting(aom_codec_alg_priv_t *ctx,
                                            va_list args) {
 #if !CONFIG_ACCOUNTING
@@ -1650,6 +1691,7 @@ static aom_codec_ctrl_fn_map_t decoder_ctrl_maps[] = {
   { AV1D_SET_ROW_MT, ctrl_set_row_mt },
   { AV1D_SET_EXT_REF_PTR, ctrl_set_ext_ref_ptr },
   { AV1D_SET_SKIP_FILM_GRAIN, ctrl_set_skip_film_grain },
+  { AV1D_SET_PROFILING, ctrl_set_profiling },
 
   // Getters
   { AOMD_GET_FRAME_CORRUPTED, ctrl_get_frame_corrupted },
@@ -1680,6 +1722,7 @@ static aom_codec_ctrl_fn_map_t decoder_ctrl_maps[] = {
   { AOMD_GET_BASE_Q_IDX, ctrl_get_base_q_idx },
   { AOMD_GET_ORDER_HINT, ctrl_get_order_hint },
   { AV1D_GET_MI_INFO, ctrl_get_mi_info },
+  { AV1D_GET_PROFILE_STATS, ctrl_get_profile_stats },
   CTRL_MAP_END,
 };
 
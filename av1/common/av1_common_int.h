@@ -161,6 +161,19 @@ typedef struct RefCntBuffer {
   // so it's extremely convenient to keep it here.
   int interp_filter_selected[SWITCHABLE];
 
+  // Hash index of the source of this frame for hash based motion search of
+  // screen content. Owned and freed by the encoder.
+  struct RefFrameHashIndex *hash_index;
+
+  // FAST corners of this frame for global motion estimation, detected the
+  // first time it is used as a reference. Owned and freed by the encoder.
+  struct GlobalMotionCorners *gm_corners;
+
+  // Block sizes chosen by the encoder for this frame, used to guide the
+  // partition search of static regions in the next frame. Owned and freed by
+  // the encoder.
+  struct FramePartitionMap *part_map;
+
   // Inter frame reference frame delta for loop filter
   int8_t ref_deltas[REF_FRAMES];
 
@@ -245,12 +245,12 @@ add_proto qw/void av1_inv_txfm2d_add_32x8/, "const int32_t *input, uint16_t *out
 if (aom_config("CONFIG_AV1_HIGHBITDEPTH") eq "yes") {
   # directional intra predictor functions
   add_proto qw/void av1_highbd_dr_prediction_z1/, "uint16_t *dst, ptrdiff_t stride, int bw, int bh, const uint16_t *above, const uint16_t *left, int upsample_above, int dx, int dy, int bd";
-  specialize qw/av1_highbd_dr_prediction_z1 avx2/;
+  specialize qw/av1_highbd_dr_prediction_z1 sse4_1 avx2/;
   add_proto qw/void av1_highbd_dr_prediction_z2/, "uint16_t *dst, ptrdiff_t stride, int bw, int bh, const uint16_t *above, const uint16_t *left, int upsample_above, int upsample_left, int dx, int dy, int bd";
 
-  specialize qw/av1_highbd_dr_prediction_z2 avx2/;
+  specialize qw/av1_highbd_dr_prediction_z2 sse4_1 avx2/;
   add_proto qw/void av1_highbd_dr_prediction_z3/, "uint16_t *dst, ptrdiff_t stride, int bw, int bh, const uint16_t *above, const uint16_t *left, int upsample_left, int dx, int dy, int bd";
-  specialize qw/av1_highbd_dr_prediction_z3 avx2/;
+  specialize qw/av1_highbd_dr_prediction_z3 sse4_1 avx2/;
 }
 
 # build compound seg mask functions
@@ -269,6 +269,10 @@ specialize qw/av1_build_compound_diffwtd_mask_d16 sse4_1 avx2 neon/;
 add_proto qw/void av1_round_shift_array/, "int32_t *arr, int size, int bit";
 specialize "av1_round_shift_array", qw/sse4_1 neon/;
 
+# Coefficient context functions.
+add_proto qw/void av1_get_coeff_ctxs_2d_diag/, "const uint8_t *levels, int bwl, TX_SIZE tx_size, int diag, int row_start, int num, int8_t *nz_ctx, int8_t *br_ctx";
+specialize qw/av1_get_coeff_ctxs_2d_diag avx2/;
+
 # Resize functions.
 add_proto qw/void av1_resize_and_extend_frame/, "const YV12_BUFFER_CONFIG *src, YV12_BUFFER_CONFIG *dst, const InterpFilter filter, const int phase, const int num_planes";
 specialize qw/av1_resize_and_extend_frame ssse3 neon/;
@@ -450,6 +454,10 @@ add_proto qw/void av1_calc_indices_dim2/, "const int *data, const int *centroids
   # hash
   add_proto qw/uint32_t av1_get_crc32c_value/, "void *crc_calculator, uint8_t *p, size_t length";
   specialize qw/av1_get_crc32c_value sse4_2/;
+  add_proto qw/void av1_hash_block_2x2_row/, "void *crc_calculator, const uint8_t *src, int stride, int width, uint32_t *hash1, uint32_t *hash2, int8_t *row_same, int8_t *col_same";
+  specialize qw/av1_hash_block_2x2_row sse4_2/;
+  add_proto qw/void av1_hash_block_quad_row/, "void *crc_calculator, const uint32_t *src1, const uint32_t *src2, int src_size, int stride, int width, uint32_t *dst1, uint32_t *dst2";
+  specialize qw/av1_hash_block_quad_row sse4_2/;
 
   if (aom_config("CONFIG_REALTIME_ONLY") ne "yes") {
     add_proto qw/void av1_compute_stats/,  "int wiener_win, const uint8_t *dgd8, const uint8_t *src8, int h_start, int h_end, int v_start, int v_end, int dgd_stride, int src_stride, int64_t *M, int64_t *H, int use_downsampled_wiener_stats";
@@ -484,10 +492,19 @@ add_proto qw/void av1_calc_indices_dim2/, "const int *data, const int *centroids
     specialize qw/av1_nn_fast_softmax_16 sse3/;
   }
 
+  # av1_nn_predict_batch_avx2() gives the same result as av1_nn_predict_c().
+  # The fixed point network gives the same result in C and SIMD.
+  add_proto qw/void av1_nn_predict_batch/, " const float *input_nodes, int num_blocks, const NN_CONFIG *const nn_config, int reduce_prec, float *const output";
+  specialize qw/av1_nn_predict_batch avx2/;
+  add_proto qw/void av1_nn_fc_int16/, " const int16_t *input, const int16_t *weights, int num_inputs, int num_outputs, int32_t *output";
+  specialize qw/av1_nn_fc_int16 avx2/;
+
   # CNN functions
   if (aom_config("CONFIG_REALTIME_ONLY") ne "yes") {
     add_proto qw/void av1_cnn_activate/, " float **input, int channels, int width, int height, int stride, ACTIVATION layer_activation";
+    specialize qw/av1_cnn_activate avx2/;
     add_proto qw/void av1_cnn_add/, " float **input, int channels, int width, int height, int stride, const float **add";
+    specialize qw/av1_cnn_add avx2/;
     add_proto qw/void av1_cnn_predict/, " const float **input, int in_width, int in_height, int in_stride, const CNN_CONFIG *cnn_config, const CNN_THREAD_DATA *thread_data, CNN_MULTI_OUT *output_struct";
     add_proto qw/void av1_cnn_convolve_no_maxpool_padding_valid/, " const float **input, int in_width, int in_height, int in_stride, const CNN_LAYER_CONFIG *layer_config, float **output, int out_stride, int start_idx, int cstep, int channel_step";
     if (aom_config("CONFIG_EXCLUDE_SIMD_MISMATCH") ne "yes") {
@@ -495,6 +512,7 @@ add_proto qw/void av1_calc_indices_dim2/, "const int *data, const int *centroids
     }
     add_proto qw/void av1_cnn_deconvolve/, " const float **input, int in_width, int in_height, int in_stride, const CNN_LAYER_CONFIG *layer_config, float **output, int out_stride";
     add_proto qw/void av1_cnn_batchnorm/, "float **image, int channels, int width, int height, int stride, const float *gamma, const float *beta, const float *mean, const float *std";
+    specialize qw/av1_cnn_batchnorm avx2/;
   }
 
   # Temporal Denoiser
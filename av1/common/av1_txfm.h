@@ -213,6 +213,15 @@ void av1_gen_inv_stage_range(int8_t *stage_range_col, int8_t *stage_range_row,
 
 void av1_get_fwd_txfm_cfg(TX_TYPE tx_type, TX_SIZE tx_size,
                           TXFM_2D_FLIP_CFG *cfg);
+
+// Computes the forward 2D transforms of all the transform types in tx_mask,
+// sharing the vertical pass between the types with the same vertical 1D
+// transform. The coefficients of tx_type are stored at
+// output + tx_type * tx_size_2d[tx_size], and match av1_fwd_txfm2d_*().
+// Transform sizes with a 64-point dimension are not supported.
+void av1_fwd_txfm2d_tx_types(const int16_t *input, int32_t *output,
+                             int stride, TX_SIZE tx_size, uint16_t tx_mask,
+                             int bd);
 void av1_get_inv_txfm_cfg(TX_TYPE tx_type, TX_SIZE tx_size,
                           TXFM_2D_FLIP_CFG *cfg);
 extern const TXFM_TYPE av1_txfm_type_ls[5][TX_TYPES_1D];
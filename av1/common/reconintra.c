@@ -34,7 +34,6 @@ enum {
 #define INTRA_EDGE_FILT 3
 #define INTRA_EDGE_TAPS 5
 #define MAX_UPSAMPLE_SZ 16
-#define NUM_INTRA_NEIGHBOUR_PIXELS (MAX_TX_SIZE * 2 + 32)
 
 static const uint8_t extend_modes[INTRA_MODES] = {
   NEED_ABOVE | NEED_LEFT,                   // DC
@@ -1325,6 +1324,89 @@ static void build_intra_predictors_high(
 }
 #endif  // CONFIG_AV1_HIGHBITDEPTH
 
+// Filters and upsamples in place the neighboring pixels of a transform block
+// as the directional prediction of the given angle requires.
+static void filter_dr_edges(uint8_t *above_row, uint8_t *left_col,
+                            TX_SIZE tx_size, int p_angle,
+                            int disable_edge_filter, int n_top_px,
+                            int n_left_px, int intra_edge_filter_type,
+                            int *upsample_above_out, int *upsample_left_out) {
+  const int txwpx = tx_size_wide[tx_size];
+  const int txhpx = tx_size_high[tx_size];
+  const int need_above = p_angle < 180;
+  const int need_left = p_angle > 90;
+  int upsample_above = 0;
+  int upsample_left = 0;
+  if (!disable_edge_filter) {
+    const int need_right = p_angle < 90;
+    const int need_bottom = p_angle > 180;
+    if (p_angle != 90 && p_angle != 180) {
+      const int ab_le = 1;
+      if (need_above && need_left && (txwpx + txhpx >= 24)) {
+        filter_intra_edge_corner(above_row, left_col);
+      }
+      if (need_above && n_top_px > 0) {
+        const int strength = intra_edge_filter_strength(
+            txwpx, txhpx, p_angle - 90, intra_edge_filter_type);
+        const int n_px = n_top_px + ab_le + (need_right ? txhpx : 0);
+        av1_filter_intra_edge(above_row - ab_le, n_px, strength);
+      }
+      if (need_left && n_left_px > 0) {
+        const int strength = intra_edge_filter_strength(
+            txhpx, txwpx, p_angle - 180, intra_edge_filter_type);
+        const int n_px = n_left_px + ab_le + (need_bottom ? txwpx : 0);
+        av1_filter_intra_edge(left_col - ab_le, n_px, strength);
+      }
+    }
+    upsample_above = av1_use_intra_edge_upsample(txwpx, txhpx, p_angle - 90,
+                                                 intra_edge_filter_type);
+    if (need_above && upsample_above) {
+      const int n_px = txwpx + (need_right ? txhpx : 0);
+      av1_upsample_intra_edge(above_row, n_px);
+    }
+    upsample_left = av1_use_intra_edge_upsample(txhpx, txwpx, p_angle - 180,
+                                                intra_edge_filter_type);
+    if (need_left && upsample_left) {
+      const int n_px = txhpx + (need_bottom ? txwpx : 0);
+      av1_upsample_intra_edge(left_col, n_px);
+    }
+  }
+  *upsample_above_out = upsample_above;
+  *upsample_left_out = upsample_left;
+}
+
+// Returns a key of the edge filtering and upsampling done by
+// filter_dr_edges(). The angles with the same key share the filtered edges.
+static int get_dr_edge_filter_key(TX_SIZE tx_size, int p_angle,
+                                  int disable_edge_filter,
+                                  int intra_edge_filter_type) {
+  if (disable_edge_filter) return 0;
+  const int txwpx = tx_size_wide[tx_size];
+  const int txhpx = tx_size_high[tx_size];
+  const int need_above = p_angle < 180;
+  const int need_left = p_angle > 90;
+  const int filter = p_angle != 90 && p_angle != 180;
+  const int corner = filter && need_above && need_left && txwpx + txhpx >= 24;
+  const int strength_above =
+      (filter && need_above) ? intra_edge_filter_strength(
+                                   txwpx, txhpx, p_angle - 90,
+                                   intra_edge_filter_type)
+                             : 0;
+  const int strength_left =
+      (filter && need_left) ? intra_edge_filter_strength(
+                                  txhpx, txwpx, p_angle - 180,
+                                  intra_edge_filter_type)
+                            : 0;
+  const int upsample_above = av1_use_intra_edge_upsample(
+      txwpx, txhpx, p_angle - 90, intra_edge_filter_type);
+  const int upsample_left = av1_use_intra_edge_upsample(
+      txhpx, txwpx, p_angle - 180, intra_edge_filter_type);
+  return 1 | (corner << 1) | (strength_above << 2) | (strength_left << 4) |
+         (upsample_above << 6) | (upsample_left << 7) |
+         ((p_angle < 90) << 8) | ((p_angle > 180) << 9) | (need_above << 10) |
+         (need_left << 11);
+}
+
 static void build_intra_predictors(
     const uint8_t *ref, int ref_stride, uint8_t *dst, int dst_stride,
     PREDICTION_MODE mode, int angle_delta, FILTER_INTRA_MODE filter_intra_mode,
@@ -1452,42 +1534,10 @@ static void build_intra_predictors(
   }
 
   if (is_dr_mode) {
-    int upsample_above = 0;
-    int upsample_left = 0;
-    if (!disable_edge_filter) {
-      const int need_right = p_angle < 90;
-      const int need_bottom = p_angle > 180;
-      if (p_angle != 90 && p_angle != 180) {
-        const int ab_le = need_above_left ? 1 : 0;
-        if (need_above && need_left && (txwpx + txhpx >= 24)) {
-          filter_intra_edge_corner(above_row, left_col);
-        }
-        if (need_above && n_top_px > 0) {
-          const int strength = intra_edge_filter_strength(
-              txwpx, txhpx, p_angle - 90, intra_edge_filter_type);
-          const int n_px = n_top_px + ab_le + (need_right ? txhpx : 0);
-          av1_filter_intra_edge(above_row - ab_le, n_px, strength);
-        }
-        if (need_left && n_left_px > 0) {
-          const int strength = intra_edge_filter_strength(
-              txhpx, txwpx, p_angle - 180, intra_edge_filter_type);
-          const int n_px = n_left_px + ab_le + (need_bottom ? txwpx : 0);
-          av1_filter_intra_edge(left_col - ab_le, n_px, strength);
-        }
-      }
-      upsample_above = av1_use_intra_edge_upsample(txwpx, txhpx, p_angle - 90,
-                                                   intra_edge_filter_type);
-      if (need_above && upsample_above) {
-        const int n_px = txwpx + (need_right ? txhpx : 0);
-        av1_upsample_intra_edge(above_row, n_px);
-      }
-      upsample_left = av1_use_intra_edge_upsample(txhpx, txwpx, p_angle - 180,
-                                                  intra_edge_filter_type);
-      if (need_left && upsample_left) {
-        const int n_px = txhpx + (need_bottom ? txwpx : 0);
-        av1_upsample_intra_edge(left_col, n_px);
-      }
-    }
+    int upsample_above, upsample_left;
+    filter_dr_edges(above_row, left_col, tx_size, p_angle, disable_edge_filter,
+                    n_top_px, n_left_px, intra_edge_filter_type,
+                    &upsample_above, &upsample_left);
     dr_predictor(dst, dst_stride, tx_size, above_row, left_col, upsample_above,
                  upsample_left, p_angle);
     return;
@@ -1553,44 +1603,19 @@ static INLINE BLOCK_SIZE scale_chroma_bsize(BLOCK_SIZE bsize, int subsampling_x,
   return bs;
 }
 
-void av1_predict_intra_block(const MACROBLOCKD *xd, BLOCK_SIZE sb_size,
-                             int enable_intra_edge_filter, int wpx, int hpx,
-                             TX_SIZE tx_size, PREDICTION_MODE mode,
-                             int angle_delta, int use_palette,
-                             FILTER_INTRA_MODE filter_intra_mode,
-                             const uint8_t *ref, int ref_stride, uint8_t *dst,
-                             int dst_stride, int col_off, int row_off,
-                             int plane) {
+// Returns the number of available neighboring pixels of a transform block, in
+// the way build_intra_predictors() takes them.
+static void get_intra_neighbor_px_counts(const MACROBLOCKD *xd,
+                                         BLOCK_SIZE sb_size, int wpx, int hpx,
+                                         TX_SIZE tx_size, int col_off,
+                                         int row_off, int plane, int *n_top_px,
+                                         int *n_topright_px, int *n_left_px,
+                                         int *n_bottomleft_px) {
   const MB_MODE_INFO *const mbmi = xd->mi[0];
   const int txwpx = tx_size_wide[tx_size];
   const int txhpx = tx_size_high[tx_size];
   const int x = col_off << MI_SIZE_LOG2;
   const int y = row_off << MI_SIZE_LOG2;
-
-  if (use_palette) {
-    int r, c;
-    const uint8_t *const map = xd->plane[plane != 0].color_index_map +
-                               xd->color_index_map_offset[plane != 0];
-    const uint16_t *const palette =
-        mbmi->palette_mode_info.palette_colors + plane * PALETTE_MAX_SIZE;
-    if (is_cur_buf_hbd(xd)) {
-      uint16_t *dst16 = CONVERT_TO_SHORTPTR(dst);
-      for (r = 0; r < txhpx; ++r) {
-        for (c = 0; c < txwpx; ++c) {
-          dst16[r * dst_stride + c] = palette[map[(r + y) * wpx + c + x]];
-        }
-      }
-    } else {
-      for (r = 0; r < txhpx; ++r) {
-        for (c = 0; c < txwpx; ++c) {
-          dst[r * dst_stride + c] =
-              (uint8_t)palette[map[(r + y) * wpx + c + x]];
-        }
-      }
-    }
-    return;
-  }
-
   const struct macroblockd_plane *const pd = &xd->plane[plane];
   const int txw = tx_size_wide_unit[tx_size];
   const int txh = tx_size_high_unit[tx_size];
@@ -1629,26 +1654,185 @@ void av1_predict_intra_block(const MACROBLOCKD *xd, BLOCK_SIZE sb_size,
       sb_size, bsize, mi_row, mi_col, bottom_available, have_left, partition,
       tx_size, row_off, col_off, ss_x, ss_y);
 
+  *n_top_px = have_top ? AOMMIN(txwpx, xr + txwpx) : 0;
+  *n_topright_px = have_top_right ? AOMMIN(txwpx, xr) : 0;
+  *n_left_px = have_left ? AOMMIN(txhpx, yd + txhpx) : 0;
+  *n_bottomleft_px = have_bottom_left ? AOMMIN(txhpx, yd) : 0;
+}
+
+void av1_predict_intra_block(const MACROBLOCKD *xd, BLOCK_SIZE sb_size,
+                             int enable_intra_edge_filter, int wpx, int hpx,
+                             TX_SIZE tx_size, PREDICTION_MODE mode,
+                             int angle_delta, int use_palette,
+                             FILTER_INTRA_MODE filter_intra_mode,
+                             const uint8_t *ref, int ref_stride, uint8_t *dst,
+                             int dst_stride, int col_off, int row_off,
+                             int plane) {
+  const MB_MODE_INFO *const mbmi = xd->mi[0];
+  const int txwpx = tx_size_wide[tx_size];
+  const int txhpx = tx_size_high[tx_size];
+  const int x = col_off << MI_SIZE_LOG2;
+  const int y = row_off << MI_SIZE_LOG2;
+
+  if (use_palette) {
+    int r, c;
+    const uint8_t *const map = xd->plane[plane != 0].color_index_map +
+                               xd->color_index_map_offset[plane != 0];
+    const uint16_t *const palette =
+        mbmi->palette_mode_info.palette_colors + plane * PALETTE_MAX_SIZE;
+    if (is_cur_buf_hbd(xd)) {
+      uint16_t *dst16 = CONVERT_TO_SHORTPTR(dst);
+      for (r = 0; r < txhpx; ++r) {
+        for (c = 0; c < txwpx; ++c) {
+          dst16[r * dst_stride + c] = palette[map[(r + y) * wpx + c + x]];
+        }
+      }
+    } else {
+      for (r = 0; r < txhpx; ++r) {
+        for (c = 0; c < txwpx; ++c) {
+          dst[r * dst_stride + c] =
+              (uint8_t)palette[map[(r + y) * wpx + c + x]];
+        }
+      }
+    }
+    return;
+  }
+
+  int n_top_px, n_topright_px, n_left_px, n_bottomleft_px;
+  get_intra_neighbor_px_counts(xd, sb_size, wpx, hpx, tx_size, col_off,
+                               row_off, plane, &n_top_px, &n_topright_px,
+                               &n_left_px, &n_bottomleft_px);
   const int disable_edge_filter = !enable_intra_edge_filter;
   const int intra_edge_filter_type = get_intra_edge_filter_type(xd, plane);
 #if CONFIG_AV1_HIGHBITDEPTH
   if (is_cur_buf_hbd(xd)) {
     build_intra_predictors_high(
         ref, ref_stride, dst, dst_stride, mode, angle_delta, filter_intra_mode,
-        tx_size, disable_edge_filter, have_top ? AOMMIN(txwpx, xr + txwpx) : 0,
-        have_top_right ? AOMMIN(txwpx, xr) : 0,
-        have_left ? AOMMIN(txhpx, yd + txhpx) : 0,
-        have_bottom_left ? AOMMIN(txhpx, yd) : 0, intra_edge_filter_type,
-        xd->bd);
+        tx_size, disable_edge_filter, n_top_px, n_topright_px, n_left_px,
+        n_bottomleft_px, intra_edge_filter_type, xd->bd);
     return;
   }
 #endif
-  build_intra_predictors(
-      ref, ref_stride, dst, dst_stride, mode, angle_delta, filter_intra_mode,
-      tx_size, disable_edge_filter, have_top ? AOMMIN(txwpx, xr + txwpx) : 0,
-      have_top_right ? AOMMIN(txwpx, xr) : 0,
-      have_left ? AOMMIN(txhpx, yd + txhpx) : 0,
-      have_bottom_left ? AOMMIN(txhpx, yd) : 0, intra_edge_filter_type);
+  build_intra_predictors(ref, ref_stride, dst, dst_stride, mode, angle_delta,
+                         filter_intra_mode, tx_size, disable_edge_filter,
+                         n_top_px, n_topright_px, n_left_px, n_bottomleft_px,
+                         intra_edge_filter_type);
+}
+
+void av1_prepare_intra_dr_edges(const MACROBLOCKD *xd, BLOCK_SIZE sb_size,
+                                int enable_intra_edge_filter, int wpx, int hpx,
+                                TX_SIZE tx_size, const uint8_t *ref,
+                                int ref_stride, int col_off, int row_off,
+                                int plane, IntraDrEdges *edges) {
+  assert(!is_cur_buf_hbd(xd));
+  const int txwpx = tx_size_wide[tx_size];
+  const int txhpx = tx_size_high[tx_size];
+  int n_top_px, n_topright_px, n_left_px, n_bottomleft_px;
+  get_intra_neighbor_px_counts(xd, sb_size, wpx, hpx, tx_size, col_off,
+                               row_off, plane, &n_top_px, &n_topright_px,
+                               &n_left_px, &n_bottomleft_px);
+  edges->tx_size = tx_size;
+  edges->n_top_px = n_top_px;
+  edges->n_left_px = n_left_px;
+  edges->disable_edge_filter = !enable_intra_edge_filter;
+  edges->intra_edge_filter_type = get_intra_edge_filter_type(xd, plane);
+  edges->filter_key = -1;
+
+  // Gathers the pixels the same way as build_intra_predictors() does, for the
+  // union of the needs of all the prediction angles.
+  const uint8_t *above_ref = ref - ref_stride;
+  const uint8_t *left_ref = ref - 1;
+  uint8_t *const above_row = edges->above_data + 16;
+  uint8_t *const left_col = edges->left_data + 16;
+  memset(edges->left_data, 129, NUM_INTRA_NEIGHBOUR_PIXELS);
+  memset(edges->above_data, 127, NUM_INTRA_NEIGHBOUR_PIXELS);
+
+  const int num_left_pixels_needed = txhpx + txwpx;
+  int i = 0;
+  if (n_left_px > 0) {
+    for (; i < n_left_px; i++) left_col[i] = left_ref[i * ref_stride];
+    if (n_bottomleft_px > 0) {
+      assert(i == txhpx);
+      for (; i < txhpx + n_bottomleft_px; i++)
+        left_col[i] = left_ref[i * ref_stride];
+    }
+    if (i < num_left_pixels_needed)
+      memset(&left_col[i], left_col[i - 1], num_left_pixels_needed - i);
+  } else if (n_top_px > 0) {
+    memset(left_col, above_ref[0], num_left_pixels_needed);
+  }
+
+  const int num_top_pixels_needed = txwpx + txhpx;
+  if (n_top_px > 0) {
+    memcpy(above_row, above_ref, n_top_px);
+    i = n_top_px;
+    if (n_topright_px > 0) {
+      assert(n_top_px == txwpx);
+      memcpy(above_row + txwpx, above_ref + txwpx, n_topright_px);
+      i += n_topright_px;
+    }
+    if (i < num_top_pixels_needed)
+      memset(&above_row[i], above_row[i - 1], num_top_pixels_needed - i);
+  } else if (n_left_px > 0) {
+    memset(above_row, left_ref[0], num_top_pixels_needed);
+  }
+
+  if (n_top_px > 0 && n_left_px > 0) {
+    above_row[-1] = above_ref[-1];
+  } else if (n_top_px > 0) {
+    above_row[-1] = above_ref[0];
+  } else if (n_left_px > 0) {
+    above_row[-1] = left_ref[0];
+  } else {
+    above_row[-1] = 128;
+  }
+  left_col[-1] = above_row[-1];
+}
+
+void av1_predict_intra_dr_from_edges(IntraDrEdges *edges, int p_angle,
+                                     uint8_t *dst, int dst_stride) {
+  const TX_SIZE tx_size = edges->tx_size;
+  const int txwpx = tx_size_wide[tx_size];
+  const int txhpx = tx_size_high[tx_size];
+  const uint8_t *const above_ref = edges->above_data + 16;
+  const uint8_t *const left_ref = edges->left_data + 16;
+  assert(p_angle > 0 && p_angle < 270);
+
+  if ((p_angle >= 180 && edges->n_left_px == 0) ||
+      (p_angle <= 90 && edges->n_top_px == 0)) {
+    int val;
+    if (p_angle > 90) {
+      val = (edges->n_top_px > 0) ? above_ref[0] : 129;
+    } else {
+      val = (edges->n_left_px > 0) ? left_ref[0] : 127;
+    }
+    for (int i = 0; i < txhpx; ++i) {
+      memset(dst, val, txwpx);
+      dst += dst_stride;
+    }
+    return;
+  }
+
+  // The edges are filtered on a copy of the gathered pixels, which is kept for
+  // the next angles needing the same filtering.
+  const int filter_key =
+      get_dr_edge_filter_key(tx_size, p_angle, edges->disable_edge_filter,
+                             edges->intra_edge_filter_type);
+  if (filter_key != edges->filter_key) {
+    memcpy(edges->filtered_left_data, edges->left_data,
+           sizeof(edges->left_data));
+    memcpy(edges->filtered_above_data, edges->above_data,
+           sizeof(edges->above_data));
+    filter_dr_edges(edges->filtered_above_data + 16,
+                    edges->filtered_left_data + 16, tx_size, p_angle,
+                    edges->disable_edge_filter, edges->n_top_px,
+                    edges->n_left_px, edges->intra_edge_filter_type,
+                    &edges->upsample_above, &edges->upsample_left);
+    edges->filter_key = filter_key;
+  }
+  dr_predictor(dst, dst_stride, tx_size, edges->filtered_above_data + 16,
+               edges->filtered_left_data + 16, edges->upsample_above,
+               edges->upsample_left, p_angle);
 }
 
 void av1_predict_intra_block_facade(const AV1_COMMON *cm, MACROBLOCKD *xd,
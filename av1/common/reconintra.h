@@ -35,6 +35,42 @@ void av1_predict_intra_block(const MACROBLOCKD *xd, BLOCK_SIZE sb_size,
                              int dst_stride, int col_off, int row_off,
                              int plane);
 
+#define NUM_INTRA_NEIGHBOUR_PIXELS (MAX_TX_SIZE * 2 + 32)
+
+// Neighboring pixels of a transform block, gathered once to build its
+// directional predictions for all the prediction angles.
+typedef struct {
+  DECLARE_ALIGNED(16, uint8_t, above_data[NUM_INTRA_NEIGHBOUR_PIXELS]);
+  DECLARE_ALIGNED(16, uint8_t, left_data[NUM_INTRA_NEIGHBOUR_PIXELS]);
+  TX_SIZE tx_size;
+  int n_top_px;
+  int n_left_px;
+  int disable_edge_filter;
+  int intra_edge_filter_type;
+  // Edges filtered for the last predicted angle, and the key of their
+  // filtering.
+  DECLARE_ALIGNED(16, uint8_t, filtered_above_data[NUM_INTRA_NEIGHBOUR_PIXELS]);
+  DECLARE_ALIGNED(16, uint8_t, filtered_left_data[NUM_INTRA_NEIGHBOUR_PIXELS]);
+  int filter_key;
+  int upsample_above;
+  int upsample_left;
+} IntraDrEdges;
+
+// Gathers the neighboring pixels of a low bit depth transform block. The
+// arguments are the same as for av1_predict_intra_block().
+void av1_prepare_intra_dr_edges(const MACROBLOCKD *xd, BLOCK_SIZE sb_size,
+                                int enable_intra_edge_filter, int wpx, int hpx,
+                                TX_SIZE tx_size, const uint8_t *ref,
+                                int ref_stride, int col_off, int row_off,
+                                int plane, IntraDrEdges *edges);
+
+// Builds the directional prediction of the given angle from the gathered
+// neighboring pixels. The output is the same as av1_predict_intra_block() for
+// the directional mode and angle delta that give p_angle. The filtered edges
+// are reused by the consecutive angles that filter them the same way.
+void av1_predict_intra_dr_from_edges(IntraDrEdges *edges, int p_angle,
+                                     uint8_t *dst, int dst_stride);
+
 // Mapping of interintra to intra mode for use in the intra component
 static const PREDICTION_MODE interintra_to_intra_mode[INTERINTRA_MODES] = {
   DC_PRED, V_PRED, H_PRED, SMOOTH_PRED
@@ -454,6 +454,29 @@ static void loop_filter_rows(YV12_BUFFER_CONFIG *frame, AV1_COMMON *cm,
   }
 }
 
+// Sets for each luma and chroma plane whether to filter it or not. Returns 0
+// if no plane is filtered.
+static int get_planes_to_lf(const AV1_COMMON *cm, int plane_start,
+                            int plane_end, int planes_to_lf[3]) {
+  planes_to_lf[0] = (cm->lf.filter_level[0] || cm->lf.filter_level[1]) &&
+                    plane_start <= 0 && 0 < plane_end;
+  planes_to_lf[1] = cm->lf.filter_level_u && plane_start <= 1 && 1 < plane_end;
+  planes_to_lf[2] = cm->lf.filter_level_v && plane_start <= 2 && 2 < plane_end;
+  // If the luma plane is purposely not filtered, neither are the chroma planes.
+  if (!planes_to_lf[0] && plane_start <= 0 && 0 < plane_end) return 0;
+  return planes_to_lf[0] || planes_to_lf[1] || planes_to_lf[2];
+}
+
+void av1_loop_filter_frame_rows(YV12_BUFFER_CONFIG *frame, AV1_COMMON *cm,
+                                MACROBLOCKD *xd, int plane_start,
+                                int plane_end, int start_mi_row,
+                                int end_mi_row, int is_realtime) {
+  int planes_to_lf[3];
+  if (!get_planes_to_lf(cm, plane_start, plane_end, planes_to_lf)) return;
+  loop_filter_rows(frame, cm, xd, start_mi_row, end_mi_row, planes_to_lf,
+                   is_realtime);
+}
+
 void av1_loop_filter_frame_mt(YV12_BUFFER_CONFIG *frame, AV1_COMMON *cm,
                               MACROBLOCKD *xd, int plane_start, int plane_end,
                               int partial_frame, AVxWorker *workers,
@@ -462,15 +485,7 @@ void av1_loop_filter_frame_mt(YV12_BUFFER_CONFIG *frame, AV1_COMMON *cm,
   int start_mi_row, end_mi_row, mi_rows_to_filter;
   int planes_to_lf[3];
 
-  // For each luma and chroma plane, whether to filter it or not.
-  planes_to_lf[0] = (cm->lf.filter_level[0] || cm->lf.filter_level[1]) &&
-                    plane_start <= 0 && 0 < plane_end;
-  planes_to_lf[1] = cm->lf.filter_level_u && plane_start <= 1 && 1 < plane_end;
-  planes_to_lf[2] = cm->lf.filter_level_v && plane_start <= 2 && 2 < plane_end;
-  // If the luma plane is purposely not filtered, neither are the chroma planes.
-  if (!planes_to_lf[0] && plane_start <= 0 && 0 < plane_end) return;
-  // Early exit.
-  if (!planes_to_lf[0] && !planes_to_lf[1] && !planes_to_lf[2]) return;
+  if (!get_planes_to_lf(cm, plane_start, plane_end, planes_to_lf)) return;
 
   start_mi_row = 0;
   mi_rows_to_filter = cm->mi_params.mi_rows;
@@ -159,6 +159,15 @@ void av1_loop_filter_frame_mt(YV12_BUFFER_CONFIG *frame, struct AV1Common *cm,
                               AVxWorker *workers, int num_workers,
                               AV1LfSync *lf_sync, int is_realtime);
 
+// Filters the superblock rows [start_mi_row, end_mi_row) of the frame in the
+// calling thread. The superblock rows above must have been filtered, and
+// av1_loop_filter_frame_init() must have been called for the frame.
+void av1_loop_filter_frame_rows(YV12_BUFFER_CONFIG *frame,
+                                struct AV1Common *cm, struct macroblockd *xd,
+                                int plane_start, int plane_end,
+                                int start_mi_row, int end_mi_row,
+                                int is_realtime);
+
 #if !CONFIG_REALTIME_ONLY
 void av1_loop_restoration_filter_frame_mt(YV12_BUFFER_CONFIG *frame,
                                           struct AV1Common *cm,
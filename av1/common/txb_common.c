@@ -8,6 +8,8 @@
  * Media Patent License 1.0 was not distributed with this source code in the
  * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
  */
+#include "config/av1_rtcd.h"
+
 #include "aom/aom_integer.h"
 #include "av1/common/av1_common_int.h"
 #include "av1/common/txb_common.h"
@@ -456,3 +458,15 @@ const int8_t *av1_nz_map_ctx_offset[19] = {
 const int16_t av1_eob_group_start[12] = { 0,  1,  2,  3,   5,   9,
                                           17, 33, 65, 129, 257, 513 };
 const int16_t av1_eob_offset_bits[12] = { 0, 0, 0, 1, 2, 3, 4, 5, 6, 7, 8, 9 };
+
+void av1_get_coeff_ctxs_2d_diag_c(const uint8_t *levels, int bwl,
+                                  TX_SIZE tx_size, int diag, int row_start,
+                                  int num, int8_t *nz_ctx, int8_t *br_ctx) {
+  assert(diag > 0);
+  for (int i = 0; i < num; ++i) {
+    const int row = row_start + i;
+    const int pos = (row << bwl) + diag - row;
+    nz_ctx[i] = get_lower_levels_ctx_2d(levels, pos, bwl, tx_size);
+    br_ctx[i] = get_br_ctx_2d(levels, pos, bwl);
+  }
+}
@@ -0,0 +1,113 @@
+/*
+ * Copyright (c) 2022, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#include <assert.h>
+#include <immintrin.h> /* AVX2 */
+
+#include "config/av1_rtcd.h"
+
+#include "aom/aom_integer.h"
+#include "av1/common/av1_common_int.h"
+#include "av1/common/txb_common.h"
+
+// Computes the nz-map and base-range contexts of 'num' coefficients on
+// anti-diagonal 'diag' of a TX_CLASS_2D transform block, starting at row
+// 'row_start'. Consecutive rows of a diagonal are stride - 1 bytes apart in
+// 'levels', so eight coefficients are processed per iteration with gathers.
+// The nz-map context offset is derived from the row and column, which matches
+// av1_nz_map_ctx_offset[] for all transform sizes.
+void av1_get_coeff_ctxs_2d_diag_avx2(const uint8_t *levels, int bwl,
+                                     TX_SIZE tx_size, int diag, int row_start,
+                                     int num, int8_t *nz_ctx,
+                                     int8_t *br_ctx) {
+  assert(diag > 0);
+  const int stride = (1 << bwl) + TX_PAD_HOR;
+  const int width = tx_size_wide[tx_size];
+  const int height = tx_size_high[tx_size];
+  const uint8_t *const base = levels + row_start * stride + diag - row_start;
+  const __m256i lane = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+  const __m256i step = _mm256_set1_epi32(stride - 1);
+  const __m256i mask8 = _mm256_set1_epi32(0xff);
+  const __m256i mask16 = _mm256_set1_epi32(0xffff);
+  const __m256i max3 = _mm256_set1_epi8(3);
+  const __m256i max_br = _mm256_set1_epi8(MAX_BASE_BR_RANGE);
+  const __m256i one = _mm256_set1_epi32(1);
+  const __m256i two = _mm256_set1_epi32(2);
+  const __m256i nz_max = _mm256_set1_epi32(4);
+  const __m256i br_max = _mm256_set1_epi32(6);
+  const __m256i diag_v = _mm256_set1_epi32(diag);
+  const __m256i nz_off_diag =
+      _mm256_set1_epi32(diag < 2 ? 1 : (diag < 4 ? 6 : 21));
+  const __m256i nz_off_rect = _mm256_set1_epi32(width < height ? 11 : 16);
+  const __m256i br_off_near = _mm256_set1_epi32(7);
+  const __m256i br_off_far = _mm256_set1_epi32(14);
+
+  int i = 0;
+  for (; i + 8 <= num; i += 8) {
+    const __m256i k = _mm256_add_epi32(lane, _mm256_set1_epi32(i));
+    const __m256i offs = _mm256_mullo_epi32(k, step);
+    // { 0, 1 } { 0, 2 }
+    const __m256i r0 =
+        _mm256_i32gather_epi32((const int *)(base + 1), offs, 1);
+    // { 1, 0 } { 1, 1 }
+    const __m256i r1 =
+        _mm256_i32gather_epi32((const int *)(base + stride), offs, 1);
+    // { 2, 0 }
+    const __m256i r2 =
+        _mm256_i32gather_epi32((const int *)(base + 2 * stride), offs, 1);
+
+    __m256i nz_sum = _mm256_min_epu8(_mm256_and_si256(r0, mask16), max3);
+    nz_sum = _mm256_add_epi8(
+        nz_sum, _mm256_min_epu8(_mm256_and_si256(r1, mask16), max3));
+    nz_sum = _mm256_add_epi8(
+        nz_sum, _mm256_min_epu8(_mm256_and_si256(r2, mask8), max3));
+    __m256i nz_mag = _mm256_add_epi32(_mm256_and_si256(nz_sum, mask8),
+                                      _mm256_srli_epi32(nz_sum, 8));
+    nz_mag = _mm256_min_epi32(
+        _mm256_srli_epi32(_mm256_add_epi32(nz_mag, one), 1), nz_max);
+
+    __m256i br_sum = _mm256_min_epu8(_mm256_and_si256(r0, mask8), max_br);
+    br_sum = _mm256_add_epi8(
+        br_sum, _mm256_min_epu8(_mm256_and_si256(r1, mask16), max_br));
+    __m256i br_mag = _mm256_add_epi32(_mm256_and_si256(br_sum, mask8),
+                                      _mm256_srli_epi32(br_sum, 8));
+    br_mag = _mm256_min_epi32(
+        _mm256_srli_epi32(_mm256_add_epi32(br_mag, one), 1), br_max);
+
+    const __m256i row = _mm256_add_epi32(k, _mm256_set1_epi32(row_start));
+    const __m256i col = _mm256_sub_epi32(diag_v, row);
+    const __m256i row_lt2 = _mm256_cmpgt_epi32(two, row);
+    const __m256i col_lt2 = _mm256_cmpgt_epi32(two, col);
+    __m256i nz_off = nz_off_diag;
+    if (width < height) {
+      nz_off = _mm256_blendv_epi8(nz_off, nz_off_rect, row_lt2);
+    } else if (width > height) {
+      nz_off = _mm256_blendv_epi8(nz_off, nz_off_rect, col_lt2);
+    }
+    const __m256i br_off = _mm256_blendv_epi8(
+        br_off_far, br_off_near, _mm256_and_si256(row_lt2, col_lt2));
+
+    const __m256i nz = _mm256_add_epi32(nz_mag, nz_off);
+    const __m256i br = _mm256_add_epi32(br_mag, br_off);
+    // [ nz0..3 br0..3 | nz4..7 br4..7 ] -> [ nz0..7 | br0..7 ]
+    const __m256i nz_br = _mm256_permute4x64_epi64(
+        _mm256_packs_epi32(nz, br), _MM_SHUFFLE(3, 1, 2, 0));
+    const __m256i packed = _mm256_packs_epi16(nz_br, nz_br);
+    _mm_storel_epi64((__m128i *)(nz_ctx + i), _mm256_castsi256_si128(packed));
+    _mm_storel_epi64((__m128i *)(br_ctx + i),
+                     _mm256_extracti128_si256(packed, 1));
+  }
+
+  if (i < num) {
+    av1_get_coeff_ctxs_2d_diag_c(levels, bwl, tx_size, diag, row_start + i,
+                                 num - i, nz_ctx + i, br_ctx + i);
+  }
+}
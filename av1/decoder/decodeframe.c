@@ -2661,6 +2661,7 @@ static AOM_INLINE void decode_tile(AV1Decoder *pbi, ThreadData *const td,
   av1_tile_set_col(&tile_info, cm, tile_col);
   DecoderCodingBlock *const dcb = &td->dcb;
   MACROBLOCKD *const xd = &dcb->xd;
+  const int profile = pbi->profiling && !cm->tiles.large_scale;
 
   av1_zero_above_context(cm, xd, tile_info.mi_col_start, tile_info.mi_col_end,
                          tile_row);
@@ -2675,9 +2676,30 @@ static AOM_INLINE void decode_tile(AV1Decoder *pbi, ThreadData *const td,
          mi_col += cm->seq_params->mib_size) {
       set_cb_buffer(pbi, dcb, &td->cb_buffer_base, num_planes, 0, 0);
 
-      // Bit-stream parsing and decoding of the superblock
-      decode_partition(pbi, td, mi_row, mi_col, td->bit_reader,
-                       cm->seq_params->sb_size, 0x3);
+      if (profile) {
+        // Parse and reconstruct the superblock in two passes, as row-mt
+        // decoding does, so that each stage can be timed on its own.
+        struct aom_usec_timer timer;
+        set_decode_func_pointers(td, 0x1);
+        aom_usec_timer_start(&timer);
+        decode_partition(pbi, td, mi_row, mi_col, td->bit_reader,
+                         cm->seq_params->sb_size, 0x1);
+        aom_usec_timer_mark(&timer);
+        td->entropy_time += aom_usec_timer_elapsed(&timer);
+
+        set_cb_buffer(pbi, dcb, &td->cb_buffer_base, num_planes, 0, 0);
+        set_decode_func_pointers(td, 0x2);
+        aom_usec_timer_start(&timer);
+        decode_partition(pbi, td, mi_row, mi_col, td->bit_reader,
+                         cm->seq_params->sb_size, 0x2);
+        aom_usec_timer_mark(&timer);
+        td->recon_time += aom_usec_timer_elapsed(&timer);
+        set_decode_func_pointers(td, 0x3);
+      } else {
+        // Bit-stream parsing and decoding of the superblock
+        decode_partition(pbi, td, mi_row, mi_col, td->bit_reader,
+                         cm->seq_params->sb_size, 0x3);
+      }
 
       if (aom_reader_has_overflowed(td->bit_reader)) {
         aom_merge_corrupted_flag(&dcb->corrupted, 1);
@@ -3182,7 +3204,15 @@ static int row_mt_worker_hook(void *arg1, void *arg2) {
       pthread_mutex_unlock(pbi->row_mt_mutex_);
 #endif
       // decode tile
-      parse_tile_row_mt(pbi, td, tile_data);
+      if (pbi->profiling) {
+        struct aom_usec_timer timer;
+        aom_usec_timer_start(&timer);
+        parse_tile_row_mt(pbi, td, tile_data);
+        aom_usec_timer_mark(&timer);
+        td->entropy_time += aom_usec_timer_elapsed(&timer);
+      } else {
+        parse_tile_row_mt(pbi, td, tile_data);
+      }
 #if CONFIG_MULTITHREAD
       pthread_mutex_lock(pbi->row_mt_mutex_);
 #endif
@@ -3241,7 +3271,15 @@ static int row_mt_worker_hook(void *arg1, void *arg2) {
     av1_init_macroblockd(cm, &td->dcb.xd);
     td->dcb.xd.error_info = &thread_data->error_info;
 
-    decode_tile_sb_row(pbi, td, tile_info, mi_row);
+    if (pbi->profiling) {
+      struct aom_usec_timer timer;
+      aom_usec_timer_start(&timer);
+      decode_tile_sb_row(pbi, td, tile_info, mi_row);
+      aom_usec_timer_mark(&timer);
+      td->recon_time += aom_usec_timer_elapsed(&timer);
+    } else {
+      decode_tile_sb_row(pbi, td, tile_info, mi_row);
+    }
 
 #if CONFIG_MULTITHREAD
     pthread_mutex_lock(pbi->row_mt_mutex_);
@@ -5194,6 +5232,31 @@ static AOM_INLINE void setup_frame_info(AV1Decoder *pbi) {
   }
 }
 
+static AOM_INLINE void dec_profile_start(const AV1Decoder *pbi,
+                                         struct aom_usec_timer *timer) {
+  if (pbi->profiling) aom_usec_timer_start(timer);
+}
+
+static AOM_INLINE void dec_profile_stop(AV1Decoder *pbi,
+                                        struct aom_usec_timer *timer,
+                                        aom_dec_profile_stage_t stage) {
+  if (!pbi->profiling) return;
+  aom_usec_timer_mark(timer);
+  av1_dec_profile_add(pbi, stage, aom_usec_timer_elapsed(timer));
+}
+
+// Moves the entropy decoding and reconstruction times gathered by the tile
+// workers into the frame statistics.
+static AOM_INLINE void dec_profile_collect_tile_times(AV1Decoder *pbi) {
+  for (int i = 0; i < AOMMAX(pbi->num_workers, 1); ++i) {
+    ThreadData *const td = i == 0 ? &pbi->td : pbi->thread_data[i].td;
+    av1_dec_profile_add(pbi, AOM_DEC_PROFILE_ENTROPY, td->entropy_time);
+    av1_dec_profile_add(pbi, AOM_DEC_PROFILE_RECON, td->recon_time);
+    td->entropy_time = 0;
+    td->recon_time = 0;
+  }
+}
+
 void av1_decode_tg_tiles_and_wrapup(AV1Decoder *pbi, const uint8_t *data,
                                     const uint8_t *data_end,
                                     const uint8_t **p_data_end, int start_tile,
@@ -5202,6 +5265,7 @@ void av1_decode_tg_tiles_and_wrapup(AV1Decoder *pbi, const uint8_t *data,
   CommonTileParams *const tiles = &cm->tiles;
   MACROBLOCKD *const xd = &pbi->dcb.xd;
   const int tile_count_tg = end_tile - start_tile + 1;
+  struct aom_usec_timer timer;
 
   if (initialize_flag) setup_frame_info(pbi);
   const int num_planes = av1_num_planes(cm);
@@ -5216,6 +5280,8 @@ void av1_decode_tg_tiles_and_wrapup(AV1Decoder *pbi, const uint8_t *data,
   else
     *p_data_end = decode_tiles(pbi, data, data_end, start_tile, end_tile);
 
+  if (pbi->profiling) dec_profile_collect_tile_times(pbi);
+
   // If the bit stream is monochrome, set the U and V buffers to a constant.
   if (num_planes < 3) {
     set_planes_to_neutral_grey(cm->seq_params, xd->cur_buf, 1);
@@ -5231,9 +5297,11 @@ void av1_decode_tg_tiles_and_wrapup(AV1Decoder *pbi, const uint8_t *data,
 
   if (!cm->features.allow_intrabc && !tiles->single_tile_decoding) {
     if (cm->lf.filter_level[0] || cm->lf.filter_level[1]) {
+      dec_profile_start(pbi, &timer);
       av1_loop_filter_frame_mt(&cm->cur_frame->buf, cm, &pbi->dcb.xd, 0,
                                num_planes, 0, pbi->tile_workers,
                                pbi->num_workers, &pbi->lf_row_sync, 0);
+      dec_profile_stop(pbi, &timer, AOM_DEC_PROFILE_LOOP_FILTER);
     }
 
     const int do_cdef =
@@ -5249,11 +5317,15 @@ void av1_decode_tg_tiles_and_wrapup(AV1Decoder *pbi, const uint8_t *data,
         cm->rst_info[1].frame_restoration_type != RESTORE_NONE ||
         cm->rst_info[2].frame_restoration_type != RESTORE_NONE;
     if (!optimized_loop_restoration) {
-      if (do_loop_restoration)
+      if (do_loop_restoration) {
+        dec_profile_start(pbi, &timer);
         av1_loop_restoration_save_boundary_lines(&pbi->common.cur_frame->buf,
                                                  cm, 0);
+        dec_profile_stop(pbi, &timer, AOM_DEC_PROFILE_LOOP_RESTORATION);
+      }
 
       if (do_cdef) {
+        dec_profile_start(pbi, &timer);
         if (pbi->num_workers > 1) {
           av1_cdef_frame_mt(cm, &pbi->dcb.xd, pbi->cdef_worker,
                             pbi->tile_workers, &pbi->cdef_sync,
@@ -5262,11 +5334,15 @@ void av1_decode_tg_tiles_and_wrapup(AV1Decoder *pbi, const uint8_t *data,
           av1_cdef_frame(&pbi->common.cur_frame->buf, cm, &pbi->dcb.xd,
                          av1_cdef_init_fb_row);
         }
+        dec_profile_stop(pbi, &timer, AOM_DEC_PROFILE_CDEF);
       }
 
+      dec_profile_start(pbi, &timer);
       superres_post_decode(pbi);
+      dec_profile_stop(pbi, &timer, AOM_DEC_PROFILE_SUPERRES);
 
       if (do_loop_restoration) {
+        dec_profile_start(pbi, &timer);
         av1_loop_restoration_save_boundary_lines(&pbi->common.cur_frame->buf,
                                                  cm, 1);
         if (pbi->num_workers > 1) {
@@ -5279,11 +5355,13 @@ void av1_decode_tg_tiles_and_wrapup(AV1Decoder *pbi, const uint8_t *data,
                                             cm, optimized_loop_restoration,
                                             &pbi->lr_ctxt);
         }
+        dec_profile_stop(pbi, &timer, AOM_DEC_PROFILE_LOOP_RESTORATION);
       }
     } else {
       // In no cdef and no superres case. Provide an optimized version of
       // loop_restoration_filter.
       if (do_loop_restoration) {
+        dec_profile_start(pbi, &timer);
         if (pbi->num_workers > 1) {
           av1_loop_restoration_filter_frame_mt(
               (YV12_BUFFER_CONFIG *)xd->cur_buf, cm, optimized_loop_restoration,
@@ -5294,11 +5372,13 @@ void av1_decode_tg_tiles_and_wrapup(AV1Decoder *pbi, const uint8_t *data,
                                             cm, optimized_loop_restoration,
                                             &pbi->lr_ctxt);
         }
+        dec_profile_stop(pbi, &timer, AOM_DEC_PROFILE_LOOP_RESTORATION);
       }
     }
 #else
     if (!optimized_loop_restoration) {
       if (do_cdef) {
+        dec_profile_start(pbi, &timer);
         if (pbi->num_workers > 1) {
           av1_cdef_frame_mt(cm, &pbi->dcb.xd, pbi->cdef_worker,
                             pbi->tile_workers, &pbi->cdef_sync,
@@ -5307,6 +5387,7 @@ void av1_decode_tg_tiles_and_wrapup(AV1Decoder *pbi, const uint8_t *data,
           av1_cdef_frame(&pbi->common.cur_frame->buf, cm, &pbi->dcb.xd,
                          av1_cdef_init_fb_row);
         }
+        dec_profile_stop(pbi, &timer, AOM_DEC_PROFILE_CDEF);
       }
     }
 #endif  // !CONFIG_REALTIME_ONLY
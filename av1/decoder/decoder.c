@@ -430,6 +430,11 @@ int av1_receive_compressed_data(AV1Decoder *pbi, size_t size,
   pbi->error.error_code = AOM_CODEC_OK;
   pbi->error.has_detail = 0;
 
+  if (pbi->profiling) {
+    av1_zero(pbi->profile_stats.last_frame_stage_time);
+    pbi->profile_stats.last_frame_bytes = 0;
+  }
+
   if (size == 0) {
     // This is used to signal that we are missing frames.
     // We do not know if the missing frame(s) was supposed to update
@@ -495,6 +500,12 @@ int av1_receive_compressed_data(AV1Decoder *pbi, size_t size,
 
   if (frame_decoded) {
     pbi->decoding_first_frame = 0;
+    if (pbi->profiling) {
+      aom_dec_profile_stats *const stats = &pbi->profile_stats;
+      stats->last_frame_bytes = (uint64_t)(*psource - source);
+      stats->frame_bytes += stats->last_frame_bytes;
+      ++stats->frame_count;
+    }
   }
 
   if (pbi->error.error_code != AOM_CODEC_OK) {
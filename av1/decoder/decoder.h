@@ -15,6 +15,7 @@
 #include "config/aom_config.h"
 
 #include "aom/aom_codec.h"
+#include "aom/aomdx.h"
 #include "aom_dsp/bitreader.h"
 #include "aom_scale/yv12config.h"
 #include "aom_util/aom_thread.h"
@@ -129,6 +130,11 @@ typedef struct ThreadData {
   decode_block_visitor_fn_t inverse_tx_inter_block_visit;
   predict_inter_block_visitor_fn_t predict_inter_block_visit;
   cfl_store_inter_block_visitor_fn_t cfl_store_inter_block_visit;
+
+  // Time in microseconds spent by this thread in entropy decoding and
+  // reconstruction of the current frame. Only updated when profiling.
+  int64_t entropy_time;
+  int64_t recon_time;
 } ThreadData;
 
 typedef struct AV1DecRowMTJobInfo {
@@ -360,6 +366,17 @@ typedef struct AV1Decoder {
    * Number of spatial layers: may be > 1 for SVC (scalable vector coding).
    */
   unsigned int number_spatial_layers;
+
+  /*!
+   * If true, the time spent in each decoding stage is accumulated in
+   * profile_stats.
+   */
+  int profiling;
+
+  /*!
+   * Per-stage decoding statistics, see AV1D_GET_PROFILE_STATS.
+   */
+  aom_dec_profile_stats profile_stats;
 } AV1Decoder;
 
 // Returns 0 on success. Sets pbi->common.error.error_code to a nonzero error
@@ -412,6 +429,13 @@ static INLINE void decrease_ref_count(RefCntBuffer *const buf,
   }
 }
 
+static INLINE void av1_dec_profile_add(AV1Decoder *pbi,
+                                       aom_dec_profile_stage_t stage,
+                                       int64_t time) {
+  pbi->profile_stats.stage_time[stage] += time;
+  pbi->profile_stats.last_frame_stage_time[stage] += time;
+}
+
 #define ACCT_STR __func__
 static INLINE int av1_read_uniform(aom_reader *r, int n) {
   const int l = get_unsigned_bits(n);
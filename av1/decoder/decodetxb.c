@@ -11,6 +11,8 @@
 
 #include "av1/decoder/decodetxb.h"
 
+#include "config/av1_rtcd.h"
+
 #include "aom_ports/mem.h"
 #include "av1/common/idct.h"
 #include "av1/common/scan.h"
@@ -59,20 +61,35 @@ static INLINE int get_dqv(const int16_t *dequant, int coeff_idx,
   return dqv;
 }
 
+// In the 2D scans every anti-diagonal is contiguous, and the contexts of a
+// coefficient only depend on levels of later diagonals. So the contexts of a
+// whole diagonal are derived in one call before its coefficients are read.
 static INLINE void read_coeffs_reverse_2d(aom_reader *r, TX_SIZE tx_size,
                                           int start_si, int end_si,
                                           const int16_t *scan, int bwl,
-                                          uint8_t *levels,
+                                          int height, uint8_t *levels,
                                           base_cdf_arr base_cdf,
                                           br_cdf_arr br_cdf) {
+  int8_t nz_ctx[32];
+  int8_t br_ctx[32];
+  int diag = -1;
+  int row_start = 0;
   for (int c = end_si; c >= start_si; --c) {
     const int pos = scan[c];
-    const int coeff_ctx = get_lower_levels_ctx_2d(levels, pos, bwl, tx_size);
+    const int row = pos >> bwl;
+    const int col = pos - (row << bwl);
+    if (row + col != diag) {
+      diag = row + col;
+      row_start = AOMMAX(0, diag - (1 << bwl) + 1);
+      const int row_end = AOMMIN(height - 1, diag);
+      av1_get_coeff_ctxs_2d_diag(levels, bwl, tx_size, diag, row_start,
+                                 row_end - row_start + 1, nz_ctx, br_ctx);
+    }
+    const int coeff_ctx = nz_ctx[row - row_start];
     const int nsymbs = 4;
     int level = aom_read_symbol(r, base_cdf[coeff_ctx], nsymbs, ACCT_STR);
     if (level > NUM_BASE_LEVELS) {
-      const int br_ctx = get_br_ctx_2d(levels, pos, bwl);
-      aom_cdf_prob *cdf = br_cdf[br_ctx];
+      aom_cdf_prob *cdf = br_cdf[br_ctx[row - row_start]];
       for (int idx = 0; idx < COEFF_BASE_RANGE; idx += BR_CDF_SIZE - 1) {
         const int k = aom_read_symbol(r, cdf, BR_CDF_SIZE, ACCT_STR);
         level += k;
@@ -267,8 +284,8 @@ uint8_t av1_read_coeffs_txb(const AV1_COMMON *const cm, DecoderCodingBlock *dcb,
     br_cdf_arr br_cdf =
         ec_ctx->coeff_br_cdf[AOMMIN(txs_ctx, TX_32X32)][plane_type];
     if (tx_class == TX_CLASS_2D) {
-      read_coeffs_reverse_2d(r, tx_size, 1, *eob - 1 - 1, scan, bwl, levels,
-                             base_cdf, br_cdf);
+      read_coeffs_reverse_2d(r, tx_size, 1, *eob - 1 - 1, scan, bwl, height,
+                             levels, base_cdf, br_cdf);
       read_coeffs_reverse(r, tx_size, tx_class, 0, 0, scan, bwl, levels,
                           base_cdf, br_cdf);
     } else {
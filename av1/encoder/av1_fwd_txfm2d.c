@@ -53,9 +53,11 @@ void av1_gen_fwd_stage_range(int8_t *stage_range_col, int8_t *stage_range_row,
   }
 }
 
-static INLINE void fwd_txfm2d_c(const int16_t *input, int32_t *output,
-                                const int stride, const TXFM_2D_FLIP_CFG *cfg,
-                                int32_t *buf, int bd) {
+// Vertical pass of the 2D transform. The output of the columns is stored in
+// buf in raster order, flipped from left to right if lr_flip is set.
+static INLINE void fwd_txfm2d_col_c(const int16_t *input, const int stride,
+                                    const TXFM_2D_FLIP_CFG *cfg, int lr_flip,
+                                    int32_t *temp, int32_t *buf, int bd) {
   int c, r;
   // Note when assigning txfm_size_col, we use the txfm_size from the
   // row configuration and vice versa. This is intentionally done to
@@ -67,7 +69,6 @@ static INLINE void fwd_txfm2d_c(const int16_t *input, int32_t *output,
   const int txfm_size_row = tx_size_high[cfg->tx_size];
   // Take the shift from the larger dimension in the rectangular case.
   const int8_t *shift = cfg->shift;
-  const int rect_type = get_rect_tx_log_ratio(txfm_size_col, txfm_size_row);
   int8_t stage_range_col[MAX_TXFM_STAGE_NUM];
   int8_t stage_range_row[MAX_TXFM_STAGE_NUM];
   assert(cfg->stage_num_col <= MAX_TXFM_STAGE_NUM);
@@ -75,15 +76,11 @@ static INLINE void fwd_txfm2d_c(const int16_t *input, int32_t *output,
   av1_gen_fwd_stage_range(stage_range_col, stage_range_row, cfg, bd);
 
   const int8_t cos_bit_col = cfg->cos_bit_col;
-  const int8_t cos_bit_row = cfg->cos_bit_row;
   const TxfmFunc txfm_func_col = fwd_txfm_type_to_func(cfg->txfm_type_col);
-  const TxfmFunc txfm_func_row = fwd_txfm_type_to_func(cfg->txfm_type_row);
 
-  // use output buffer as temp buffer
-  int32_t *temp_in = output;
-  int32_t *temp_out = output + txfm_size_row;
+  int32_t *temp_in = temp;
+  int32_t *temp_out = temp + txfm_size_row;
 
-  // Columns
   for (c = 0; c < txfm_size_col; ++c) {
     if (cfg->ud_flip == 0) {
       for (r = 0; r < txfm_size_row; ++r) temp_in[r] = input[r * stride + c];
@@ -95,7 +92,7 @@ static INLINE void fwd_txfm2d_c(const int16_t *input, int32_t *output,
     av1_round_shift_array(temp_in, txfm_size_row, -shift[0]);
     txfm_func_col(temp_in, temp_out, cos_bit_col, stage_range_col);
     av1_round_shift_array(temp_out, txfm_size_row, -shift[1]);
-    if (cfg->lr_flip == 0) {
+    if (lr_flip == 0) {
       for (r = 0; r < txfm_size_row; ++r)
         buf[r * txfm_size_col + c] = temp_out[r];
     } else {
@@ -104,11 +101,35 @@ static INLINE void fwd_txfm2d_c(const int16_t *input, int32_t *output,
         buf[r * txfm_size_col + (txfm_size_col - c - 1)] = temp_out[r];
     }
   }
+}
+
+// Horizontal pass of the 2D transform on the output of fwd_txfm2d_col_c().
+// The rows of buf are flipped from left to right first if lr_flip is set.
+static INLINE void fwd_txfm2d_row_c(const int32_t *buf, int32_t *output,
+                                    const TXFM_2D_FLIP_CFG *cfg, int lr_flip,
+                                    int bd) {
+  int c, r;
+  const int txfm_size_col = tx_size_wide[cfg->tx_size];
+  const int txfm_size_row = tx_size_high[cfg->tx_size];
+  const int8_t *shift = cfg->shift;
+  const int rect_type = get_rect_tx_log_ratio(txfm_size_col, txfm_size_row);
+  int8_t stage_range_col[MAX_TXFM_STAGE_NUM];
+  int8_t stage_range_row[MAX_TXFM_STAGE_NUM];
+  av1_gen_fwd_stage_range(stage_range_col, stage_range_row, cfg, bd);
+
+  const int8_t cos_bit_row = cfg->cos_bit_row;
+  const TxfmFunc txfm_func_row = fwd_txfm_type_to_func(cfg->txfm_type_row);
+  int32_t flipped_row[MAX_TX_SIZE];
 
-  // Rows
   for (r = 0; r < txfm_size_row; ++r) {
-    txfm_func_row(buf + r * txfm_size_col, output + r * txfm_size_col,
-                  cos_bit_row, stage_range_row);
+    const int32_t *row_in = buf + r * txfm_size_col;
+    if (lr_flip) {
+      for (c = 0; c < txfm_size_col; ++c)
+        flipped_row[c] = row_in[txfm_size_col - c - 1];
+      row_in = flipped_row;
+    }
+    txfm_func_row(row_in, output + r * txfm_size_col, cos_bit_row,
+                  stage_range_row);
     av1_round_shift_array(output + r * txfm_size_col, txfm_size_col, -shift[2]);
     if (abs(rect_type) == 1) {
       // Multiply everything by Sqrt2 if the transform is rectangular and the
@@ -121,6 +142,37 @@ static INLINE void fwd_txfm2d_c(const int16_t *input, int32_t *output,
   }
 }
 
+static INLINE void fwd_txfm2d_c(const int16_t *input, int32_t *output,
+                                const int stride, const TXFM_2D_FLIP_CFG *cfg,
+                                int32_t *buf, int bd) {
+  // use output buffer as temp buffer
+  fwd_txfm2d_col_c(input, stride, cfg, cfg->lr_flip, output, buf, bd);
+  fwd_txfm2d_row_c(buf, output, cfg, 0, bd);
+}
+
+void av1_fwd_txfm2d_tx_types(const int16_t *input, int32_t *output,
+                             int stride, TX_SIZE tx_size, uint16_t tx_mask,
+                             int bd) {
+  assert(tx_size_wide[tx_size] <= 32 && tx_size_high[tx_size] <= 32);
+  const int num_coeffs = tx_size_2d[tx_size];
+  // Output of the vertical pass for each kind of vertical 1D transform.
+  DECLARE_ALIGNED(32, int32_t, col_buf[TX_TYPES_1D][32 * 32]);
+  int32_t temp[2 * 32];
+  int col_done = 0;
+  for (int tx_type = 0; tx_type < TX_TYPES; ++tx_type) {
+    if (!(tx_mask & (1 << tx_type))) continue;
+    TXFM_2D_FLIP_CFG cfg;
+    av1_get_fwd_txfm_cfg((TX_TYPE)tx_type, tx_size, &cfg);
+    const int vtx = vtx_tab[tx_type];
+    if (!(col_done & (1 << vtx))) {
+      fwd_txfm2d_col_c(input, stride, &cfg, 0, temp, col_buf[vtx], bd);
+      col_done |= 1 << vtx;
+    }
+    fwd_txfm2d_row_c(col_buf[vtx], output + tx_type * num_coeffs, &cfg,
+                     cfg.lr_flip, bd);
+  }
+}
+
 void av1_fwd_txfm2d_4x8_c(const int16_t *input, int32_t *output, int stride,
                           TX_TYPE tx_type, int bd) {
   DECLARE_ALIGNED(32, int32_t, txfm_buf[4 * 8]);
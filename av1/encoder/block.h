@@ -75,6 +75,9 @@ typedef struct {
   //! TPL's stride for the arrays in this struct.
   int tpl_stride;
   /**@}*/
+
+  //! Partition map of the last frame if the superblock is static, else NULL.
+  const struct FramePartitionMap *ref_part_map;
 } SuperBlockEnc;
 
 /*! \brief Stores the best performing modes.
@@ -265,6 +268,54 @@ typedef struct {
   CRC32C crc_calculator;
 } MB_RD_RECORD;
 
+/*! \brief Result of the search of one transform type for a transform block.
+ */
+typedef struct {
+  //! Hash value of the residue.
+  uint32_t hash_value;
+  //! Generation of TXB_RD_RECORD the result was stored in.
+  uint32_t epoch;
+  //! Transform size and type, plane, contexts and quantizer of the search.
+  uint64_t search_ctx;
+  //! Rate-distortion multiplier of the search.
+  int rdmult;
+  //! Satd threshold of the coefficient optimization.
+  unsigned int coeff_opt_satd_threshold;
+  //! Rate of the quantized coefficients.
+  int rate;
+  //! Distortion.
+  int64_t dist;
+  //! Sum of squared residue.
+  int64_t sse;
+  //! End of block.
+  uint16_t eob;
+  //! Entropy context of the quantized coefficients.
+  uint8_t txb_entropy_ctx;
+  //! Whether the coefficient optimization was skipped based on the satd.
+  uint8_t skip_trellis;
+} TXB_RD_INFO;
+
+/*!\cond */
+#define TXB_RD_RECORD_SIZE_LOG2 11
+#define TXB_RD_RECORD_SIZE (1 << TXB_RD_RECORD_SIZE_LOG2)
+/*!\endcond */
+
+/*! \brief Hash records of the transform type search results
+ *
+ * Direct mapped cache of the results of search_tx_type() for one transform
+ * type, keyed on the residue of the transform block. The same residue is often
+ * searched again by other partition candidates and by the transform partition
+ * search within one superblock, after which the records are dropped.
+ */
+typedef struct {
+  //! The records.
+  TXB_RD_INFO txb_rd_info[TXB_RD_RECORD_SIZE];
+  //! Only the records with this generation are valid.
+  uint32_t epoch;
+  //! Hash function
+  CRC32C crc_calculator;
+} TXB_RD_RECORD;
+
 //! Number of compound rd stats
 #define MAX_COMP_RD_STATS 64
 /*! \brief Rdcost stats in compound mode.
@@ -352,6 +403,12 @@ typedef struct {
 
 /*! \brief Holds some parameters related to partitioning schemes in AV1.
  */
+/*!\cond */
+// Number of nodes of the intra CNN partition quad tree, from BLOCK_64X64 down
+// to BLOCK_8X8.
+#define INTRA_CNN_QUAD_TREE_NODES (1 + 4 + 16 + 64)
+/*!\endcond */
+
 // TODO(chiyotsai@google.com): Consolidate this with SIMPLE_MOTION_DATA_TREE
 typedef struct {
 #if !CONFIG_REALTIME_ONLY
@@ -368,6 +425,12 @@ typedef struct {
   float cnn_buffer[CNN_OUT_BUF_SIZE];
   //! log of the quantization parameter of the ancestor BLOCK_64X64.
   float log_q;
+  //! Partition DNN logits of the nodes of the quad tree.
+  float cnn_logits[INTRA_CNN_QUAD_TREE_NODES];
+  /*! \brief Bit (quad_tree_idx + 3) / 4 is set when cnn_logits holds the
+   * logits of node quad_tree_idx and its siblings.
+   */
+  uint32_t cnn_logits_valid;
 #endif
 
   /*! \brief Variance of the subblocks in the superblock.
@@ -478,6 +541,9 @@ typedef struct {
   //! Txfm hash records of inter-modes.
   MB_RD_RECORD *mb_rd_record;
 
+  //! Txfm hash records of the transform blocks of the superblock.
+  TXB_RD_RECORD *txb_rd_record;
+
   /*! \brief Number of txb splits.
    *
    * Keep track of how many times we've used split tx partition for transform
@@ -1729,7 +1729,13 @@ int av1_encode_strategy(AV1_COMP *const cpi, size_t *const size,
   // Per-frame encode speed.  In theory this can vary, but things may have
   // been written assuming speed-level will not change within a sequence, so
   // this parameter should be used with caution.
-  frame_params.speed = oxcf->speed;
+  frame_params.speed = av1_rt_get_frame_speed(cpi);
+  if (frame_params.speed != cpi->speed) {
+    // The encode sets the speed features of each frame again, but the setup
+    // below already reads them. Reset them all to the new speed's tiers.
+    av1_set_speed_features_framesize_independent(cpi, frame_params.speed);
+    av1_set_speed_features_framesize_dependent(cpi, frame_params.speed);
+  }
 
   // Work out some encoding parameters specific to the pass:
   if (has_no_stats_stage(cpi) && oxcf->q_cfg.aq_mode == CYCLIC_REFRESH_AQ) {
@@ -595,6 +595,7 @@ static INLINE void init_encode_rd_sb(AV1_COMP *cpi, ThreadData *td,
 #endif
 
   reset_mb_rd_record(x->txfm_search_info.mb_rd_record);
+  reset_txb_rd_record(x->txfm_search_info.txb_rd_record);
   av1_zero(x->picked_ref_frames_mask);
   av1_invalid_rd_stats(rd_cost);
 }
@@ -661,6 +662,8 @@ static AOM_INLINE void encode_rd_sb(AV1_COMP *cpi, ThreadData *td,
     SuperBlockEnc *sb_enc = &x->sb_enc;
     // No stats for overlay frames. Exclude key frame.
     av1_get_tpl_stats_sb(cpi, sb_size, mi_row, mi_col, sb_enc);
+    sb_enc->ref_part_map =
+        av1_get_static_sb_ref_partition_map(cpi, x, mi_row, mi_col);
 
     // Reset the tree for simple motion search data
     av1_reset_simple_motion_tree_partition(sms_root, sb_size);
@@ -723,6 +726,7 @@ static AOM_INLINE void encode_rd_sb(AV1_COMP *cpi, ThreadData *td,
     }
     // Reset to 0 so that it wouldn't be used elsewhere mistakenly.
     sb_enc->tpl_data_count = 0;
+    sb_enc->ref_part_map = NULL;
 #if CONFIG_COLLECT_COMPONENT_TIMING
     end_timing(cpi, rd_pick_partition_time);
 #endif
@@ -794,6 +798,9 @@ static AOM_INLINE void encode_sb_row(AV1_COMP *cpi, ThreadData *td,
   start_timing(cpi, encode_sb_row_time);
 #endif
 
+  // Wait for the rows of the spatial layer below this row predicts from.
+  av1_svc_layer_filter_wait(cpi, mi_row + mib_size);
+
   // Initialize the left context for the new SB row
   av1_zero_left_context(xd);
 
@@ -1094,7 +1101,8 @@ static AOM_INLINE void encode_tiles(AV1_COMP *cpi) {
 
   av1_init_tile_data(cpi);
   av1_alloc_mb_data(cm, mb, cpi->sf.rt_sf.use_nonrd_pick_mode,
-                    cpi->sf.rd_sf.use_mb_rd_hash);
+                    cpi->sf.rd_sf.use_mb_rd_hash,
+                    cpi->sf.rd_sf.use_txb_rd_hash);
 
   for (tile_row = 0; tile_row < tile_rows; ++tile_row) {
     for (tile_col = 0; tile_col < tile_cols; ++tile_col) {
@@ -1372,6 +1380,28 @@ static AOM_INLINE void encode_frame_internal(AV1_COMP *cpi) {
       features->allow_warped_motion = 0;
   }
 
+  RefCntBuffer *const cur_frame = cm->cur_frame;
+  if (!is_stat_generation_stage(cpi) && av1_use_ref_frame_hash_me(cpi)) {
+    if (cur_frame->hash_index == NULL) {
+      CHECK_MEM_ERROR(cm, cur_frame->hash_index,
+                      aom_calloc(1, sizeof(*cur_frame->hash_index)));
+    }
+    // Built once per frame, the source does not change in the recode loop.
+    RefFrameHashIndex *const index = cur_frame->hash_index;
+    if (!index->valid ||
+        index->frame_number != cm->current_frame.frame_number) {
+      if (!av1_build_ref_frame_hash_index(intrabc_hash_info,
+                                          &cpi->src_hash_cache, cpi->source,
+                                          index)) {
+        aom_internal_error(cm->error, AOM_CODEC_MEM_ERROR,
+                           "Failed to allocate the reference hash index");
+      }
+      index->frame_number = cm->current_frame.frame_number;
+    }
+  } else if (cur_frame->hash_index != NULL) {
+    cur_frame->hash_index->valid = 0;
+  }
+
   int hash_table_created = 0;
   if (!is_stat_generation_stage(cpi) && av1_use_hash_me(cpi) &&
       !cpi->sf.rt_sf.use_nonrd_pick_mode) {
@@ -1399,8 +1429,9 @@ static AOM_INLINE void encode_frame_internal(AV1_COMP *cpi) {
     av1_hash_table_init(intrabc_hash_info);
     av1_hash_table_create(&intrabc_hash_info->intrabc_hash_table);
     hash_table_created = 1;
-    av1_generate_block_2x2_hash_value(intrabc_hash_info, cpi->source,
-                                      block_hash_values[0], is_block_same[0]);
+    av1_generate_block_hash_value_mt(cpi, intrabc_hash_info, cpi->source, 2,
+                                     NULL, block_hash_values[0], NULL,
+                                     is_block_same[0]);
     // Hash data generated for screen contents is used for intraBC ME
     const int min_alloc_size = block_size_wide[mi_params->mi_alloc_bsize];
     const int max_sb_size =
@@ -1408,8 +1439,8 @@ static AOM_INLINE void encode_frame_internal(AV1_COMP *cpi) {
     int src_idx = 0;
     for (int size = 4; size <= max_sb_size; size *= 2, src_idx = !src_idx) {
       const int dst_idx = !src_idx;
-      av1_generate_block_hash_value(
-          intrabc_hash_info, cpi->source, size, block_hash_values[src_idx],
+      av1_generate_block_hash_value_mt(
+          cpi, intrabc_hash_info, cpi->source, size, block_hash_values[src_idx],
           block_hash_values[dst_idx], is_block_same[src_idx],
           is_block_same[dst_idx]);
       if (size >= min_alloc_size) {
@@ -1539,6 +1570,14 @@ static AOM_INLINE void encode_frame_internal(AV1_COMP *cpi) {
 #if CONFIG_COLLECT_COMPONENT_TIMING
   end_timing(cpi, av1_compute_global_motion_time);
 #endif
+
+  // Run the intra partition CNN on the whole frame at once, so that it is
+  // spread over all the workers rather than run by the thread that reaches
+  // each 64x64 block.
+  if (av1_use_intra_cnn_frame_output(cpi)) {
+    av1_alloc_intra_cnn_output(cpi);
+    av1_intra_mode_cnn_predict_frame_mt(cpi);
+  }
 #endif  // !CONFIG_REALTIME_ONLY
 
 #if CONFIG_COLLECT_COMPONENT_TIMING
@@ -1577,6 +1616,11 @@ static AOM_INLINE void encode_frame_internal(AV1_COMP *cpi) {
       encode_tiles(cpi);
   }
 
+#if !CONFIG_REALTIME_ONLY
+  aom_free(cpi->intra_cnn_output);
+  cpi->intra_cnn_output = NULL;
+#endif  // !CONFIG_REALTIME_ONLY
+
   // If intrabc is allowed but never selected, reset the allow_intrabc flag.
   if (features->allow_intrabc && !cpi->intrabc_used) {
     features->allow_intrabc = 0;
@@ -413,6 +413,9 @@ static AOM_INLINE void av1_dealloc_mb_data(struct AV1Common *cm,
   aom_free(mb->txfm_search_info.mb_rd_record);
   mb->txfm_search_info.mb_rd_record = NULL;
 
+  aom_free(mb->txfm_search_info.txb_rd_record);
+  mb->txfm_search_info.txb_rd_record = NULL;
+
   aom_free(mb->inter_modes_info);
   mb->inter_modes_info = NULL;
 
@@ -432,13 +435,25 @@ static AOM_INLINE void av1_dealloc_mb_data(struct AV1Common *cm,
 static AOM_INLINE void av1_alloc_mb_data(struct AV1Common *cm,
                                          struct macroblock *mb,
                                          int use_nonrd_pick_mode,
-                                         int use_mb_rd_hash) {
+                                         int use_mb_rd_hash,
+                                         int use_txb_rd_hash) {
   if (!use_nonrd_pick_mode) {
     // Memory for mb_rd_record is allocated only when use_mb_rd_hash sf is
     // enabled.
     if (use_mb_rd_hash)
       mb->txfm_search_info.mb_rd_record =
           (MB_RD_RECORD *)aom_malloc(sizeof(MB_RD_RECORD));
+    // Likewise for txb_rd_record and use_txb_rd_hash. The records start out
+    // invalid as their generation is 0.
+    if (use_txb_rd_hash) {
+      TXB_RD_RECORD *const txb_rd_record =
+          (TXB_RD_RECORD *)aom_calloc(1, sizeof(TXB_RD_RECORD));
+      if (txb_rd_record) {
+        txb_rd_record->epoch = 1;
+        av1_crc32c_calculator_init(&txb_rd_record->crc_calculator);
+      }
+      mb->txfm_search_info.txb_rd_record = txb_rd_record;
+    }
     if (!frame_is_intra_only(cm))
       CHECK_MEM_ERROR(
           cm, mb->inter_modes_info,
@@ -66,6 +66,7 @@
 #include "av1/encoder/hybrid_fwd_txfm.h"
 #include "av1/encoder/intra_mode_search.h"
 #include "av1/encoder/mv_prec.h"
+#include "av1/encoder/partition_strategy.h"
 #include "av1/encoder/pass2_strategy.h"
 #include "av1/encoder/pickcdef.h"
 #include "av1/encoder/picklpf.h"
@@ -80,6 +81,7 @@
 #include "av1/encoder/superres_scale.h"
 #include "av1/encoder/thirdpass.h"
 #include "av1/encoder/tpl_model.h"
+#include "av1/encoder/tx_search.h"
 #include "av1/encoder/reconinter_enc.h"
 #include "av1/encoder/var_based_part.h"
 
@@ -200,6 +202,10 @@ static void initialize_enc(void) {
   av1_init_me_luts();
   av1_rc_init_minq_luts();
   av1_init_wedge_masks();
+  av1_init_tx_search_nn_int16();
+#if !CONFIG_REALTIME_ONLY
+  av1_init_partition_nn_int16();
+#endif
 }
 
 void av1_initialize_enc(void) { aom_once(initialize_enc); }
@@ -687,6 +693,8 @@ void av1_change_config(struct AV1_COMP *cpi, const AV1EncoderConfig *oxcf,
   const FrameDimensionCfg *const frm_dim_cfg = &cpi->oxcf.frm_dim_cfg;
   const RateControlCfg *const rc_cfg = &oxcf->rc_cfg;
 
+  av1_svc_layer_filter_finish(cpi);
+
   // in case of LAP, lag in frames is set according to number of lap buffers
   // calculated at init time. This stores and restores LAP's lag in frames to
   // prevent override by new cfg.
@@ -1378,6 +1386,9 @@ AV1_COMP *av1_create_compressor(AV1_PRIMARY *ppi, AV1EncoderConfig *oxcf,
 
   cpi->mb_weber_stats = NULL;
   cpi->mb_delta_q = NULL;
+#if !CONFIG_REALTIME_ONLY
+  cpi->intra_cnn_output = NULL;
+#endif  // !CONFIG_REALTIME_ONLY
 
   {
     const int bsize = BLOCK_16X16;
@@ -1551,6 +1562,9 @@ void av1_remove_primary_compressor(AV1_PRIMARY *ppi) {
 void av1_remove_compressor(AV1_COMP *cpi) {
   if (!cpi) return;
 
+  av1_svc_layer_filter_finish(cpi);
+  av1_svc_layer_filter_dealloc(cpi->svc_layer_filter);
+
   AV1_COMMON *cm = &cpi->common;
   if (cm->current_frame.frame_number > 0) {
 #if CONFIG_SPEED_STATS
@@ -1571,6 +1585,23 @@ void av1_remove_compressor(AV1_COMP *cpi) {
   av1_denoiser_free(&(cpi->denoiser));
 #endif
 
+  av1_free_src_block_hash_cache(&cpi->src_hash_cache);
+  if (cm->buffer_pool != NULL) {
+    // The frame buffers are freed with the buffer pool, after the encoder.
+    for (int i = 0; i < FRAME_BUFFERS; ++i) {
+      RefCntBuffer *const buf = &cm->buffer_pool->frame_bufs[i];
+      if (buf->hash_index != NULL) {
+        av1_free_ref_frame_hash_index(buf->hash_index);
+        aom_free(buf->hash_index);
+        buf->hash_index = NULL;
+      }
+      aom_free(buf->gm_corners);
+      buf->gm_corners = NULL;
+      av1_free_frame_partition_map(buf->part_map);
+      buf->part_map = NULL;
+    }
+  }
+
 #if CONFIG_FRAME_PARALLEL_ENCODE
   aom_free(cm->error);
 #endif
@@ -1672,6 +1703,7 @@ int av1_use_as_reference(int *ext_ref_frame_flags, int ref_frame_flags) {
 int av1_copy_reference_enc(AV1_COMP *cpi, int idx, YV12_BUFFER_CONFIG *sd) {
   AV1_COMMON *const cm = &cpi->common;
   const int num_planes = av1_num_planes(cm);
+  av1_svc_layer_filter_finish(cpi);
   YV12_BUFFER_CONFIG *cfg = get_ref_frame(cm, idx);
   if (cfg) {
     aom_yv12_copy_frame(cfg, sd, num_planes);
@@ -1684,6 +1716,7 @@ int av1_copy_reference_enc(AV1_COMP *cpi, int idx, YV12_BUFFER_CONFIG *sd) {
 int av1_set_reference_enc(AV1_COMP *cpi, int idx, YV12_BUFFER_CONFIG *sd) {
   AV1_COMMON *const cm = &cpi->common;
   const int num_planes = av1_num_planes(cm);
+  av1_svc_layer_filter_finish(cpi);
   YV12_BUFFER_CONFIG *cfg = get_ref_frame(cm, idx);
   if (cfg) {
     aom_yv12_copy_frame(sd, cfg, num_planes);
@@ -2130,6 +2163,9 @@ void av1_set_frame_size(AV1_COMP *cpi, int width, int height) {
 
   init_motion_estimation(cpi);
 
+  // The worker extends the borders of the frame it filters.
+  const RefCntBuffer *const filtered_buf =
+      cpi->svc_layer_filter != NULL ? cpi->svc_layer_filter->frame : NULL;
   for (ref_frame = LAST_FRAME; ref_frame <= ALTREF_FRAME; ++ref_frame) {
     RefCntBuffer *const buf = get_ref_frame_buf(cm, ref_frame);
     if (buf != NULL) {
@@ -2137,7 +2173,8 @@ void av1_set_frame_size(AV1_COMP *cpi, int width, int height) {
       av1_setup_scale_factors_for_frame(sf, buf->buf.y_crop_width,
                                         buf->buf.y_crop_height, cm->width,
                                         cm->height);
-      if (av1_is_scaled(sf)) aom_extend_frame_borders(&buf->buf, num_planes);
+      if (av1_is_scaled(sf) && buf != filtered_buf)
+        aom_extend_frame_borders(&buf->buf, num_planes);
     }
   }
 
@@ -2147,13 +2184,31 @@ void av1_set_frame_size(AV1_COMP *cpi, int width, int height) {
   set_ref_ptrs(cm, xd, LAST_FRAME, LAST_FRAME);
 }
 
+// Returns whether the loop filter, CDEF and the border extension of the
+// current spatial layer run on a worker thread while the next spatial layer
+// is encoded.
+static int defer_svc_layer_filter(const AV1_COMP *cpi) {
+  const AV1_COMMON *const cm = &cpi->common;
+  const SVC *const svc = &cpi->svc;
+#if CONFIG_AV1_TEMPORAL_DENOISING
+  // The denoiser copies the filtered frame after the encode.
+  if (cpi->oxcf.noise_sensitivity > 0) return 0;
+#endif
+  return cpi->oxcf.svc_layer_pipeline && cpi->ppi->use_svc &&
+         svc->spatial_layer_id < svc->number_spatial_layers - 1 &&
+         !svc->non_reference_frame && svc->force_zero_mode_spatial_ref &&
+         cpi->sf.hl_sf.recode_loop == DISALLOW_RECODE &&
+         !cm->features.allow_intrabc && !is_restoration_used(cm) &&
+         !av1_superres_scaled(cm) && !cpi->ppi->b_calculate_psnr;
+}
+
 /*!\brief Select and apply cdef filters and switchable restoration filters
  *
  * \ingroup high_level_algo
  */
 static void cdef_restoration_frame(AV1_COMP *cpi, AV1_COMMON *cm,
                                    MACROBLOCKD *xd, int use_restoration,
-                                   int use_cdef) {
+                                   int use_cdef, int defer_filter) {
 #if !CONFIG_REALTIME_ONLY
   if (use_restoration)
     av1_loop_restoration_save_boundary_lines(&cm->cur_frame->buf, cm, 0);
@@ -2174,7 +2229,7 @@ static void cdef_restoration_frame(AV1_COMP *cpi, AV1_COMMON *cm,
                     cpi->svc.non_reference_frame);
 
     // Apply the filter
-    if (!cpi->svc.non_reference_frame) {
+    if (!cpi->svc.non_reference_frame && !defer_filter) {
       if (num_workers > 1) {
         av1_cdef_frame_mt(cm, xd, cpi->mt_info.cdef_worker,
                           cpi->mt_info.workers, &cpi->mt_info.cdef_sync,
@@ -2231,7 +2286,7 @@ static void cdef_restoration_frame(AV1_COMP *cpi, AV1_COMMON *cm,
  *
  * \ingroup high_level_algo
  */
-static void loopfilter_frame(AV1_COMP *cpi, AV1_COMMON *cm) {
+static void loopfilter_frame(AV1_COMP *cpi, AV1_COMMON *cm, int defer_filter) {
   MultiThreadInfo *const mt_info = &cpi->mt_info;
   const int num_workers = mt_info->num_mod_workers[MOD_LPF];
   const int num_planes = av1_num_planes(cm);
@@ -2255,6 +2310,11 @@ static void loopfilter_frame(AV1_COMP *cpi, AV1_COMMON *cm) {
       (cur_height_mib - cur_height < MI_SIZE);
 
   struct loopfilter *lf = &cm->lf;
+  // The CDEF search reads the deblocked frame unless the strengths are
+  // derived from the quantizer.
+  const int defer_lf =
+      defer_filter &&
+      (!use_cdef || cpi->sf.lpf_sf.cdef_pick_method == CDEF_PICK_FROM_Q);
 
 #if CONFIG_COLLECT_COMPONENT_TIMING
   start_timing(cpi, loop_filter_time);
@@ -2266,8 +2326,9 @@ static void loopfilter_frame(AV1_COMP *cpi, AV1_COMMON *cm) {
     lf->filter_level[1] = 0;
   }
 
-  if ((lf->filter_level[0] || lf->filter_level[1]) &&
-      !cpi->svc.non_reference_frame) {
+  const int do_lf = (lf->filter_level[0] || lf->filter_level[1]) &&
+                    !cpi->svc.non_reference_frame;
+  if (do_lf && !defer_lf) {
     av1_loop_filter_frame_mt(&cm->cur_frame->buf, cm, xd, 0, num_planes, 0,
                              mt_info->workers, num_workers,
                              &mt_info->lf_row_sync, is_realtime);
@@ -2276,7 +2337,10 @@ static void loopfilter_frame(AV1_COMP *cpi, AV1_COMMON *cm) {
   end_timing(cpi, loop_filter_time);
 #endif
 
-  cdef_restoration_frame(cpi, cm, xd, use_restoration, use_cdef);
+  cdef_restoration_frame(cpi, cm, xd, use_restoration, use_cdef, defer_filter);
+
+  if (defer_filter)
+    av1_svc_layer_filter_launch(cpi, do_lf && defer_lf, use_cdef, is_realtime);
 }
 
 /*!\brief Encode a frame without the recode loop, usually used in one-pass
@@ -2309,6 +2373,8 @@ static int encode_without_recode(AV1_COMP *cpi) {
   av1_setup_frame_size(cpi);
   av1_set_size_dependent_vars(cpi, &q, &bottom_index, &top_index);
   av1_set_mv_search_params(cpi);
+  // After the speed features of the frame size, which it reads.
+  av1_svc_layer_filter_setup_frame(cpi);
 
   if (!cpi->ppi->use_svc) {
     phase_scaler = 8;
@@ -2416,7 +2482,7 @@ static int encode_without_recode(AV1_COMP *cpi) {
 
   av1_set_quantizer(cm, q_cfg->qm_minlevel, q_cfg->qm_maxlevel, q,
                     q_cfg->enable_chroma_deltaq, q_cfg->enable_hdr_deltaq);
-  av1_set_speed_features_qindex_dependent(cpi, cpi->oxcf.speed);
+  av1_set_speed_features_qindex_dependent(cpi, cpi->speed);
   if ((q_cfg->deltaq_mode != NO_DELTA_Q) || q_cfg->enable_chroma_deltaq)
     av1_init_quantizer(&cpi->enc_quant_dequant_params, &cm->quant_params,
                        cm->seq_params->bit_depth);
@@ -2432,7 +2498,7 @@ static int encode_without_recode(AV1_COMP *cpi) {
     if (av1_encodedframe_overshoot_cbr(cpi, &q)) {
       av1_set_quantizer(cm, q_cfg->qm_minlevel, q_cfg->qm_maxlevel, q,
                         q_cfg->enable_chroma_deltaq, q_cfg->enable_hdr_deltaq);
-      av1_set_speed_features_qindex_dependent(cpi, cpi->oxcf.speed);
+      av1_set_speed_features_qindex_dependent(cpi, cpi->speed);
       if (q_cfg->deltaq_mode != NO_DELTA_Q || q_cfg->enable_chroma_deltaq)
         av1_init_quantizer(&cpi->enc_quant_dequant_params, &cm->quant_params,
                            cm->seq_params->bit_depth);
@@ -2471,6 +2537,7 @@ static int encode_without_recode(AV1_COMP *cpi) {
 
   // transform / motion compensation build reconstruction frame
   av1_encode_frame(cpi);
+  av1_svc_layer_filter_finish(cpi);
 
   // Update some stats from cyclic refresh.
   if (q_cfg->aq_mode == CYCLIC_REFRESH_AQ && !cpi->rc.rtc_external_ratectrl &&
@@ -2522,6 +2589,7 @@ static int encode_with_recode_loop(AV1_COMP *cpi, size_t *size, uint8_t *dest) {
   // Must allow recode if minimum compression ratio is set.
   assert(IMPLIES(oxcf->rc_cfg.min_cr > 0, allow_recode));
 
+  av1_svc_layer_filter_finish(cpi);
   set_size_independent_vars(cpi);
   if (is_stat_consumption_stage_twopass(cpi) &&
       cpi->sf.interp_sf.adaptive_interp_filter_search)
@@ -2974,9 +3042,14 @@ static int encode_with_recode_loop_and_filter(AV1_COMP *cpi, size_t *size,
   cm->cur_frame->buf.render_width = cm->render_width;
   cm->cur_frame->buf.render_height = cm->render_height;
 
+#if !CONFIG_REALTIME_ONLY
+  av1_store_frame_partition_map(cpi);
+#endif  // !CONFIG_REALTIME_ONLY
+
   // Pick the loop filter level for the frame.
+  const int defer_filter = defer_svc_layer_filter(cpi);
   if (!cm->features.allow_intrabc) {
-    loopfilter_frame(cpi, cm);
+    loopfilter_frame(cpi, cm, defer_filter);
   } else {
     cm->lf.filter_level[0] = 0;
     cm->lf.filter_level[1] = 0;
@@ -2991,9 +3064,12 @@ static int encode_with_recode_loop_and_filter(AV1_COMP *cpi, size_t *size,
 
   // TODO(debargha): Fix mv search range on encoder side
   // aom_extend_frame_inner_borders(&cm->cur_frame->buf, av1_num_planes(cm));
-  aom_extend_frame_borders(&cm->cur_frame->buf, av1_num_planes(cm));
+  // The worker extends the borders of the frame it filters.
+  if (!defer_filter)
+    aom_extend_frame_borders(&cm->cur_frame->buf, av1_num_planes(cm));
 
 #ifdef OUTPUT_YUV_REC
+  av1_svc_layer_filter_finish(cpi);
   aom_write_one_yuv_frame(cm, &cm->cur_frame->buf);
 #endif
 
@@ -4348,6 +4424,12 @@ int av1_get_compressed_data(AV1_COMP *cpi, AV1_COMP_DATA *const cpi_data) {
   cm->error->setjmp = 1;
 #endif  // CONFIG_FRAME_PARALLEL_ENCODE
 
+  // The pending filtering of a spatial layer only overlaps the encode of the
+  // spatial layer above it.
+  if (cpi->svc_layer_filter != NULL &&
+      cpi->svc.spatial_layer_id != cpi->svc_layer_filter->spatial_layer_id + 1)
+    av1_svc_layer_filter_finish(cpi);
+
 #if CONFIG_INTERNAL_STATS
   cpi->frame_recode_hits = 0;
   cpi->time_compress_data = 0;
@@ -4396,6 +4478,8 @@ int av1_get_compressed_data(AV1_COMP *cpi, AV1_COMP_DATA *const cpi_data) {
     return AOM_CODEC_ERROR;
 #endif  // CONFIG_FRAME_PARALLEL_ENCODE
   }
+  if (cm->cur_frame->gm_corners != NULL) cm->cur_frame->gm_corners->valid = 0;
+  if (cm->cur_frame->part_map != NULL) cm->cur_frame->part_map->valid = 0;
 
 #if CONFIG_COLLECT_COMPONENT_TIMING
   // Accumulate 2nd pass time in 2-pass case or 1 pass time in 1-pass case.
@@ -4403,10 +4487,13 @@ int av1_get_compressed_data(AV1_COMP *cpi, AV1_COMP_DATA *const cpi_data) {
     start_timing(cpi, av1_encode_strategy_time);
 #endif
 
+  struct aom_usec_timer encode_timer;
+  aom_usec_timer_start(&encode_timer);
   const int result = av1_encode_strategy(
       cpi, &cpi_data->frame_size, cpi_data->cx_data, &cpi_data->lib_flags,
       &cpi_data->ts_frame_start, &cpi_data->ts_frame_end,
       cpi_data->timestamp_ratio, &cpi_data->pop_lookahead, cpi_data->flush);
+  aom_usec_timer_mark(&encode_timer);
 
 #if CONFIG_COLLECT_COMPONENT_TIMING
   if (cpi->oxcf.pass == 2 || cpi->oxcf.pass == 0)
@@ -4469,6 +4556,9 @@ int av1_get_compressed_data(AV1_COMP *cpi, AV1_COMP_DATA *const cpi_data) {
   cpi->time_compress_data += aom_usec_timer_elapsed(&cmptimer);
 #endif  // CONFIG_INTERNAL_STATS
 
+  if (!cm->show_existing_frame && !cpi->is_dropped_frame)
+    av1_rt_update_speed_control(cpi, aom_usec_timer_elapsed(&encode_timer));
+
 #if CONFIG_SPEED_STATS
   if (!is_stat_generation_stage(cpi) && !cm->show_existing_frame) {
     cpi->tx_search_count += cpi->td.mb.txfm_search_info.tx_search_count;
@@ -4792,6 +4882,7 @@ int av1_init_parallel_frame_context(const AV1_COMP_DATA *const first_cpi_data,
 
 int av1_get_preview_raw_frame(AV1_COMP *cpi, YV12_BUFFER_CONFIG *dest) {
   AV1_COMMON *cm = &cpi->common;
+  av1_svc_layer_filter_finish(cpi);
   if (!cm->show_frame) {
     return -1;
   } else {
@@ -4812,6 +4903,7 @@ int av1_get_preview_raw_frame(AV1_COMP *cpi, YV12_BUFFER_CONFIG *dest) {
 
 int av1_get_last_show_frame(AV1_COMP *cpi, YV12_BUFFER_CONFIG *frame) {
   if (cpi->last_show_frame_buf == NULL) return -1;
+  av1_svc_layer_filter_finish(cpi);
 
   *frame = cpi->last_show_frame_buf->buf;
   return 0;
@@ -864,6 +864,12 @@ typedef struct {
    * 3: Loop filter is disables for the frames with low motion
    */
   LOOPFILTER_CONTROL loopfilter_control;
+
+  /*!
+   * Indicates if the first pass should analyse a 2x decimated proxy of the
+   * source. The resulting stats are normalized to the full resolution MB grid.
+   */
+  bool firstpass_downscale;
 } AlgoCfg;
 /*!\cond */
 
@@ -1020,6 +1026,16 @@ typedef struct AV1EncoderConfig {
   // Indicates the speed preset to be used.
   int speed;
 
+  // Indicates the encode time budget per frame in microseconds for the real-
+  // time mode. The speed is raised from the preset above as needed to meet
+  // it. 0 disables the speed control.
+  unsigned int frame_time_budget;
+
+  // When set to 1, the loop filter, CDEF and the border extension of a
+  // spatial layer run on a worker thread while the next spatial layer is
+  // encoded from the rows that are ready.
+  unsigned int svc_layer_pipeline;
+
   // Indicates the target sequence level index for each operating point(OP).
   AV1_LEVEL target_seq_level_idx[MAX_NUM_OPERATING_POINTS];
 
@@ -1664,6 +1680,102 @@ typedef struct MultiThreadInfo {
 #endif  // CONFIG_FRAME_PARALLEL_ENCODE
 } MultiThreadInfo;
 
+/*!
+ * \brief Deferred in-loop filtering of a spatial layer.
+ *
+ * The loop filter, CDEF and the border extension of a spatial layer run on a
+ * worker thread, on a copy of the frame level parameters, while the next
+ * spatial layer is encoded. The encode of each superblock row of the next
+ * layer waits until the rows of this frame it predicts from are ready.
+ */
+typedef struct AV1SvcLayerFilter {
+  /*!
+   * Worker thread running the filters.
+   */
+  AVxWorker worker;
+
+#if CONFIG_MULTITHREAD
+  /*!
+   * Mutex guarding rows_done.
+   */
+  pthread_mutex_t *mutex_;
+
+  /*!
+   * Condition variable signaled when rows_done is updated.
+   */
+  pthread_cond_t *cond_;
+#endif
+
+  /*!
+   * Copy of the frame level parameters of the filtered frame. The mode info
+   * arrays point to mi_alloc and mi_grid_base below.
+   */
+  AV1_COMMON cm;
+
+  /*!
+   * Copy of the block level parameters used by the filters.
+   */
+  MACROBLOCKD xd;
+
+  /*!
+   * Copy of the mode info of the filtered frame.
+   */
+  MB_MODE_INFO *mi_alloc;
+
+  /*!
+   * Number of allocated elements in mi_alloc.
+   */
+  int mi_alloc_size;
+
+  /*!
+   * Copy of the mode info grid of the filtered frame, pointing to mi_alloc.
+   */
+  MB_MODE_INFO **mi_grid_base;
+
+  /*!
+   * Number of allocated elements in mi_grid_base.
+   */
+  int mi_grid_size;
+
+  /*!
+   * Frame being filtered, NULL when no filtering is pending. A reference to
+   * it is held until the filtering is finished.
+   */
+  RefCntBuffer *frame;
+
+  /*!
+   * Spatial layer of the filtered frame.
+   */
+  int spatial_layer_id;
+
+  /*!
+   * Whether the loop filter is applied on the worker.
+   */
+  int do_lf;
+
+  /*!
+   * Whether CDEF is applied on the worker.
+   */
+  int use_cdef;
+
+  /*!
+   * Whether the realtime loop filter functions are used.
+   */
+  int is_realtime;
+
+  /*!
+   * Number of luma rows from the top of the frame that are final, INT_MAX
+   * once the filtering and the border extension are done.
+   */
+  int rows_done;
+
+  /*!
+   * Whether the encode of the current frame waits on rows_done instead of
+   * waiting for the filtering to finish.
+   */
+  int row_sync;
+} AV1SvcLayerFilter;
+
 /*!\cond */
 
 typedef struct ActiveMap {
@@ -3019,6 +3131,12 @@ typedef struct AV1_COMP {
    */
   MultiThreadInfo mt_info;
 
+  /*!
+   * Filtering of the previous spatial layer that overlaps the encode of the
+   * current one, see AV1E_SET_SVC_LAYER_PIPELINE. NULL until first used.
+   */
+  AV1SvcLayerFilter *svc_layer_filter;
+
   /*!
    * Specifies the frame to be output. It is valid only if show_existing_frame
    * is 1. When show_existing_frame is 0, existing_fb_idx_to_show is set to
@@ -3031,6 +3149,12 @@ typedef struct AV1_COMP {
    */
   int intrabc_used;
 
+  /*!
+   * Block hash values of the last source frame hashed for the reference frame
+   * hash index, so that the index of the next frame is updated incrementally.
+   */
+  SrcBlockHashCache src_hash_cache;
+
   /*!
    * Mark which ref frames can be skipped for encoding current frame during RDO.
    */
@@ -3277,6 +3401,17 @@ typedef struct AV1_COMP {
    */
   int *mb_delta_q;
 
+#if !CONFIG_REALTIME_ONLY
+  /*!
+   * Output of the intra mode partition CNN for each 64x64 block of the
+   * current intra frame that lies fully inside the frame, in raster order of
+   * the 64x64 blocks with CNN_OUT_BUF_SIZE floats per block. It is computed
+   * for the whole frame before the superblocks are encoded, and is NULL when
+   * the CNN is not used for the frame.
+   */
+  float *intra_cnn_output;
+#endif  // !CONFIG_REALTIME_ONLY
+
   /*!
    * Flag to indicate that current frame is dropped.
    */
@@ -3668,6 +3803,14 @@ static INLINE int av1_use_hash_me(const AV1_COMP *const cpi) {
           frame_is_intra_only(&cpi->common));
 }
 
+// Whether the hash index of the source of each frame is built, and searched in
+// inter motion search when the frame is a reference.
+static INLINE int av1_use_ref_frame_hash_me(const AV1_COMP *const cpi) {
+  return cpi->sf.mv_sf.use_ref_frame_hash_search &&
+         (cpi->common.features.allow_screen_content_tools ||
+          cpi->oxcf.tune_cfg.content == AOM_CONTENT_SCREEN);
+}
+
 static INLINE const YV12_BUFFER_CONFIG *get_ref_frame_yv12_buf(
     const AV1_COMMON *const cm, MV_REFERENCE_FRAME ref_frame) {
   const RefCntBuffer *const buf = get_ref_frame_buf(cm, ref_frame);
@@ -3731,6 +3874,17 @@ static INLINE int is_stat_generation_stage(const AV1_COMP *const cpi) {
   return (cpi->oxcf.pass == AOM_RC_FIRST_PASS ||
           (cpi->compressor_stage == LAP_STAGE));
 }
+
+// Check if the first pass analyses a 2x decimated proxy of the source. The
+// downscaled frame has to satisfy the minimum frame size of 16x16. Only the
+// first pass of a two pass encode is downscaled, not the lookahead stage.
+static INLINE int is_firstpass_downscaled(const AV1_COMP *const cpi) {
+  const FrameDimensionCfg *const frm_dim_cfg = &cpi->oxcf.frm_dim_cfg;
+  return cpi->oxcf.pass == AOM_RC_FIRST_PASS &&
+         cpi->oxcf.algo_cfg.firstpass_downscale && frm_dim_cfg->width >= 32 &&
+         frm_dim_cfg->height >= 32;
+}
+
 // Check if statistics consumption stage
 static INLINE int is_stat_consumption_stage_twopass(const AV1_COMP *const cpi) {
   return (cpi->oxcf.pass >= AOM_RC_SECOND_PASS);
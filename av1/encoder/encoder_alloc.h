@@ -306,6 +306,11 @@ static AOM_INLINE void dealloc_compressor_data(AV1_COMP *cpi) {
 
   aom_free(cpi->mb_delta_q);
   cpi->mb_delta_q = NULL;
+
+#if !CONFIG_REALTIME_ONLY
+  aom_free(cpi->intra_cnn_output);
+  cpi->intra_cnn_output = NULL;
+#endif  // !CONFIG_REALTIME_ONLY
 }
 
 static AOM_INLINE void allocate_gradient_info_for_hog(
@@ -9,10 +9,14 @@
  * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
  */
 
+#include "config/aom_scale_rtcd.h"
+
+#include "av1/common/cdef.h"
 #include "av1/common/warped_motion.h"
 #include "av1/common/thread_common.h"
 
 #include "av1/encoder/bitstream.h"
+#include "av1/encoder/corner_match.h"
 #include "av1/encoder/encodeframe.h"
 #include "av1/encoder/encoder.h"
 #include "av1/encoder/encoder_alloc.h"
@@ -24,6 +28,7 @@
 #include "av1/encoder/global_motion.h"
 #include "av1/encoder/global_motion_facade.h"
 #include "av1/encoder/intra_mode_search_utils.h"
+#include "av1/encoder/partition_strategy.h"
 #include "av1/encoder/rdopt.h"
 #include "aom_dsp/aom_dsp_common.h"
 #include "av1/encoder/temporal_filter.h"
@@ -1289,7 +1294,8 @@ static AOM_INLINE void prepare_enc_workers(AV1_COMP *cpi, AVxWorkerHook hook,
     }
     av1_alloc_mb_data(cm, &thread_data->td->mb,
                       cpi->sf.rt_sf.use_nonrd_pick_mode,
-                      cpi->sf.rd_sf.use_mb_rd_hash);
+                      cpi->sf.rd_sf.use_mb_rd_hash,
+                      cpi->sf.rd_sf.use_txb_rd_hash);
 
     // Reset cyclic refresh counters.
     av1_init_cyclic_refresh_counters(&thread_data->td->mb);
@@ -1365,7 +1371,8 @@ static AOM_INLINE void fp_prepare_enc_workers(AV1_COMP *cpi, AVxWorkerHook hook,
 
     av1_alloc_mb_data(cm, &thread_data->td->mb,
                       cpi->sf.rt_sf.use_nonrd_pick_mode,
-                      cpi->sf.rd_sf.use_mb_rd_hash);
+                      cpi->sf.rd_sf.use_mb_rd_hash,
+                      cpi->sf.rd_sf.use_txb_rd_hash);
   }
 }
 #endif
@@ -1894,6 +1901,90 @@ void av1_tf_mt_dealloc(AV1TemporalFilterSync *tf_sync) {
   tf_sync->next_tf_row = 0;
 }
 
+// Allocate memory for ordering the temporal filter motion search of a block
+// row against consecutive frames.
+static void tf_ms_sync_alloc(AV1_COMMON *cm, AV1TemporalFilterSync *tf_sync,
+                             int mb_rows, int num_frames) {
+#if CONFIG_MULTITHREAD
+  CHECK_MEM_ERROR(cm, tf_sync->ms_mutex_,
+                  aom_malloc(sizeof(*tf_sync->ms_mutex_) * mb_rows));
+  if (tf_sync->ms_mutex_) {
+    for (int i = 0; i < mb_rows; ++i)
+      pthread_mutex_init(&tf_sync->ms_mutex_[i], NULL);
+  }
+  CHECK_MEM_ERROR(cm, tf_sync->ms_cond_,
+                  aom_malloc(sizeof(*tf_sync->ms_cond_) * mb_rows));
+  if (tf_sync->ms_cond_) {
+    for (int i = 0; i < mb_rows; ++i)
+      pthread_cond_init(&tf_sync->ms_cond_[i], NULL);
+  }
+#endif  // CONFIG_MULTITHREAD
+  CHECK_MEM_ERROR(cm, tf_sync->ms_finished_cols,
+                  aom_calloc(mb_rows * num_frames,
+                             sizeof(*tf_sync->ms_finished_cols)));
+  tf_sync->next_ms_job = 0;
+}
+
+// Deallocate memory for ordering the temporal filter motion search.
+static void tf_ms_sync_dealloc(AV1TemporalFilterSync *tf_sync, int mb_rows) {
+#if CONFIG_MULTITHREAD
+  if (tf_sync->ms_mutex_ != NULL) {
+    for (int i = 0; i < mb_rows; ++i)
+      pthread_mutex_destroy(&tf_sync->ms_mutex_[i]);
+    aom_free(tf_sync->ms_mutex_);
+    tf_sync->ms_mutex_ = NULL;
+  }
+  if (tf_sync->ms_cond_ != NULL) {
+    for (int i = 0; i < mb_rows; ++i)
+      pthread_cond_destroy(&tf_sync->ms_cond_[i]);
+    aom_free(tf_sync->ms_cond_);
+    tf_sync->ms_cond_ = NULL;
+  }
+#else
+  (void)mb_rows;
+#endif  // CONFIG_MULTITHREAD
+  aom_free(tf_sync->ms_finished_cols);
+  tf_sync->ms_finished_cols = NULL;
+  tf_sync->next_ms_job = 0;
+}
+
+// Waits until the block at mb_col of the given row has been motion searched
+// against the previous frame.
+void av1_tf_ms_sync_read(AV1TemporalFilterSync *tf_sync, int num_frames,
+                         int mb_row, int frame, int mb_col) {
+#if CONFIG_MULTITHREAD
+  if (frame == 0) return;
+  const int *finished_cols =
+      &tf_sync->ms_finished_cols[mb_row * num_frames + frame - 1];
+  pthread_mutex_t *const mutex = &tf_sync->ms_mutex_[mb_row];
+  pthread_mutex_lock(mutex);
+  while (*finished_cols <= mb_col)
+    pthread_cond_wait(&tf_sync->ms_cond_[mb_row], mutex);
+  pthread_mutex_unlock(mutex);
+#else
+  (void)tf_sync;
+  (void)num_frames;
+  (void)mb_row;
+  (void)frame;
+  (void)mb_col;
+#endif  // CONFIG_MULTITHREAD
+}
+
+// Signals that the block at mb_col of the given row has been motion searched
+// against the given frame.
+void av1_tf_ms_sync_write(AV1TemporalFilterSync *tf_sync, int num_frames,
+                          int mb_row, int frame, int mb_col) {
+#if CONFIG_MULTITHREAD
+  pthread_mutex_t *const mutex = &tf_sync->ms_mutex_[mb_row];
+  pthread_mutex_lock(mutex);
+  tf_sync->ms_finished_cols[mb_row * num_frames + frame] = mb_col + 1;
+  pthread_cond_broadcast(&tf_sync->ms_cond_[mb_row]);
+  pthread_mutex_unlock(mutex);
+#else
+  tf_sync->ms_finished_cols[mb_row * num_frames + frame] = mb_col + 1;
+#endif  // CONFIG_MULTITHREAD
+}
+
 // Checks if a job is available. If job is available,
 // populates next_tf_row and returns 1, else returns 0.
 static AOM_INLINE int tf_get_next_job(AV1TemporalFilterSync *tf_mt_sync,
@@ -1942,6 +2033,61 @@ static int tf_worker_hook(void *arg1, void *unused) {
   return 1;
 }
 
+// Checks if a motion search job is available. If job is available, populates
+// the block row and frame and returns 1, else returns 0. Jobs are dispatched
+// in block row order and, within a row, in frame order, so that the job a
+// worker waits on has always been picked up before.
+static AOM_INLINE int tf_get_next_ms_job(AV1TemporalFilterSync *tf_mt_sync,
+                                         int *current_mb_row, int *frame,
+                                         int mb_rows, int num_frames) {
+  int do_next_job = 0;
+#if CONFIG_MULTITHREAD
+  pthread_mutex_t *tf_mutex_ = tf_mt_sync->mutex_;
+  pthread_mutex_lock(tf_mutex_);
+#endif
+  if (tf_mt_sync->next_ms_job < mb_rows * num_frames) {
+    *current_mb_row = tf_mt_sync->next_ms_job / num_frames;
+    *frame = tf_mt_sync->next_ms_job % num_frames;
+    tf_mt_sync->next_ms_job++;
+    do_next_job = 1;
+  }
+#if CONFIG_MULTITHREAD
+  pthread_mutex_unlock(tf_mutex_);
+#endif
+  return do_next_job;
+}
+
+// Hook function for each thread in temporal filter motion search
+// multi-threading.
+static int tf_ms_worker_hook(void *arg1, void *unused) {
+  (void)unused;
+  EncWorkerData *thread_data = (EncWorkerData *)arg1;
+  AV1_COMP *cpi = thread_data->cpi;
+  ThreadData *td = thread_data->td;
+  TemporalFilterCtx *tf_ctx = &cpi->tf_ctx;
+  AV1TemporalFilterSync *tf_sync = &cpi->mt_info.tf_sync;
+  const struct scale_factors *scale = &cpi->tf_ctx.sf;
+  const int num_planes = av1_num_planes(&cpi->common);
+  assert(num_planes >= 1 && num_planes <= MAX_MB_PLANE);
+
+  MACROBLOCKD *mbd = &td->mb.e_mbd;
+  uint8_t *input_buffer[MAX_MB_PLANE];
+  MB_MODE_INFO **input_mb_mode_info;
+  tf_save_state(mbd, &input_mb_mode_info, input_buffer, num_planes);
+  tf_setup_macroblockd(mbd, &td->tf_data, scale);
+
+  int current_mb_row = -1;
+  int frame = -1;
+
+  while (tf_get_next_ms_job(tf_sync, &current_mb_row, &frame, tf_ctx->mb_rows,
+                            tf_ctx->num_frames))
+    av1_tf_motion_search_row(cpi, td, current_mb_row, frame);
+
+  tf_restore_state(mbd, input_mb_mode_info, input_buffer, num_planes);
+
+  return 1;
+}
+
 // Assigns temporal filter hook function and thread data to each worker.
 static void prepare_tf_workers(AV1_COMP *cpi, AVxWorkerHook hook,
                                int num_workers, int is_highbitdepth) {
@@ -2014,42 +2160,75 @@ void av1_tf_do_filtering_mt(AV1_COMP *cpi) {
   MultiThreadInfo *mt_info = &cpi->mt_info;
   const int is_highbitdepth = cpi->tf_ctx.is_highbitdepth;
 
+  TemporalFilterCtx *tf_ctx = &cpi->tf_ctx;
+  AV1TemporalFilterSync *tf_sync = &mt_info->tf_sync;
+
   int num_workers =
       AOMMIN(mt_info->num_mod_workers[MOD_TF], mt_info->num_workers);
 
+  // With fewer block rows than workers, the motion search, which dominates
+  // the filtering time, is done ahead of filtering with jobs over (block row,
+  // frame) pairs. Filtering then accumulates the frames of each block in the
+  // same order as the single-thread path, so the output does not depend on
+  // the number of workers.
+  if (num_workers > tf_ctx->mb_rows) {
+    const int num_frames = tf_ctx->num_frames;
+    CHECK_MEM_ERROR(cm, tf_ctx->mv_info,
+                    aom_malloc(sizeof(*tf_ctx->mv_info) * num_frames *
+                               tf_ctx->mb_rows * tf_ctx->mb_cols));
+    tf_ms_sync_alloc(cm, tf_sync, tf_ctx->mb_rows, num_frames);
+    const int num_ms_workers =
+        AOMMIN(num_workers, tf_ctx->mb_rows * num_frames);
+    prepare_tf_workers(cpi, tf_ms_worker_hook, num_ms_workers,
+                       is_highbitdepth);
+    launch_workers(mt_info, num_ms_workers);
+    sync_enc_workers(mt_info, cm, num_ms_workers);
+    tf_dealloc_thread_data(cpi, num_ms_workers, is_highbitdepth);
+    tf_ms_sync_dealloc(tf_sync, tf_ctx->mb_rows);
+    num_workers = tf_ctx->mb_rows;
+  }
+
   prepare_tf_workers(cpi, tf_worker_hook, num_workers, is_highbitdepth);
   launch_workers(mt_info, num_workers);
   sync_enc_workers(mt_info, cm, num_workers);
   tf_accumulate_frame_diff(cpi, num_workers);
   tf_dealloc_thread_data(cpi, num_workers, is_highbitdepth);
+  aom_free(tf_ctx->mv_info);
+  tf_ctx->mv_info = NULL;
 }
 
-// Checks if a job is available in the current direction. If a job is available,
-// frame_idx will be populated and returns 1, else returns 0.
-static AOM_INLINE int get_next_gm_job(AV1_COMP *cpi, int *frame_idx,
-                                      int cur_dir) {
-  GlobalMotionInfo *gm_info = &cpi->gm_info;
-  JobInfo *job_info = &cpi->mt_info.gm_sync.job_info;
-
-  int total_refs = gm_info->num_ref_frames[cur_dir];
-  int8_t cur_frame_to_process = job_info->next_frame_to_process[cur_dir];
-
-  if (cur_frame_to_process < total_refs && !job_info->early_exit[cur_dir]) {
-    *frame_idx = gm_info->reference_frames[cur_dir][cur_frame_to_process].frame;
-    job_info->next_frame_to_process[cur_dir] += 1;
-    return 1;
+// Checks if a job is available in the current stage of global motion
+// multi-threading, out of num_jobs. If a job is available, job_idx will be
+// populated and returns 1, else returns 0.
+static AOM_INLINE int get_next_gm_job(AV1GlobalMotionSync *gm_sync,
+                                      int num_jobs, int *job_idx) {
+  JobInfo *job_info = &gm_sync->job_info;
+  int job_available = 0;
+#if CONFIG_MULTITHREAD
+  pthread_mutex_lock(gm_sync->mutex_);
+#endif
+  if (job_info->next_job < num_jobs) {
+    *job_idx = job_info->next_job++;
+    job_available = 1;
   }
-  return 0;
+#if CONFIG_MULTITHREAD
+  pthread_mutex_unlock(gm_sync->mutex_);
+#endif
+  return job_available;
 }
 
-// Switches the current direction and calls the function get_next_gm_job() if
-// the speed feature 'prune_ref_frame_for_gm_search' is not set.
-static AOM_INLINE void switch_direction(AV1_COMP *cpi, int *frame_idx,
-                                        int *cur_dir) {
-  if (cpi->sf.gm_sf.prune_ref_frame_for_gm_search) return;
-  // Switch the direction and get next job
-  *cur_dir = !(*cur_dir);
-  get_next_gm_job(cpi, frame_idx, *(cur_dir));
+// Returns the 8-bit luma plane of the given reference frame.
+static AOM_INLINE unsigned char *get_gm_ref_buffer(const AV1_COMP *cpi,
+                                                   YV12_BUFFER_CONFIG *ref) {
+  if (ref->flags & YV12_FLAG_HIGHBITDEPTH)
+    return av1_downconvert_frame(ref, cpi->common.seq_params->bit_depth);
+  return ref->y_buffer;
+}
+
+// Returns the first source frame corner matched by the given job.
+static AOM_INLINE int get_gm_match_job_start(int num_src_corners,
+                                             int num_jobs_per_frame, int job) {
+  return job * num_src_corners / num_jobs_per_frame;
 }
 
 // Initializes inliers, num_inliers and segment_map.
@@ -2065,76 +2244,115 @@ static AOM_INLINE void init_gm_thread_data(
                  gm_info->segment_map_w * gm_info->segment_map_h);
 }
 
-// Hook function for each thread in global motion multi-threading.
-static int gm_mt_worker_hook(void *arg1, void *unused) {
+// Hook function getting the FAST corners of the reference frames of the
+// round, one reference frame per job.
+static int gm_corner_detect_worker_hook(void *arg1, void *unused) {
   (void)unused;
 
   EncWorkerData *thread_data = (EncWorkerData *)arg1;
   AV1_COMP *cpi = thread_data->cpi;
-  GlobalMotionInfo *gm_info = &cpi->gm_info;
-  MultiThreadInfo *mt_info = &cpi->mt_info;
-  JobInfo *job_info = &mt_info->gm_sync.job_info;
-  int thread_id = thread_data->thread_id;
-  GlobalMotionThreadData *gm_thread_data =
-      &mt_info->gm_sync.thread_data[thread_id];
-  int cur_dir = job_info->thread_id_to_dir[thread_id];
-#if CONFIG_MULTITHREAD
-  pthread_mutex_t *gm_mt_mutex_ = mt_info->gm_sync.mutex_;
-#endif
+  AV1GlobalMotionSync *gm_sync = &cpi->mt_info.gm_sync;
+  const JobInfo *job_info = &gm_sync->job_info;
+  int job_idx;
 
-  while (1) {
-    int ref_buf_idx = -1;
-    int ref_frame_idx = -1;
+  while (get_next_gm_job(gm_sync, job_info->num_round_frames, &job_idx)) {
+    // Reference frames sharing a frame buffer use the corners of the first.
+    if (job_info->round_corners_idx[job_idx] != job_idx) continue;
+    gm_sync->num_ref_corners[job_idx] =
+        av1_get_gm_ref_corners(cpi, job_info->round_frames[job_idx].frame,
+                               gm_sync->ref_corners[job_idx]);
+  }
+  return 1;
+}
 
-#if CONFIG_MULTITHREAD
-    pthread_mutex_lock(gm_mt_mutex_);
-#endif
+// Hook function matching the corners of the source frame with those of the
+// reference frames of the round. For each reference frame, the source frame
+// corners are split into job_info->num_match_jobs_per_frame jobs. The matches
+// of a job are written where its first corner would be, and are packed by
+// pack_gm_correspondences().
+static int gm_corner_match_worker_hook(void *arg1, void *unused) {
+  (void)unused;
 
-    // Populates ref_buf_idx(the reference frame type) for which global motion
-    // estimation will be done.
-    if (!get_next_gm_job(cpi, &ref_buf_idx, cur_dir)) {
-      // No jobs are available for the current direction. Switch
-      // to other direction and get the next job, if available.
-      switch_direction(cpi, &ref_buf_idx, &cur_dir);
-    }
+  EncWorkerData *thread_data = (EncWorkerData *)arg1;
+  AV1_COMP *cpi = thread_data->cpi;
+  GlobalMotionInfo *gm_info = &cpi->gm_info;
+  AV1GlobalMotionSync *gm_sync = &cpi->mt_info.gm_sync;
+  const JobInfo *job_info = &gm_sync->job_info;
+  const YV12_BUFFER_CONFIG *source = cpi->source;
+  const int num_jobs_per_frame = job_info->num_match_jobs_per_frame;
+  const int num_src_corners = gm_info->num_src_corners;
+  int job_idx;
+
+  while (get_next_gm_job(gm_sync,
+                         job_info->num_round_frames * num_jobs_per_frame,
+                         &job_idx)) {
+    const int frame_idx = job_idx / num_jobs_per_frame;
+    const int job = job_idx % num_jobs_per_frame;
+    const int start =
+        get_gm_match_job_start(num_src_corners, num_jobs_per_frame, job);
+    const int end =
+        get_gm_match_job_start(num_src_corners, num_jobs_per_frame, job + 1);
+    const int corners_idx = job_info->round_corners_idx[frame_idx];
+    YV12_BUFFER_CONFIG *ref =
+        gm_info->ref_buf[job_info->round_frames[frame_idx].frame];
+    gm_sync->num_job_matches[frame_idx][job] = av1_determine_correspondence(
+        gm_info->src_buffer, gm_info->src_corners + 2 * start, end - start,
+        get_gm_ref_buffer(cpi, ref), gm_sync->ref_corners[corners_idx],
+        gm_sync->num_ref_corners[corners_idx], source->y_width,
+        source->y_height, source->y_stride, ref->y_stride,
+        gm_sync->correspondences[frame_idx] + 4 * start);
+  }
+  return 1;
+}
 
-    // 'ref_frame_idx' holds the index of the current reference frame type in
-    // gm_info->reference_frames. job_info->next_frame_to_process will be
-    // incremented in get_next_gm_job() and hence subtracting by 1.
-    ref_frame_idx = job_info->next_frame_to_process[cur_dir] - 1;
+// Packs the matches found by the jobs of gm_corner_match_worker_hook() for
+// each reference frame of the round, in the order of the source frame corners.
+static AOM_INLINE void pack_gm_correspondences(AV1GlobalMotionSync *gm_sync,
+                                               int num_src_corners) {
+  const JobInfo *job_info = &gm_sync->job_info;
+  const int num_jobs_per_frame = job_info->num_match_jobs_per_frame;
 
-#if CONFIG_MULTITHREAD
-    pthread_mutex_unlock(gm_mt_mutex_);
-#endif
+  for (int i = 0; i < job_info->num_round_frames; i++) {
+    int *const correspondences = gm_sync->correspondences[i];
+    int num_correspondences = 0;
+    for (int job = 0; job < num_jobs_per_frame; job++) {
+      const int start =
+          get_gm_match_job_start(num_src_corners, num_jobs_per_frame, job);
+      const int num_matches = gm_sync->num_job_matches[i][job];
+      memmove(correspondences + 4 * num_correspondences,
+              correspondences + 4 * start,
+              sizeof(*correspondences) * 4 * num_matches);
+      num_correspondences += num_matches;
+    }
+    gm_sync->num_correspondences[i] = num_correspondences;
+  }
+}
 
-    if (ref_buf_idx == -1) break;
+// Hook function computing the global motion w.r.t. the reference frames of the
+// round, one reference frame per job.
+static int gm_mt_worker_hook(void *arg1, void *unused) {
+  (void)unused;
 
+  EncWorkerData *thread_data = (EncWorkerData *)arg1;
+  AV1_COMP *cpi = thread_data->cpi;
+  GlobalMotionInfo *gm_info = &cpi->gm_info;
+  AV1GlobalMotionSync *gm_sync = &cpi->mt_info.gm_sync;
+  const JobInfo *job_info = &gm_sync->job_info;
+  GlobalMotionThreadData *gm_thread_data =
+      &gm_sync->thread_data[thread_data->thread_id];
+  int job_idx;
+
+  while (get_next_gm_job(gm_sync, job_info->num_round_frames, &job_idx)) {
     init_gm_thread_data(gm_info, gm_thread_data);
 
-    // Compute global motion for the given ref_buf_idx.
+    // Compute global motion for the given reference frame.
     av1_compute_gm_for_valid_ref_frames(
-        cpi, gm_info->ref_buf, ref_buf_idx, gm_info->num_src_corners,
-        gm_info->src_corners, gm_info->src_buffer,
-        gm_thread_data->params_by_motion, gm_thread_data->segment_map,
-        gm_info->segment_map_w, gm_info->segment_map_h);
-
-#if CONFIG_MULTITHREAD
-    pthread_mutex_lock(gm_mt_mutex_);
-#endif
-    assert(ref_frame_idx != -1);
-    // If global motion w.r.t. current ref frame is
-    // INVALID/TRANSLATION/IDENTITY, skip the evaluation of global motion w.r.t
-    // the remaining ref frames in that direction. The below exit is disabled
-    // when ref frame distance w.r.t. current frame is zero. E.g.:
-    // source_alt_ref_frame w.r.t. ARF frames.
-    if (cpi->sf.gm_sf.prune_ref_frame_for_gm_search &&
-        gm_info->reference_frames[cur_dir][ref_frame_idx].distance != 0 &&
-        cpi->common.global_motion[ref_buf_idx].wmtype != ROTZOOM)
-      job_info->early_exit[cur_dir] = 1;
-
-#if CONFIG_MULTITHREAD
-    pthread_mutex_unlock(gm_mt_mutex_);
-#endif
+        cpi, gm_info->ref_buf, job_info->round_frames[job_idx].frame,
+        gm_info->num_src_corners, gm_info->src_corners, gm_info->src_buffer,
+        gm_sync->correspondences[job_idx],
+        gm_sync->num_correspondences[job_idx], gm_thread_data->params_by_motion,
+        gm_thread_data->segment_map, gm_info->segment_map_w,
+        gm_info->segment_map_h);
   }
   return 1;
 }
@@ -2168,17 +2386,86 @@ static AOM_INLINE void prepare_gm_workers(AV1_COMP *cpi, AVxWorkerHook hook,
   }
 }
 
-// Assigns available threads to past/future direction.
-static AOM_INLINE void assign_thread_to_dir(int8_t *thread_id_to_dir,
-                                            int num_workers) {
-  int8_t frame_dir_idx = 0;
+// Populates the reference frames of the next round of global motion search
+// and returns their count. Without the speed feature
+// 'prune_ref_frame_for_gm_search', all the reference frames are searched in a
+// single round.
+static AOM_INLINE int setup_gm_round(AV1_COMP *cpi) {
+  const GlobalMotionInfo *gm_info = &cpi->gm_info;
+  JobInfo *job_info = &cpi->mt_info.gm_sync.job_info;
 
-  for (int i = 0; i < num_workers; i++) {
-    thread_id_to_dir[i] = frame_dir_idx++;
-    if (frame_dir_idx == MAX_DIRECTIONS) frame_dir_idx = 0;
+  job_info->num_round_frames = 0;
+  for (int dir = 0; dir < MAX_DIRECTIONS; dir++) {
+    int8_t *const next_frame = &job_info->next_frame_to_process[dir];
+    while (!job_info->early_exit[dir] &&
+           *next_frame < gm_info->num_ref_frames[dir]) {
+      const int idx = job_info->num_round_frames++;
+      job_info->round_frames[idx] =
+          gm_info->reference_frames[dir][(*next_frame)++];
+      job_info->round_dir[idx] = dir;
+      if (cpi->sf.gm_sf.prune_ref_frame_for_gm_search) break;
+    }
+  }
+
+  for (int i = 0; i < job_info->num_round_frames; i++) {
+    const int frame = job_info->round_frames[i].frame;
+    int corners_idx = i;
+    for (int j = 0; j < i; j++) {
+      if (gm_info->ref_buf[job_info->round_frames[j].frame] ==
+          gm_info->ref_buf[frame]) {
+        corners_idx = j;
+        break;
+      }
+    }
+    job_info->round_corners_idx[i] = corners_idx;
+    av1_alloc_gm_ref_corners(cpi, frame);
+  }
+  return job_info->num_round_frames;
+}
+
+// Updates the early exit status of each direction from the global motion
+// found w.r.t. the reference frames of the round.
+static AOM_INLINE void update_gm_early_exit(AV1_COMP *cpi) {
+  JobInfo *job_info = &cpi->mt_info.gm_sync.job_info;
+  if (!cpi->sf.gm_sf.prune_ref_frame_for_gm_search) return;
+
+  for (int i = 0; i < job_info->num_round_frames; i++) {
+    // If global motion w.r.t. current ref frame is
+    // INVALID/TRANSLATION/IDENTITY, skip the evaluation of global motion w.r.t
+    // the remaining ref frames in that direction. The below exit is disabled
+    // when ref frame distance w.r.t. current frame is zero. E.g.:
+    // source_alt_ref_frame w.r.t. ARF frames.
+    const FrameDistPair *ref = &job_info->round_frames[i];
+    if (ref->distance != 0 &&
+        cpi->common.global_motion[ref->frame].wmtype != ROTZOOM)
+      job_info->early_exit[job_info->round_dir[i]] = 1;
   }
 }
 
+// Computes the number of jobs the source frame corners are split into for each
+// reference frame of the round, so that all the workers take part in matching.
+static AOM_INLINE int compute_gm_match_jobs_per_frame(const AV1_COMP *cpi) {
+  const int num_round_frames = cpi->mt_info.gm_sync.job_info.num_round_frames;
+  int num_jobs = (2 * cpi->mt_info.num_workers + num_round_frames - 1) /
+                 num_round_frames;
+  num_jobs = AOMMIN(num_jobs, cpi->gm_info.num_src_corners /
+                                  GM_MIN_CORNERS_PER_MATCH_JOB);
+  return clamp(num_jobs, 1, MAX_GM_MATCH_JOBS);
+}
+
+// Runs one stage of global motion multi-threading with the given number of
+// jobs.
+static AOM_INLINE void run_gm_stage(AV1_COMP *cpi, AVxWorkerHook hook,
+                                    int num_jobs) {
+  MultiThreadInfo *mt_info = &cpi->mt_info;
+  const int num_workers = AOMMIN(num_jobs, mt_info->num_workers);
+
+  mt_info->gm_sync.job_info.next_job = 0;
+  prepare_gm_workers(cpi, hook, num_workers);
+  launch_workers(mt_info, num_workers);
+  sync_enc_workers(mt_info, &cpi->common, num_workers);
+}
+
 // Computes number of workers for global motion multi-threading.
 static AOM_INLINE int compute_gm_workers(const AV1_COMP *cpi) {
   int total_refs =
@@ -2202,6 +2489,10 @@ void av1_gm_dealloc(AV1GlobalMotionSync *gm_sync_data) {
     }
     aom_free(gm_sync_data->thread_data);
   }
+  for (int i = 0; i < INTER_REFS_PER_FRAME; i++) {
+    aom_free(gm_sync_data->ref_corners[i]);
+    aom_free(gm_sync_data->correspondences[i]);
+  }
 }
 
 // Allocates memory for inliers and segment_map for each worker in global motion
@@ -2232,6 +2523,15 @@ static AOM_INLINE void gm_alloc(AV1_COMP *cpi, int num_workers) {
                      MAX_CORNERS));
     }
   }
+
+  for (int i = 0; i < INTER_REFS_PER_FRAME; i++) {
+    CHECK_MEM_ERROR(
+        cm, gm_sync->ref_corners[i],
+        aom_malloc(sizeof(*gm_sync->ref_corners[i]) * 2 * MAX_CORNERS));
+    CHECK_MEM_ERROR(
+        cm, gm_sync->correspondences[i],
+        aom_malloc(sizeof(*gm_sync->correspondences[i]) * 4 * MAX_CORNERS));
+  }
 }
 
 // Implements multi-threading for global motion.
@@ -2250,10 +2550,20 @@ void av1_global_motion_estimation_mt(AV1_COMP *cpi) {
     gm_alloc(cpi, num_workers);
   }
 
-  assign_thread_to_dir(job_info->thread_id_to_dir, num_workers);
-  prepare_gm_workers(cpi, gm_mt_worker_hook, num_workers);
-  launch_workers(&cpi->mt_info, num_workers);
-  sync_enc_workers(&cpi->mt_info, &cpi->common, num_workers);
+  // The reference frames are searched in rounds. In each round, the corners
+  // of the reference frames are detected, then matched with the source frame
+  // corners by all the workers, before the motion models are found per
+  // reference frame.
+  while (setup_gm_round(cpi) > 0) {
+    const int num_round_frames = job_info->num_round_frames;
+    job_info->num_match_jobs_per_frame = compute_gm_match_jobs_per_frame(cpi);
+    run_gm_stage(cpi, gm_corner_detect_worker_hook, num_round_frames);
+    run_gm_stage(cpi, gm_corner_match_worker_hook,
+                 num_round_frames * job_info->num_match_jobs_per_frame);
+    pack_gm_correspondences(gm_sync, cpi->gm_info.num_src_corners);
+    run_gm_stage(cpi, gm_mt_worker_hook, num_round_frames);
+    update_gm_early_exit(cpi);
+  }
 }
 #endif  // !CONFIG_REALTIME_ONLY
 
@@ -2582,6 +2892,129 @@ void av1_write_tile_obu_mt(
                           tile_data_start, num_workers);
 }
 
+// Rows of one level of the block hashes of a picture, computed by a worker.
+typedef struct {
+  IntraBCHashInfo *intrabc_hash_info;
+  const YV12_BUFFER_CONFIG *picture;
+  int block_size;
+  int y_start;
+  int y_end;
+  uint32_t **src_hash;
+  uint32_t **dst_hash;
+  int8_t **src_same;
+  int8_t **dst_same;
+} BlockHashJob;
+
+static void generate_block_hash_rows(const BlockHashJob *job) {
+  if (job->block_size == 2) {
+    av1_generate_block_2x2_hash_rows(job->intrabc_hash_info, job->picture,
+                                     job->y_start, job->y_end, job->dst_hash,
+                                     job->dst_same);
+  } else {
+    av1_generate_block_hash_rows(job->intrabc_hash_info, job->picture,
+                                 job->block_size, job->y_start, job->y_end,
+                                 job->src_hash, job->dst_hash, job->src_same,
+                                 job->dst_same);
+  }
+}
+
+static int block_hash_worker_hook(void *arg1, void *unused) {
+  (void)unused;
+  generate_block_hash_rows((const BlockHashJob *)arg1);
+  return 1;
+}
+
+// Computes the hash values of the block_size x block_size blocks of 'picture'
+// from the ones of the (block_size / 2) x (block_size / 2) blocks, splitting
+// the rows between the encode workers. A block_size of 2 computes the hash
+// values of the 2x2 blocks from the pixels, and src_hash and src_same are not
+// used.
+void av1_generate_block_hash_value_mt(AV1_COMP *cpi,
+                                      IntraBCHashInfo *intrabc_hash_info,
+                                      const YV12_BUFFER_CONFIG *picture,
+                                      int block_size, uint32_t *src_hash[2],
+                                      uint32_t *dst_hash[2],
+                                      int8_t *src_same[3],
+                                      int8_t *dst_same[3]) {
+  MultiThreadInfo *const mt_info = &cpi->mt_info;
+  const int num_rows = picture->y_crop_height - block_size + 1;
+  // Rows are hashed in bands of at least 16 rows per worker.
+  const int num_workers =
+      AOMMAX(AOMMIN(mt_info->num_mod_workers[MOD_ENC], num_rows / 16), 1);
+  BlockHashJob jobs[MAX_NUM_THREADS];
+  for (int i = 0; i < num_workers; i++) {
+    BlockHashJob *const job = &jobs[i];
+    job->intrabc_hash_info = intrabc_hash_info;
+    job->picture = picture;
+    job->block_size = block_size;
+    job->y_start = num_rows * i / num_workers;
+    job->y_end = num_rows * (i + 1) / num_workers;
+    job->src_hash = src_hash;
+    job->dst_hash = dst_hash;
+    job->src_same = src_same;
+    job->dst_same = dst_same;
+  }
+  if (num_workers == 1) {
+    generate_block_hash_rows(&jobs[0]);
+    return;
+  }
+
+  for (int i = num_workers - 1; i >= 0; i--) {
+    AVxWorker *const worker = &mt_info->workers[i];
+    worker->hook = block_hash_worker_hook;
+    worker->data1 = &jobs[i];
+    worker->data2 = NULL;
+  }
+  launch_workers(mt_info, num_workers);
+  sync_enc_workers(mt_info, &cpi->common, num_workers);
+}
+
+#if !CONFIG_REALTIME_ONLY
+typedef struct {
+  const AV1_COMP *cpi;
+  int block_start;
+  int block_end;
+} IntraCnnJob;
+
+static int intra_cnn_worker_hook(void *arg1, void *unused) {
+  (void)unused;
+  const IntraCnnJob *const job = (const IntraCnnJob *)arg1;
+  av1_intra_mode_cnn_predict_blocks(job->cpi, job->block_start,
+                                    job->block_end);
+  return 1;
+}
+
+// Runs the intra mode partition CNN on all the 64x64 blocks of the frame that
+// lie fully inside it, splitting the blocks between the encode workers.
+void av1_intra_mode_cnn_predict_frame_mt(AV1_COMP *cpi) {
+  MultiThreadInfo *const mt_info = &cpi->mt_info;
+  const CommonModeInfoParams *const mi_params = &cpi->common.mi_params;
+  const int num_blocks = av1_get_intra_cnn_output_rows(mi_params) *
+                         av1_get_intra_cnn_output_cols(mi_params);
+  const int num_workers =
+      AOMMAX(AOMMIN(mt_info->num_mod_workers[MOD_ENC], num_blocks), 1);
+  IntraCnnJob jobs[MAX_NUM_THREADS];
+  for (int i = 0; i < num_workers; i++) {
+    jobs[i].cpi = cpi;
+    jobs[i].block_start = num_blocks * i / num_workers;
+    jobs[i].block_end = num_blocks * (i + 1) / num_workers;
+  }
+  if (num_workers == 1) {
+    av1_intra_mode_cnn_predict_blocks(cpi, 0, num_blocks);
+    return;
+  }
+
+  for (int i = num_workers - 1; i >= 0; i--) {
+    AVxWorker *const worker = &mt_info->workers[i];
+    worker->hook = intra_cnn_worker_hook;
+    worker->data1 = &jobs[i];
+    worker->data2 = NULL;
+  }
+  launch_workers(mt_info, num_workers);
+  sync_enc_workers(mt_info, &cpi->common, num_workers);
+}
+#endif  // !CONFIG_REALTIME_ONLY
+
 // Deallocate memory for CDEF search multi-thread synchronization.
 void av1_cdef_mt_dealloc(AV1CdefSync *cdef_sync) {
   (void)cdef_sync;
@@ -2706,7 +3139,10 @@ static AOM_INLINE int compute_num_tf_workers(AV1_COMP *cpi) {
   const BLOCK_SIZE block_size = TF_BLOCK_SIZE;
   const int mb_height = block_size_high[block_size];
   const int mb_rows = get_num_blocks(frame_height, mb_height);
-  return AOMMIN(cpi->oxcf.max_threads, mb_rows);
+  // When there are fewer block rows than threads, the motion search is
+  // additionally split across the frames used for filtering.
+  const int max_tf_frames = AOMMAX(1, cpi->oxcf.algo_cfg.arnr_max_frames);
+  return AOMMIN(cpi->oxcf.max_threads, mb_rows * max_tf_frames);
 }
 
 // Computes num_workers for tpl multi-threading.
@@ -2771,3 +3207,248 @@ void av1_compute_num_workers_for_mt(AV1_COMP *cpi) {
     cpi->ppi->p_mt_info.num_mod_workers[i] =
         compute_num_mod_workers(cpi, (MULTI_THREADED_MODULES)i);
 }
+
+// Publishes the number of final rows of the frame filtered for the next
+// spatial layer.
+static void svc_layer_filter_set_rows_done(AV1SvcLayerFilter *lf,
+                                           int rows_done) {
+#if CONFIG_MULTITHREAD
+  pthread_mutex_lock(lf->mutex_);
+  lf->rows_done = rows_done;
+  pthread_cond_broadcast(lf->cond_);
+  pthread_mutex_unlock(lf->mutex_);
+#else
+  lf->rows_done = rows_done;
+#endif  // CONFIG_MULTITHREAD
+}
+
+// Applies the loop filter and CDEF to the frame one superblock row at a time,
+// and extends the borders of the rows that no later filtering changes.
+static int svc_layer_filter_hook(void *arg1, void *unused) {
+  (void)unused;
+  AV1SvcLayerFilter *const lf = (AV1SvcLayerFilter *)arg1;
+  AV1_COMMON *const cm = &lf->cm;
+  MACROBLOCKD *const xd = &lf->xd;
+  YV12_BUFFER_CONFIG *const frame = &lf->frame->buf;
+  const int num_planes = av1_num_planes(cm);
+  const int mi_rows = cm->mi_params.mi_rows;
+  const int height = frame->y_crop_height;
+  const int fb_height = MI_SIZE_64X64 * MI_SIZE;
+  const int nvfb = (mi_rows + MI_SIZE_64X64 - 1) / MI_SIZE_64X64;
+  int fbr = 0;
+  int rows_done = 0;
+
+  if (lf->do_lf) av1_loop_filter_frame_init(cm, 0, num_planes);
+  for (int mi_row = 0; mi_row < mi_rows; mi_row += MAX_MIB_SIZE) {
+    const int end_mi_row = AOMMIN(mi_row + MAX_MIB_SIZE, mi_rows);
+    int ready = height;
+    if (lf->do_lf) {
+      av1_loop_filter_frame_rows(frame, cm, xd, 0, num_planes, mi_row,
+                                 end_mi_row, lf->is_realtime);
+      // The filtering of the top edge of the next superblock row changes up
+      // to 7 rows above it.
+      if (end_mi_row < mi_rows)
+        ready = AOMMIN(end_mi_row * MI_SIZE - 8, height);
+    }
+    if (lf->use_cdef) {
+      // The loop filter moves the plane buffers.
+      av1_setup_dst_planes(xd->plane, cm->seq_params->sb_size, frame, 0, 0, 0,
+                           num_planes);
+      // CDEF of a 64x64 block row reads CDEF_VBORDER rows below it.
+      while (fbr < nvfb &&
+             (ready == height || (fbr + 1) * fb_height + 2 * CDEF_VBORDER <=
+                                     ready)) {
+        av1_cdef_fb_row(cm, xd, cm->cdef_info.linebuf, cm->cdef_info.colbuf,
+                        cm->cdef_info.srcbuf, fbr, av1_cdef_init_fb_row, NULL);
+        ++fbr;
+      }
+      ready = fbr == nvfb ? height : fbr * fb_height;
+    }
+    if (ready > rows_done) {
+      aom_extend_frame_borders_rows(frame, rows_done, ready, num_planes);
+      rows_done = ready;
+      svc_layer_filter_set_rows_done(lf, rows_done);
+    }
+  }
+  svc_layer_filter_set_rows_done(lf, INT_MAX);
+  return 1;
+}
+
+static void svc_layer_filter_alloc(AV1_COMP *cpi) {
+  AV1_COMMON *const cm = &cpi->common;
+  const AVxWorkerInterface *const winterface = aom_get_worker_interface();
+  AV1SvcLayerFilter *lf;
+
+  CHECK_MEM_ERROR(cm, lf, aom_calloc(1, sizeof(*lf)));
+  cpi->svc_layer_filter = lf;
+#if CONFIG_MULTITHREAD
+  CHECK_MEM_ERROR(cm, lf->mutex_, aom_malloc(sizeof(*lf->mutex_)));
+  pthread_mutex_init(lf->mutex_, NULL);
+  CHECK_MEM_ERROR(cm, lf->cond_, aom_malloc(sizeof(*lf->cond_)));
+  pthread_cond_init(lf->cond_, NULL);
+#endif  // CONFIG_MULTITHREAD
+  winterface->init(&lf->worker);
+  lf->worker.thread_name = "aom svc lf worker";
+  if (!winterface->reset(&lf->worker))
+    aom_internal_error(cm->error, AOM_CODEC_ERROR,
+                       "Loop filter thread creation failed");
+}
+
+// Copies the mode info of the current frame, which the filters read.
+static void svc_layer_filter_copy_mi(AV1_COMMON *const cm,
+                                     AV1SvcLayerFilter *lf) {
+  const CommonModeInfoParams *const mi_params = &cm->mi_params;
+  if (lf->mi_alloc_size < mi_params->mi_alloc_size) {
+    aom_free(lf->mi_alloc);
+    lf->mi_alloc_size = 0;
+    CHECK_MEM_ERROR(
+        cm, lf->mi_alloc,
+        aom_malloc(mi_params->mi_alloc_size * sizeof(*lf->mi_alloc)));
+    lf->mi_alloc_size = mi_params->mi_alloc_size;
+  }
+  if (lf->mi_grid_size < mi_params->mi_grid_size) {
+    aom_free(lf->mi_grid_base);
+    lf->mi_grid_size = 0;
+    CHECK_MEM_ERROR(
+        cm, lf->mi_grid_base,
+        aom_malloc(mi_params->mi_grid_size * sizeof(*lf->mi_grid_base)));
+    lf->mi_grid_size = mi_params->mi_grid_size;
+  }
+  memcpy(lf->mi_alloc, mi_params->mi_alloc,
+         mi_params->mi_alloc_size * sizeof(*lf->mi_alloc));
+  for (int i = 0; i < mi_params->mi_grid_size; ++i) {
+    MB_MODE_INFO *const mi = mi_params->mi_grid_base[i];
+    lf->mi_grid_base[i] =
+        mi != NULL ? lf->mi_alloc + (mi - mi_params->mi_alloc) : NULL;
+  }
+}
+
+void av1_svc_layer_filter_launch(AV1_COMP *cpi, int do_lf, int use_cdef,
+                                 int is_realtime) {
+  AV1_COMMON *const cm = &cpi->common;
+  av1_svc_layer_filter_finish(cpi);
+  if (cpi->svc_layer_filter == NULL) svc_layer_filter_alloc(cpi);
+  AV1SvcLayerFilter *const lf = cpi->svc_layer_filter;
+
+  // Keep the CDEF buffers of the worker, which are sized for the frame below.
+  const CdefInfo cdef_info = lf->cm.cdef_info;
+  lf->cm = *cm;
+  CdefInfo *const lf_cdef_info = &lf->cm.cdef_info;
+  av1_copy(lf_cdef_info->colbuf, cdef_info.colbuf);
+  av1_copy(lf_cdef_info->linebuf, cdef_info.linebuf);
+  lf_cdef_info->srcbuf = cdef_info.srcbuf;
+  av1_copy(lf_cdef_info->allocated_colbuf_size,
+           cdef_info.allocated_colbuf_size);
+  av1_copy(lf_cdef_info->allocated_linebuf_size,
+           cdef_info.allocated_linebuf_size);
+  lf_cdef_info->allocated_srcbuf_size = cdef_info.allocated_srcbuf_size;
+  lf_cdef_info->allocated_mi_rows = cdef_info.allocated_mi_rows;
+  lf_cdef_info->allocated_num_workers = cdef_info.allocated_num_workers;
+  if (use_cdef) {
+    AV1CdefWorkerData *cdef_worker = NULL;
+    AV1CdefSync cdef_sync;
+    av1_zero(cdef_sync);
+    av1_alloc_cdef_buffers(&lf->cm, &cdef_worker, &cdef_sync, 1, 1);
+  }
+
+  svc_layer_filter_copy_mi(cm, lf);
+  lf->cm.mi_params.mi_alloc = lf->mi_alloc;
+  lf->cm.mi_params.mi_grid_base = lf->mi_grid_base;
+  lf->cm.mi_params.tx_type_map = NULL;
+  lf->xd = cpi->td.mb.e_mbd;
+
+  lf->frame = cm->cur_frame;
+  ++lf->frame->ref_count;
+  lf->spatial_layer_id = cpi->svc.spatial_layer_id;
+  lf->do_lf = do_lf;
+  lf->use_cdef = use_cdef;
+  lf->is_realtime = is_realtime;
+  lf->rows_done = 0;
+  lf->row_sync = 0;
+
+  lf->worker.hook = svc_layer_filter_hook;
+  lf->worker.data1 = lf;
+  lf->worker.data2 = NULL;
+  aom_get_worker_interface()->launch(&lf->worker);
+}
+
+void av1_svc_layer_filter_setup_frame(AV1_COMP *cpi) {
+  const AV1_COMMON *const cm = &cpi->common;
+  const SVC *const svc = &cpi->svc;
+  AV1SvcLayerFilter *const lf = cpi->svc_layer_filter;
+  if (lf == NULL || lf->frame == NULL) return;
+
+  // The frame below is only read as a zero motion scaled reference, which
+  // the prediction of a superblock row reads around its co-located rows.
+  int row_sync = svc->spatial_layer_id == lf->spatial_layer_id + 1 &&
+                 cpi->sf.rt_sf.use_nonrd_pick_mode &&
+                 !cpi->sf.rt_sf.use_comp_ref_nonrd;
+  if (row_sync && !frame_is_intra_only(cm)) {
+    const int is_scaled = lf->frame->buf.y_crop_width != cm->width ||
+                          lf->frame->buf.y_crop_height != cm->height;
+    for (int ref = LAST_FRAME; ref <= ALTREF_FRAME; ++ref) {
+      if (get_ref_frame_buf(cm, ref) != lf->frame ||
+          !(cpi->ref_frame_flags & av1_ref_frame_flag_list[ref]))
+        continue;
+      if (!is_scaled ||
+          !((ref == LAST_FRAME && svc->skip_mvsearch_last) ||
+            (ref == GOLDEN_FRAME && svc->skip_mvsearch_gf)))
+        row_sync = 0;
+    }
+  }
+  if (row_sync)
+    lf->row_sync = 1;
+  else
+    av1_svc_layer_filter_finish(cpi);
+}
+
+void av1_svc_layer_filter_wait(AV1_COMP *cpi, int end_mi_row) {
+  const AV1SvcLayerFilter *const lf = cpi->svc_layer_filter;
+  if (lf == NULL || !lf->row_sync) return;
+#if CONFIG_MULTITHREAD
+  const AV1_COMMON *const cm = &cpi->common;
+  // Co-located rows of the frame below, with a margin for the interpolation
+  // filter taps and the motion vector of the inter-layer prediction.
+  const int needed =
+      (int)(((int64_t)end_mi_row * MI_SIZE * lf->frame->buf.y_crop_height +
+             cm->height - 1) /
+            cm->height) +
+      16;
+  pthread_mutex_lock(lf->mutex_);
+  while (lf->rows_done < needed) pthread_cond_wait(lf->cond_, lf->mutex_);
+  pthread_mutex_unlock(lf->mutex_);
+#else
+  (void)end_mi_row;
+#endif  // CONFIG_MULTITHREAD
+}
+
+void av1_svc_layer_filter_finish(AV1_COMP *cpi) {
+  AV1SvcLayerFilter *const lf = cpi->svc_layer_filter;
+  if (lf == NULL || lf->frame == NULL) return;
+  aom_get_worker_interface()->sync(&lf->worker);
+  --lf->frame->ref_count;
+  lf->frame = NULL;
+  lf->row_sync = 0;
+}
+
+void av1_svc_layer_filter_dealloc(AV1SvcLayerFilter *lf) {
+  if (lf == NULL) return;
+  aom_get_worker_interface()->end(&lf->worker);
+#if CONFIG_MULTITHREAD
+  if (lf->mutex_ != NULL) {
+    pthread_mutex_destroy(lf->mutex_);
+    aom_free(lf->mutex_);
+  }
+  if (lf->cond_ != NULL) {
+    pthread_cond_destroy(lf->cond_);
+    aom_free(lf->cond_);
+  }
+#endif  // CONFIG_MULTITHREAD
+  AV1CdefWorkerData *cdef_worker = NULL;
+  AV1CdefSync cdef_sync;
+  av1_zero(cdef_sync);
+  av1_free_cdef_buffers(&lf->cm, &cdef_worker, &cdef_sync, 1);
+  aom_free(lf->mi_alloc);
+  aom_free(lf->mi_grid_base);
+  aom_free(lf);
+}
@@ -77,6 +77,12 @@ void av1_tf_do_filtering_mt(AV1_COMP *cpi);
 
 void av1_tf_mt_dealloc(AV1TemporalFilterSync *tf_sync);
 
+void av1_tf_ms_sync_read(AV1TemporalFilterSync *tf_sync, int num_frames,
+                         int mb_row, int frame, int mb_col);
+
+void av1_tf_ms_sync_write(AV1TemporalFilterSync *tf_sync, int num_frames,
+                          int mb_row, int frame, int mb_col);
+
 void av1_compute_num_workers_for_mt(AV1_COMP *cpi);
 
 int av1_get_max_num_workers(AV1_COMP *cpi);
@@ -100,6 +106,18 @@ int av1_get_num_mod_workers_for_alloc(PrimaryMultiThreadInfo *const p_mt_info,
 
 void av1_init_tile_thread_data(AV1_PRIMARY *ppi, int is_first_pass);
 
+void av1_generate_block_hash_value_mt(AV1_COMP *cpi,
+                                      IntraBCHashInfo *intrabc_hash_info,
+                                      const YV12_BUFFER_CONFIG *picture,
+                                      int block_size, uint32_t *src_hash[2],
+                                      uint32_t *dst_hash[2],
+                                      int8_t *src_same[3],
+                                      int8_t *dst_same[3]);
+
+#if !CONFIG_REALTIME_ONLY
+void av1_intra_mode_cnn_predict_frame_mt(AV1_COMP *cpi);
+#endif  // !CONFIG_REALTIME_ONLY
+
 void av1_cdef_mse_calc_frame_mt(AV1_COMMON *cm, MultiThreadInfo *mt_info,
                                 CdefSearchCtx *cdef_search_ctx);
 
@@ -114,6 +132,24 @@ void av1_write_tile_obu_mt(
 
 int av1_compute_num_enc_workers(AV1_COMP *cpi, int max_workers);
 
+// Starts the loop filter, CDEF and the border extension of the current frame
+// on the worker thread of cpi->svc_layer_filter.
+void av1_svc_layer_filter_launch(AV1_COMP *cpi, int do_lf, int use_cdef,
+                                 int is_realtime);
+
+// Decides whether the encode of the current frame overlaps the pending
+// filtering of the spatial layer below, and otherwise finishes it.
+void av1_svc_layer_filter_setup_frame(AV1_COMP *cpi);
+
+// Waits until the frame of the spatial layer below is ready for the encode of
+// the superblock rows above end_mi_row.
+void av1_svc_layer_filter_wait(AV1_COMP *cpi, int end_mi_row);
+
+// Waits for the pending filtering to finish and releases its frame.
+void av1_svc_layer_filter_finish(AV1_COMP *cpi);
+
+void av1_svc_layer_filter_dealloc(AV1SvcLayerFilter *lf);
+
 #if CONFIG_FRAME_PARALLEL_ENCODE
 int av1_compute_num_fp_contexts(AV1_PRIMARY *ppi, AV1EncoderConfig *oxcf);
 
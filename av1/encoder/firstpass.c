@@ -162,6 +162,16 @@ static int get_unit_cols(const BLOCK_SIZE fp_block_size, const int mb_cols) {
   return mb_cols << (mb_width_mi_log2 - width_mi_log2);
 }
 
+// Returns the number of 16x16 MBs the first pass stats are normalized to. When
+// the first pass runs on a resized or downscaled frame, this is the MB count of
+// the full resolution frame.
+static int get_num_mbs_16x16(const AV1_COMP *cpi) {
+  if (cpi->oxcf.resize_cfg.resize_mode != RESIZE_NONE ||
+      is_firstpass_downscaled(cpi))
+    return cpi->initial_mbs;
+  return cpi->common.mi_params.MBs;
+}
+
 // TODO(chengchen): can we simplify it even if resize has to be considered?
 static int get_num_mbs(const BLOCK_SIZE fp_block_size,
                        const int num_mbs_16X16) {
@@ -266,7 +276,9 @@ static AOM_INLINE void first_pass_motion_search(AV1_COMP *cpi, MACROBLOCK *x,
   int tmp_err;
   const BLOCK_SIZE bsize = xd->mi[0]->bsize;
   const int new_mv_mode_penalty = NEW_MV_MODE_PENALTY;
-  const int sr = get_search_range(&cpi->initial_dimensions);
+  // A downscaled first pass only needs half the full resolution search range.
+  const int sr = get_search_range(&cpi->initial_dimensions) +
+                 is_firstpass_downscaled(cpi);
   const int step_param = cpi->sf.fp_sf.reduce_mv_step_param + sr;
 
   const search_site_config *first_pass_search_sites =
@@ -297,6 +309,43 @@ static AOM_INLINE void first_pass_motion_search(AV1_COMP *cpi, MACROBLOCK *x,
   }
 }
 
+// Refines a full-pel motion vector to half-pel precision. On the 2x decimated
+// source a half-pel step corresponds to a full-pel step at full resolution, so
+// this keeps the motion error comparable to a full resolution first pass.
+// best_mv may be NULL when only the error is needed.
+static AOM_INLINE void first_pass_half_pel_refine(AV1_COMP *cpi, MACROBLOCK *x,
+                                                  const FULLPEL_MV full_mv,
+                                                  MV *best_mv,
+                                                  int *best_motion_err) {
+  MACROBLOCKD *const xd = &x->e_mbd;
+  const BLOCK_SIZE bsize = xd->mi[0]->bsize;
+  const aom_variance_fn_ptr_t *v_fn_ptr = &cpi->ppi->fn_ptr[bsize];
+  const struct buf_2d *const src = &x->plane[0].src;
+  const struct buf_2d *const ref = &xd->plane[0].pre[0];
+  const MV center_mv = get_mv_from_fullmv(&full_mv);
+  // MVs are in 1/8 pel units.
+  const int half_pel = 4;
+
+  for (int dr = -1; dr <= 1; ++dr) {
+    for (int dc = -1; dc <= 1; ++dc) {
+      if (dr == 0 && dc == 0) continue;
+      const MV this_mv = { center_mv.row + dr * half_pel,
+                           center_mv.col + dc * half_pel };
+      const uint8_t *const ref_buf = ref->buf +
+                                     (this_mv.row >> 3) * ref->stride +
+                                     (this_mv.col >> 3);
+      unsigned int sse;
+      v_fn_ptr->svf(ref_buf, ref->stride, this_mv.col & 7, this_mv.row & 7,
+                    src->buf, src->stride, &sse);
+      const int this_err = (int)sse + NEW_MV_MODE_PENALTY;
+      if (this_err < *best_motion_err) {
+        *best_motion_err = this_err;
+        if (best_mv != NULL) *best_mv = this_mv;
+      }
+    }
+  }
+}
+
 static BLOCK_SIZE get_bsize(const CommonModeInfoParams *const mi_params,
                             const BLOCK_SIZE fp_block_size, const int unit_row,
                             const int unit_col) {
@@ -690,6 +739,7 @@ static int firstpass_inter_prediction(
   const int unit_cols = get_unit_cols(fp_block_size, mi_params->mb_cols);
   // Assume 0,0 motion with no mv overhead.
   FULLPEL_MV mv = kZeroFullMv;
+  MV best_subpel_mv = kZeroMv;
   xd->plane[0].pre[0].buf = last_frame->y_buffer + recon_yoffset;
   // Set up limit values for motion vectors to prevent them extending
   // outside the UMV borders.
@@ -704,13 +754,12 @@ static int firstpass_inter_prediction(
   // Compute the motion error of the 0,0 motion using the last source
   // frame as the reference. Skip the further motion search on
   // reconstructed frame if this error is small.
-  struct buf_2d unscaled_last_source_buf_2d;
-  unscaled_last_source_buf_2d.buf =
-      cpi->unscaled_last_source->y_buffer + src_yoffset;
-  unscaled_last_source_buf_2d.stride = cpi->unscaled_last_source->y_stride;
-  const int raw_motion_error = get_prediction_error_bitdepth(
-      is_high_bitdepth, bitdepth, bsize, &x->plane[0].src,
-      &unscaled_last_source_buf_2d);
+  struct buf_2d last_source_buf_2d;
+  last_source_buf_2d.buf = cpi->last_source->y_buffer + src_yoffset;
+  last_source_buf_2d.stride = cpi->last_source->y_stride;
+  const int raw_motion_error =
+      get_prediction_error_bitdepth(is_high_bitdepth, bitdepth, bsize,
+                                    &x->plane[0].src, &last_source_buf_2d);
   raw_motion_err_list[raw_motion_err_counts] = raw_motion_error;
   const FIRST_PASS_SPEED_FEATURES *const fp_sf = &cpi->sf.fp_sf;
 
@@ -732,6 +781,11 @@ static int firstpass_inter_prediction(
       }
     }
 
+    best_subpel_mv = get_mv_from_fullmv(&mv);
+    if (is_firstpass_downscaled(cpi)) {
+      first_pass_half_pel_refine(cpi, x, mv, &best_subpel_mv, &motion_error);
+    }
+
     // Motion search in 2nd reference frame.
     int gf_motion_error = motion_error;
     if ((current_frame->frame_number > 1) && golden_frame != NULL) {
@@ -743,6 +797,9 @@ static int firstpass_inter_prediction(
           get_prediction_error_bitdepth(is_high_bitdepth, bitdepth, bsize,
                                         &x->plane[0].src, &xd->plane[0].pre[0]);
       first_pass_motion_search(cpi, x, &kZeroMv, &tmp_mv, &gf_motion_error);
+      if (is_firstpass_downscaled(cpi)) {
+        first_pass_half_pel_refine(cpi, x, tmp_mv, NULL, &gf_motion_error);
+      }
     }
     if (gf_motion_error < motion_error && gf_motion_error < this_intra_error) {
       ++stats->second_ref_count;
@@ -785,7 +842,7 @@ static int firstpass_inter_prediction(
           (double)motion_error / DOUBLE_DIVIDE_CHECK((double)this_intra_error);
     }
 
-    *best_mv = get_mv_from_fullmv(&mv);
+    *best_mv = best_subpel_mv;
     this_inter_error = motion_error;
     xd->mi[0]->mode = NEWMV;
     xd->mi[0]->mv[0].as_mv = *best_mv;
@@ -856,7 +913,6 @@ static void update_firstpass_stats(AV1_COMP *cpi,
                                    const BLOCK_SIZE fp_block_size) {
   TWO_PASS *twopass = &cpi->ppi->twopass;
   AV1_COMMON *const cm = &cpi->common;
-  const CommonModeInfoParams *const mi_params = &cm->mi_params;
   FIRSTPASS_STATS *this_frame_stats = twopass->stats_buf_ctx->stats_in_end;
   FIRSTPASS_STATS fps;
   // The minimum error here insures some bit allocation to frames even
@@ -864,9 +920,7 @@ static void update_firstpass_stats(AV1_COMP *cpi,
   // where the typical "real" energy per MB also falls.
   // Initial estimate here uses sqrt(mbs) to define the min_err, where the
   // number of mbs is proportional to the image area.
-  const int num_mbs_16X16 = (cpi->oxcf.resize_cfg.resize_mode != RESIZE_NONE)
-                                ? cpi->initial_mbs
-                                : mi_params->MBs;
+  const int num_mbs_16X16 = get_num_mbs_16x16(cpi);
   // Number of actual units used in the first pass, it can be other square
   // block sizes than 16X16.
   const int num_mbs = get_num_mbs(fp_block_size, num_mbs_16X16);
@@ -921,7 +975,13 @@ static void update_firstpass_stats(AV1_COMP *cpi,
   // cpi->source_time_stamp.
   fps.duration = (double)ts_duration;
 
-  normalize_firstpass_stats(&fps, num_mbs_16X16, cm->width, cm->height);
+  // MVs of a downscaled first pass have already been scaled to full resolution
+  // units, so normalize them with the full resolution dimensions.
+  const int frame_width =
+      is_firstpass_downscaled(cpi) ? cpi->oxcf.frm_dim_cfg.width : cm->width;
+  const int frame_height =
+      is_firstpass_downscaled(cpi) ? cpi->oxcf.frm_dim_cfg.height : cm->height;
+  normalize_firstpass_stats(&fps, num_mbs_16X16, frame_width, frame_height);
 
   // We will store the stats inside the persistent twopass struct (and NOT the
   // local variable 'fps'), and then cpi->output_pkt_list will point to it.
@@ -1001,6 +1061,85 @@ static FRAME_STATS accumulate_frame_stats(FRAME_STATS *mb_stats, int mb_rows,
   return stats;
 }
 
+// Returns the mean squared error per pixel of predicting every 4x4 luma block
+// of every other 4x4 block row from the DC of its source neighbors, a cheap
+// estimate of the first pass intra error that can be evaluated at any
+// resolution.
+static double get_dc_pred_error_per_pixel(const YV12_BUFFER_CONFIG *buf) {
+  const int hbd = buf->flags & YV12_FLAG_HIGHBITDEPTH;
+  const int stride = buf->y_stride;
+  const uint8_t *const buf8 = buf->y_buffer;
+  const uint16_t *const buf16 = CONVERT_TO_SHORTPTR(buf->y_buffer);
+  int64_t sse = 0;
+  int64_t count = 0;
+  for (int r = 4; r + 4 <= buf->y_crop_height; r += 8) {
+    for (int c = 4; c + 4 <= buf->y_crop_width; c += 4) {
+      const int offset = r * stride + c;
+      int dc = 0;
+      for (int i = 0; i < 4; ++i) {
+        dc += hbd ? buf16[offset - stride + i] + buf16[offset + i * stride - 1]
+                  : buf8[offset - stride + i] + buf8[offset + i * stride - 1];
+      }
+      dc = (dc + 4) >> 3;
+      for (int i = 0; i < 4; ++i) {
+        for (int j = 0; j < 4; ++j) {
+          const int pos = offset + i * stride + j;
+          const int diff = (hbd ? buf16[pos] : buf8[pos]) - dc;
+          sse += diff * diff;
+        }
+      }
+      count += 16;
+    }
+  }
+  return count > 0 ? (double)sse / count : 0.0;
+}
+
+// Scales the stats of a first pass run on the 2x decimated source so that they
+// describe the full resolution frame. area_scale is the number of full
+// resolution units covered by every downscaled unit, and MVs are twice as long
+// at full resolution. The intra prediction error per pixel grows as the
+// source gets decimated, by an amount that depends on the content, so the
+// intra error is further scaled by intra_scale, the ratio of the per pixel
+// intra errors of the full resolution and the downscaled sources. The intra
+// mode penalty is added per unit and is only scaled by the area.
+static void scale_downscaled_frame_stats(FRAME_STATS *stats, int num_units,
+                                         double area_scale, double intra_scale,
+                                         int intra_only) {
+  const int row_scale = 2;
+  const int mv_scale = 2;
+  const double penalty = (double)INTRA_MODE_PENALTY * num_units;
+  stats->intra_error = (int64_t)(
+      (AOMMAX(stats->intra_error - penalty, 0) * intra_scale + penalty) *
+      area_scale);
+  stats->frame_avg_wavelet_energy =
+      (int64_t)(stats->frame_avg_wavelet_energy * area_scale);
+  if (intra_only) {
+    stats->coded_error = stats->intra_error;
+    stats->sr_coded_error = stats->intra_error;
+  } else {
+    stats->coded_error = (int64_t)(stats->coded_error * area_scale);
+    stats->sr_coded_error = (int64_t)(stats->sr_coded_error * area_scale);
+  }
+  stats->mv_count = (int)lround(stats->mv_count * area_scale);
+  stats->inter_count = (int)lround(stats->inter_count * area_scale);
+  stats->second_ref_count = (int)lround(stats->second_ref_count * area_scale);
+  stats->neutral_count *= area_scale;
+  stats->intra_skip_count = (int)lround(stats->intra_skip_count * area_scale);
+  stats->image_data_start_row *= row_scale;
+  stats->new_mv_count = (int)lround(stats->new_mv_count * area_scale);
+  stats->sum_in_vectors = (int)lround(stats->sum_in_vectors * area_scale);
+  stats->sum_mvr = (int)lround(stats->sum_mvr * area_scale * mv_scale);
+  stats->sum_mvc = (int)lround(stats->sum_mvc * area_scale * mv_scale);
+  stats->sum_mvr_abs = (int)lround(stats->sum_mvr_abs * area_scale * mv_scale);
+  stats->sum_mvc_abs = (int)lround(stats->sum_mvc_abs * area_scale * mv_scale);
+  stats->sum_mvrs =
+      (int64_t)(stats->sum_mvrs * area_scale * mv_scale * mv_scale);
+  stats->sum_mvcs =
+      (int64_t)(stats->sum_mvcs * area_scale * mv_scale * mv_scale);
+  stats->intra_factor *= area_scale;
+  stats->brightness_factor *= area_scale;
+}
+
 static void setup_firstpass_data(AV1_COMMON *const cm,
                                  FirstPassData *firstpass_data,
                                  const int unit_rows, const int unit_cols) {
@@ -1225,6 +1364,26 @@ void av1_first_pass(AV1_COMP *cpi, const int64_t ts_duration) {
   // Prepare the speed features
   av1_set_speed_features_framesize_independent(cpi, cpi->oxcf.speed);
 
+  // The frame size has to be set up before the unit counts are derived from
+  // mi_params, as a downscaled first pass changes them.
+  av1_setup_frame_size(cpi);
+  av1_set_mv_search_params(cpi);
+
+  if (is_firstpass_downscaled(cpi)) {
+    cpi->source = av1_realloc_and_scale_if_required(
+        cm, cpi->unscaled_source, &cpi->scaled_source, EIGHTTAP_SMOOTH, 8,
+        true, false, cpi->oxcf.border_in_pixels,
+        cpi->oxcf.tool_cfg.enable_global_motion);
+    if (cpi->unscaled_last_source != NULL) {
+      cpi->last_source = av1_realloc_and_scale_if_required(
+          cm, cpi->unscaled_last_source, &cpi->scaled_last_source,
+          EIGHTTAP_SMOOTH, 8, true, false, cpi->oxcf.border_in_pixels,
+          cpi->oxcf.tool_cfg.enable_global_motion);
+    }
+  } else {
+    cpi->last_source = cpi->unscaled_last_source;
+  }
+
   // Unit size for the first pass encoding.
   const BLOCK_SIZE fp_block_size =
       get_fp_block_size(cpi->is_screen_content_type);
@@ -1263,9 +1422,6 @@ void av1_first_pass(AV1_COMP *cpi, const int64_t ts_duration) {
   assert(this_frame != NULL);
   assert(frame_is_intra_only(cm) || (last_frame != NULL));
 
-  av1_setup_frame_size(cpi);
-  av1_set_mv_search_params(cpi);
-
   set_mi_offsets(mi_params, xd, 0, 0);
   xd->mi[0]->bsize = fp_block_size;
 
@@ -1330,12 +1486,22 @@ void av1_first_pass(AV1_COMP *cpi, const int64_t ts_duration) {
   }
 
   TWO_PASS *twopass = &cpi->ppi->twopass;
-  const int num_mbs_16X16 = (cpi->oxcf.resize_cfg.resize_mode != RESIZE_NONE)
-                                ? cpi->initial_mbs
-                                : mi_params->MBs;
+  const int num_mbs_16X16 = get_num_mbs_16x16(cpi);
   // Number of actual units used in the first pass, it can be other square
   // block sizes than 16X16.
   const int num_mbs = get_num_mbs(fp_block_size, num_mbs_16X16);
+  if (is_firstpass_downscaled(cpi)) {
+    const int num_units = unit_rows * unit_cols;
+    const double half_res_error = get_dc_pred_error_per_pixel(cpi->source);
+    const double intra_scale =
+        half_res_error > 0.0
+            ? get_dc_pred_error_per_pixel(cpi->unscaled_source) /
+                  half_res_error
+            : 1.0;
+    scale_downscaled_frame_stats(&stats, num_units,
+                                 (double)num_mbs / num_units, intra_scale,
+                                 frame_is_intra_only(cm));
+  }
   stats.intra_factor = stats.intra_factor / (double)num_mbs;
   stats.brightness_factor = stats.brightness_factor / (double)num_mbs;
   FIRSTPASS_STATS *this_frame_stats = twopass->stats_buf_ctx->stats_in_end;
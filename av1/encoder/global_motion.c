@@ -418,18 +418,43 @@ void av1_compute_feature_segmentation_map(uint8_t *segment_map, int width,
     memset(segment_map, 1, width * height * sizeof(*segment_map));
 }
 
+int av1_compute_global_motion_from_correspondences(
+    TransformationType type, int *correspondences, int num_correspondences,
+    int *num_inliers_by_motion, MotionModel *params_by_motion,
+    int num_motions) {
+  int i;
+  RansacFunc ransac = av1_get_ransac_type(type);
+
+  ransac(correspondences, num_correspondences, num_inliers_by_motion,
+         params_by_motion, num_motions);
+
+  // Set num_inliers = 0 for motions with too few inliers so they are ignored.
+  for (i = 0; i < num_motions; ++i) {
+    if (num_inliers_by_motion[i] < MIN_INLIER_PROB * num_correspondences ||
+        num_correspondences == 0) {
+      num_inliers_by_motion[i] = 0;
+    } else {
+      get_inliers_from_indices(&params_by_motion[i], correspondences);
+    }
+  }
+
+  // Return true if any one of the motions has inliers.
+  for (i = 0; i < num_motions; ++i) {
+    if (num_inliers_by_motion[i] > 0) return 1;
+  }
+  return 0;
+}
+
 static int compute_global_motion_feature_based(
     TransformationType type, unsigned char *src_buffer, int src_width,
     int src_height, int src_stride, int *src_corners, int num_src_corners,
     YV12_BUFFER_CONFIG *ref, int bit_depth, int *num_inliers_by_motion,
     MotionModel *params_by_motion, int num_motions) {
-  int i;
   int num_ref_corners;
   int num_correspondences;
   int *correspondences;
   int ref_corners[2 * MAX_CORNERS];
   unsigned char *ref_buffer = ref->y_buffer;
-  RansacFunc ransac = av1_get_ransac_type(type);
 
   if (ref->flags & YV12_FLAG_HIGHBITDEPTH) {
     ref_buffer = av1_downconvert_frame(ref, bit_depth);
@@ -447,26 +472,12 @@ static int compute_global_motion_feature_based(
       (int *)ref_corners, num_ref_corners, src_width, src_height, src_stride,
       ref->y_stride, correspondences);
 
-  ransac(correspondences, num_correspondences, num_inliers_by_motion,
-         params_by_motion, num_motions);
-
-  // Set num_inliers = 0 for motions with too few inliers so they are ignored.
-  for (i = 0; i < num_motions; ++i) {
-    if (num_inliers_by_motion[i] < MIN_INLIER_PROB * num_correspondences ||
-        num_correspondences == 0) {
-      num_inliers_by_motion[i] = 0;
-    } else {
-      get_inliers_from_indices(&params_by_motion[i], correspondences);
-    }
-  }
+  const int ret = av1_compute_global_motion_from_correspondences(
+      type, correspondences, num_correspondences, num_inliers_by_motion,
+      params_by_motion, num_motions);
 
   free(correspondences);
-
-  // Return true if any one of the motions has inliers.
-  for (i = 0; i < num_motions; ++i) {
-    if (num_inliers_by_motion[i] > 0) return 1;
-  }
-  return 0;
+  return ret;
 }
 
 // Don't use points around the frame border since they are less reliable
@@ -27,6 +27,11 @@ extern "C" {
 #define RANSAC_NUM_MOTIONS 1
 #define GM_REFINEMENT_COUNT 5
 #define MAX_DIRECTIONS 2
+// Maximum number of jobs the source frame corners are split into when matching
+// them with the corners of a reference frame in multi-threading.
+#define MAX_GM_MATCH_JOBS 32
+// Minimum number of source frame corners matched by such a job.
+#define GM_MIN_CORNERS_PER_MATCH_JOB 16
 
 typedef enum {
   GLOBAL_MOTION_FEATURE_BASED,
@@ -41,6 +46,16 @@ typedef struct {
   int num_inliers;
 } MotionModel;
 
+// FAST corners of a reference frame, kept with its frame buffer so that they
+// are detected once for all the frames using it as a reference.
+typedef struct GlobalMotionCorners {
+  int corners[2 * MAX_CORNERS];
+  int num_corners;
+  // Set once the corners are detected, reset when the frame buffer is assigned
+  // to a new frame.
+  int valid;
+} GlobalMotionCorners;
+
 // The structure holds a valid reference frame type and its temporal distance
 // from the source frame.
 typedef struct {
@@ -59,10 +74,23 @@ typedef struct {
 } GlobalMotionThreadData;
 
 typedef struct {
-  // Holds the mapping of each thread to past/future direction.
-  // thread_id_to_dir[i] indicates the direction id (past - 0/future - 1)
-  // assigned to the ith thread.
-  int8_t thread_id_to_dir[MAX_NUM_THREADS];
+  // Reference frames searched in the current round and their count. A round
+  // holds all the reference frames, or the next one in each direction when
+  // the speed feature 'prune_ref_frame_for_gm_search' is set.
+  FrameDistPair round_frames[INTER_REFS_PER_FRAME];
+  int8_t round_dir[INTER_REFS_PER_FRAME];
+  int8_t num_round_frames;
+
+  // Index of the first reference frame of the round with the same frame
+  // buffer, whose corners are used for the i-th reference frame.
+  int8_t round_corners_idx[INTER_REFS_PER_FRAME];
+
+  // Number of blocks of source frame corners matched per job, for each
+  // reference frame of the round.
+  int8_t num_match_jobs_per_frame;
+
+  // Index of the next job in the current stage of the round.
+  int next_job;
 
   // A flag which holds the early exit status based on the speed feature
   // 'prune_ref_frame_for_gm_search'. early_exit[i] will be set if the speed
@@ -83,6 +111,17 @@ typedef struct {
   // thread_data[i] stores the thread specific data for worker 'i'.
   GlobalMotionThreadData *thread_data;
 
+  // FAST corners of the i-th reference frame of the round, and their matches
+  // with the corners of the source frame, stored as (x, y, rx, ry).
+  int *ref_corners[INTER_REFS_PER_FRAME];
+  int num_ref_corners[INTER_REFS_PER_FRAME];
+  int *correspondences[INTER_REFS_PER_FRAME];
+  int num_correspondences[INTER_REFS_PER_FRAME];
+
+  // Number of matches found by each job of the i-th reference frame. The
+  // matches of job j start at correspondences[i] + 4 * (first corner of j).
+  int num_job_matches[INTER_REFS_PER_FRAME][MAX_GM_MATCH_JOBS];
+
 #if CONFIG_MULTITHREAD
   // Mutex lock used while dispatching jobs.
   pthread_mutex_t *mutex_;
@@ -152,6 +191,14 @@ int av1_compute_global_motion(TransformationType type,
                               GlobalMotionEstimationType gm_estimation_type,
                               int *num_inliers_by_motion,
                               MotionModel *params_by_motion, int num_motions);
+
+// Same as av1_compute_global_motion() with GLOBAL_MOTION_FEATURE_BASED, for
+// the "num_correspondences" feature point matches already found between the
+// two frames, stored as (x, y, rx, ry) in "correspondences".
+int av1_compute_global_motion_from_correspondences(
+    TransformationType type, int *correspondences, int num_correspondences,
+    int *num_inliers_by_motion, MotionModel *params_by_motion,
+    int num_motions);
 #ifdef __cplusplus
 }  // extern "C"
 #endif
@@ -12,6 +12,7 @@
 #include "aom_dsp/binary_codes_writer.h"
 
 #include "av1/encoder/corner_detect.h"
+#include "av1/encoder/corner_match.h"
 #include "av1/encoder/encoder.h"
 #include "av1/encoder/ethread.h"
 #include "av1/encoder/rdopt.h"
@@ -75,10 +76,13 @@ static AOM_INLINE int64_t calc_erroradv_threshold(int64_t ref_frame_error) {
 }
 
 // For the given reference frame, computes the global motion parameters for
-// different motion models and finds the best.
+// different motion models and finds the best. The feature matches of the
+// source and reference frames are found here unless correspondences is
+// non-NULL.
 static AOM_INLINE void compute_global_motion_for_ref_frame(
     AV1_COMP *cpi, YV12_BUFFER_CONFIG *ref_buf[REF_FRAMES], int frame,
     int num_src_corners, int *src_corners, unsigned char *src_buffer,
+    int *correspondences, int num_correspondences,
     MotionModel *params_by_motion, uint8_t *segment_map,
     const int segment_map_w, const int segment_map_h,
     const WarpedMotionParams *ref_params) {
@@ -121,11 +125,18 @@ static AOM_INLINE void compute_global_motion_for_ref_frame(
       params_by_motion[i].num_inliers = 0;
     }
 
-    av1_compute_global_motion(model, src_buffer, src_width, src_height,
-                              src_stride, src_corners, num_src_corners,
-                              ref_buf[frame], cpi->common.seq_params->bit_depth,
-                              gm_estimation_type, inliers_by_motion,
-                              params_by_motion, RANSAC_NUM_MOTIONS);
+    if (correspondences != NULL &&
+        gm_estimation_type == GLOBAL_MOTION_FEATURE_BASED) {
+      av1_compute_global_motion_from_correspondences(
+          model, correspondences, num_correspondences, inliers_by_motion,
+          params_by_motion, RANSAC_NUM_MOTIONS);
+    } else {
+      av1_compute_global_motion(
+          model, src_buffer, src_width, src_height, src_stride, src_corners,
+          num_src_corners, ref_buf[frame], cpi->common.seq_params->bit_depth,
+          gm_estimation_type, inliers_by_motion, params_by_motion,
+          RANSAC_NUM_MOTIONS);
+    }
     int64_t ref_frame_error = 0;
     for (i = 0; i < RANSAC_NUM_MOTIONS; ++i) {
       if (inliers_by_motion[i] == 0) continue;
@@ -196,10 +207,82 @@ static AOM_INLINE void compute_global_motion_for_ref_frame(
   }
 }
 
+// Returns 1 if the FAST corners of the reference frames are kept with their
+// frame buffers. Frames encoded in parallel share their reference frames, and
+// detect the corners themselves.
+static AOM_INLINE int use_gm_ref_corner_cache(const AV1_COMP *cpi) {
+#if CONFIG_FRAME_PARALLEL_ENCODE
+  return cpi->ppi->gf_group.frame_parallel_level[cpi->gf_frame_index] == 0;
+#else
+  (void)cpi;
+  return 1;
+#endif  // CONFIG_FRAME_PARALLEL_ENCODE
+}
+
+// Allocates the corner cache of the given reference frame. This must be done
+// before av1_get_gm_ref_corners() is called from worker threads.
+void av1_alloc_gm_ref_corners(AV1_COMP *cpi, int frame) {
+  AV1_COMMON *const cm = &cpi->common;
+  RefCntBuffer *const buf = get_ref_frame_buf(cm, frame);
+  if (!use_gm_ref_corner_cache(cpi) || buf->gm_corners != NULL) return;
+  CHECK_MEM_ERROR(cm, buf->gm_corners, aom_malloc(sizeof(*buf->gm_corners)));
+  buf->gm_corners->valid = 0;
+}
+
+// Copies the FAST corners of the given reference frame to 'corners' and
+// returns their count. The corners are detected only the first time the frame
+// is used as a reference.
+int av1_get_gm_ref_corners(AV1_COMP *cpi, int frame, int *corners) {
+  RefCntBuffer *const buf = get_ref_frame_buf(&cpi->common, frame);
+  GlobalMotionCorners *const cache =
+      use_gm_ref_corner_cache(cpi) ? buf->gm_corners : NULL;
+  if (cache != NULL && cache->valid) {
+    memcpy(corners, cache->corners,
+           sizeof(*corners) * 2 * cache->num_corners);
+    return cache->num_corners;
+  }
+
+  YV12_BUFFER_CONFIG *const ref = &buf->buf;
+  unsigned char *ref_buffer = ref->y_buffer;
+  if (ref->flags & YV12_FLAG_HIGHBITDEPTH) {
+    ref_buffer = av1_downconvert_frame(ref, cpi->common.seq_params->bit_depth);
+  }
+  const int num_corners =
+      av1_fast_corner_detect(ref_buffer, ref->y_width, ref->y_height,
+                             ref->y_stride, corners, MAX_CORNERS);
+  if (cache != NULL) {
+    memcpy(cache->corners, corners, sizeof(*corners) * 2 * num_corners);
+    cache->num_corners = num_corners;
+    cache->valid = 1;
+  }
+  return num_corners;
+}
+
+// Finds the matches of the source frame corners in the given reference frame,
+// stored as (x, y, rx, ry) in 'correspondences', and returns their count.
+static int compute_gm_correspondences(AV1_COMP *cpi, int frame,
+                                      int *ref_corners, int *correspondences) {
+  const GlobalMotionInfo *const gm_info = &cpi->gm_info;
+  const YV12_BUFFER_CONFIG *const source = cpi->source;
+  YV12_BUFFER_CONFIG *const ref = gm_info->ref_buf[frame];
+  av1_alloc_gm_ref_corners(cpi, frame);
+  const int num_ref_corners = av1_get_gm_ref_corners(cpi, frame, ref_corners);
+  unsigned char *ref_buffer = ref->y_buffer;
+  if (ref->flags & YV12_FLAG_HIGHBITDEPTH) {
+    ref_buffer = av1_downconvert_frame(ref, cpi->common.seq_params->bit_depth);
+  }
+  return av1_determine_correspondence(
+      gm_info->src_buffer, (int *)gm_info->src_corners,
+      gm_info->num_src_corners, ref_buffer, ref_corners, num_ref_corners,
+      source->y_width, source->y_height, source->y_stride, ref->y_stride,
+      correspondences);
+}
+
 // Computes global motion for the given reference frame.
 void av1_compute_gm_for_valid_ref_frames(
     AV1_COMP *cpi, YV12_BUFFER_CONFIG *ref_buf[REF_FRAMES], int frame,
     int num_src_corners, int *src_corners, unsigned char *src_buffer,
+    int *correspondences, int num_correspondences,
     MotionModel *params_by_motion, uint8_t *segment_map, int segment_map_w,
     int segment_map_h) {
   AV1_COMMON *const cm = &cpi->common;
@@ -209,7 +292,8 @@ void av1_compute_gm_for_valid_ref_frames(
 
   compute_global_motion_for_ref_frame(
       cpi, ref_buf, frame, num_src_corners, src_corners, src_buffer,
-      params_by_motion, segment_map, segment_map_w, segment_map_h, ref_params);
+      correspondences, num_correspondences, params_by_motion, segment_map,
+      segment_map_w, segment_map_h, ref_params);
 }
 
 // Loops over valid reference frames and computes global motion estimation.
@@ -217,8 +301,8 @@ static AOM_INLINE void compute_global_motion_for_references(
     AV1_COMP *cpi, YV12_BUFFER_CONFIG *ref_buf[REF_FRAMES],
     FrameDistPair reference_frame[REF_FRAMES - 1], int num_ref_frames,
     int num_src_corners, int *src_corners, unsigned char *src_buffer,
-    MotionModel *params_by_motion, uint8_t *segment_map,
-    const int segment_map_w, const int segment_map_h) {
+    int *ref_corners, int *correspondences, MotionModel *params_by_motion,
+    uint8_t *segment_map, const int segment_map_w, const int segment_map_h) {
   // Computation of frame corners for the source frame will be done already.
   assert(num_src_corners != -1);
   AV1_COMMON *const cm = &cpi->common;
@@ -226,9 +310,12 @@ static AOM_INLINE void compute_global_motion_for_references(
   // frame in a given direction.
   for (int frame = 0; frame < num_ref_frames; frame++) {
     int ref_frame = reference_frame[frame].frame;
+    const int num_correspondences = compute_gm_correspondences(
+        cpi, ref_frame, ref_corners, correspondences);
     av1_compute_gm_for_valid_ref_frames(
         cpi, ref_buf, ref_frame, num_src_corners, src_corners, src_buffer,
-        params_by_motion, segment_map, segment_map_w, segment_map_h);
+        correspondences, num_correspondences, params_by_motion, segment_map,
+        segment_map_w, segment_map_h);
     // If global motion w.r.t. current ref frame is
     // INVALID/TRANSLATION/IDENTITY, skip the evaluation of global motion w.r.t
     // the remaining ref frames in that direction. The below exit is disabled
@@ -428,12 +515,18 @@ static AOM_INLINE void setup_global_motion_info_params(AV1_COMP *cpi) {
 
 // Computes global motion w.r.t. valid reference frames.
 static AOM_INLINE void global_motion_estimation(AV1_COMP *cpi) {
+  AV1_COMMON *const cm = &cpi->common;
   GlobalMotionInfo *const gm_info = &cpi->gm_info;
   MotionModel params_by_motion[RANSAC_NUM_MOTIONS];
   uint8_t *segment_map = NULL;
+  int *ref_corners, *correspondences;
 
   alloc_global_motion_data(params_by_motion, &segment_map,
                            gm_info->segment_map_w, gm_info->segment_map_h);
+  CHECK_MEM_ERROR(cm, ref_corners,
+                  aom_malloc(sizeof(*ref_corners) * 2 * MAX_CORNERS));
+  CHECK_MEM_ERROR(cm, correspondences,
+                  aom_malloc(sizeof(*correspondences) * 4 * MAX_CORNERS));
 
   // Compute global motion w.r.t. past reference frames and future reference
   // frames
@@ -442,10 +535,13 @@ static AOM_INLINE void global_motion_estimation(AV1_COMP *cpi) {
       compute_global_motion_for_references(
           cpi, gm_info->ref_buf, gm_info->reference_frames[dir],
           gm_info->num_ref_frames[dir], gm_info->num_src_corners,
-          gm_info->src_corners, gm_info->src_buffer, params_by_motion,
-          segment_map, gm_info->segment_map_w, gm_info->segment_map_h);
+          gm_info->src_corners, gm_info->src_buffer, ref_corners,
+          correspondences, params_by_motion, segment_map,
+          gm_info->segment_map_w, gm_info->segment_map_h);
   }
 
+  aom_free(ref_corners);
+  aom_free(correspondences);
   dealloc_global_motion_data(params_by_motion, segment_map);
 }
 
@@ -21,8 +21,11 @@ struct AV1_COMP;
 void av1_compute_gm_for_valid_ref_frames(
     struct AV1_COMP *cpi, YV12_BUFFER_CONFIG *ref_buf[REF_FRAMES], int frame,
     int num_src_corners, int *src_corners, unsigned char *src_buffer,
+    int *correspondences, int num_correspondences,
     MotionModel *params_by_motion, uint8_t *segment_map, int segment_map_w,
     int segment_map_h);
+void av1_alloc_gm_ref_corners(struct AV1_COMP *cpi, int frame);
+int av1_get_gm_ref_corners(struct AV1_COMP *cpi, int frame, int *corners);
 void av1_compute_global_motion_facade(struct AV1_COMP *cpi);
 #ifdef __cplusplus
 }  // extern "C"
@@ -92,12 +92,15 @@ static int hash_block_size_to_index(int block_size) {
   }
 }
 
-void av1_hash_table_init(IntraBCHashInfo *intrabc_hash_info) {
+void av1_hash_crc_init(IntraBCHashInfo *intrabc_hash_info) {
   if (!intrabc_hash_info->g_crc_initialized) {
-    av1_crc_calculator_init(&intrabc_hash_info->crc_calculator1, 24, 0x5D6DCB);
-    av1_crc_calculator_init(&intrabc_hash_info->crc_calculator2, 24, 0x864CFB);
+    av1_crc32c_calculator_init(&intrabc_hash_info->crc_calculator);
     intrabc_hash_info->g_crc_initialized = 1;
   }
+}
+
+void av1_hash_table_init(IntraBCHashInfo *intrabc_hash_info) {
+  av1_hash_crc_init(intrabc_hash_info);
   intrabc_hash_info->intrabc_hash_table.p_lookup_table = NULL;
 }
 
@@ -180,97 +183,130 @@ int32_t av1_has_exact_match(hash_table *p_hash_table, uint32_t hash_value1,
   return 0;
 }
 
-void av1_generate_block_2x2_hash_value(IntraBCHashInfo *intrabc_hash_info,
-                                       const YV12_BUFFER_CONFIG *picture,
-                                       uint32_t *pic_block_hash[2],
-                                       int8_t *pic_block_same_info[3]) {
-  const int width = 2;
-  const int height = 2;
-  const int x_end = picture->y_crop_width - width + 1;
-  const int y_end = picture->y_crop_height - height + 1;
-  CRC_CALCULATOR *calc_1 = &intrabc_hash_info->crc_calculator1;
-  CRC_CALCULATOR *calc_2 = &intrabc_hash_info->crc_calculator2;
-
-  const int length = width * 2;
+// The first hash value of a 2x2 block is the CRC-32C of its pixels in raster
+// order, the second one the CRC-32C of its pixels in reverse order. The hash
+// values of larger blocks are the CRC-32C of the hash values of their four
+// quadrants, in raster order for the first hash value and in reverse order for
+// the second one.
+static void reverse_pixels_2x2(const uint8_t *p, uint8_t *q) {
+  for (int i = 0; i < 4; i++) q[i] = p[3 - i];
+}
+
+static void reverse_pixels16_2x2(const uint16_t *p, uint16_t *q) {
+  for (int i = 0; i < 4; i++) q[i] = p[3 - i];
+}
+
+void av1_hash_block_2x2_row_c(void *crc_calculator, const uint8_t *src,
+                              int stride, int width, uint32_t *hash1,
+                              uint32_t *hash2, int8_t *row_same,
+                              int8_t *col_same) {
+  uint8_t p[4], q[4];
+  for (int x_pos = 0; x_pos < width; x_pos++) {
+    get_pixels_in_1D_char_array_by_block_2x2(src + x_pos, stride, p);
+    reverse_pixels_2x2(p, q);
+    row_same[x_pos] = is_block_2x2_row_same_value(p);
+    col_same[x_pos] = is_block_2x2_col_same_value(p);
+    hash1[x_pos] = av1_get_crc32c_value_c(crc_calculator, p, sizeof(p));
+    hash2[x_pos] = av1_get_crc32c_value_c(crc_calculator, q, sizeof(q));
+  }
+}
+
+void av1_hash_block_quad_row_c(void *crc_calculator, const uint32_t *src1,
+                               const uint32_t *src2, int src_size, int stride,
+                               int width, uint32_t *dst1, uint32_t *dst2) {
+  const int below = src_size * stride;
+  uint32_t p[4];
+  for (int x_pos = 0; x_pos < width; x_pos++) {
+    p[0] = src1[x_pos];
+    p[1] = src1[x_pos + src_size];
+    p[2] = src1[x_pos + below];
+    p[3] = src1[x_pos + below + src_size];
+    dst1[x_pos] =
+        av1_get_crc32c_value_c(crc_calculator, (uint8_t *)p, sizeof(p));
+
+    p[0] = src2[x_pos + below + src_size];
+    p[1] = src2[x_pos + below];
+    p[2] = src2[x_pos + src_size];
+    p[3] = src2[x_pos];
+    dst2[x_pos] =
+        av1_get_crc32c_value_c(crc_calculator, (uint8_t *)p, sizeof(p));
+  }
+}
+
+void av1_generate_block_2x2_hash_rows(IntraBCHashInfo *intrabc_hash_info,
+                                      const YV12_BUFFER_CONFIG *picture,
+                                      int y_start, int y_end,
+                                      uint32_t *pic_block_hash[2],
+                                      int8_t *pic_block_same_info[3]) {
+  const int pic_width = picture->y_crop_width;
+  const int x_end = pic_width - 1;
+  const int stride = picture->y_stride;
+  CRC32C *calc = &intrabc_hash_info->crc_calculator;
+
   if (picture->flags & YV12_FLAG_HIGHBITDEPTH) {
-    uint16_t p[4];
-    int pos = 0;
-    for (int y_pos = 0; y_pos < y_end; y_pos++) {
+    uint16_t p[4], q[4];
+    for (int y_pos = y_start; y_pos < y_end; y_pos++) {
+      int pos = y_pos * pic_width;
       for (int x_pos = 0; x_pos < x_end; x_pos++) {
         get_pixels_in_1D_short_array_by_block_2x2(
-            CONVERT_TO_SHORTPTR(picture->y_buffer) + y_pos * picture->y_stride +
-                x_pos,
-            picture->y_stride, p);
+            CONVERT_TO_SHORTPTR(picture->y_buffer) + y_pos * stride + x_pos,
+            stride, p);
+        reverse_pixels16_2x2(p, q);
         pic_block_same_info[0][pos] = is_block16_2x2_row_same_value(p);
         pic_block_same_info[1][pos] = is_block16_2x2_col_same_value(p);
 
         pic_block_hash[0][pos] =
-            av1_get_crc_value(calc_1, (uint8_t *)p, length * sizeof(p[0]));
+            av1_get_crc32c_value(calc, (uint8_t *)p, sizeof(p));
         pic_block_hash[1][pos] =
-            av1_get_crc_value(calc_2, (uint8_t *)p, length * sizeof(p[0]));
+            av1_get_crc32c_value(calc, (uint8_t *)q, sizeof(q));
         pos++;
       }
-      pos += width - 1;
     }
   } else {
-    uint8_t p[4];
-    int pos = 0;
-    for (int y_pos = 0; y_pos < y_end; y_pos++) {
-      for (int x_pos = 0; x_pos < x_end; x_pos++) {
-        get_pixels_in_1D_char_array_by_block_2x2(
-            picture->y_buffer + y_pos * picture->y_stride + x_pos,
-            picture->y_stride, p);
-        pic_block_same_info[0][pos] = is_block_2x2_row_same_value(p);
-        pic_block_same_info[1][pos] = is_block_2x2_col_same_value(p);
-
-        pic_block_hash[0][pos] =
-            av1_get_crc_value(calc_1, p, length * sizeof(p[0]));
-        pic_block_hash[1][pos] =
-            av1_get_crc_value(calc_2, p, length * sizeof(p[0]));
-        pos++;
-      }
-      pos += width - 1;
+    for (int y_pos = y_start; y_pos < y_end; y_pos++) {
+      const int pos = y_pos * pic_width;
+      av1_hash_block_2x2_row(calc, picture->y_buffer + y_pos * stride, stride,
+                             x_end, pic_block_hash[0] + pos,
+                             pic_block_hash[1] + pos,
+                             pic_block_same_info[0] + pos,
+                             pic_block_same_info[1] + pos);
     }
   }
 }
 
-void av1_generate_block_hash_value(IntraBCHashInfo *intrabc_hash_info,
-                                   const YV12_BUFFER_CONFIG *picture,
-                                   int block_size,
-                                   uint32_t *src_pic_block_hash[2],
-                                   uint32_t *dst_pic_block_hash[2],
-                                   int8_t *src_pic_block_same_info[3],
-                                   int8_t *dst_pic_block_same_info[3]) {
-  CRC_CALCULATOR *calc_1 = &intrabc_hash_info->crc_calculator1;
-  CRC_CALCULATOR *calc_2 = &intrabc_hash_info->crc_calculator2;
+void av1_generate_block_2x2_hash_value(IntraBCHashInfo *intrabc_hash_info,
+                                       const YV12_BUFFER_CONFIG *picture,
+                                       uint32_t *pic_block_hash[2],
+                                       int8_t *pic_block_same_info[3]) {
+  av1_generate_block_2x2_hash_rows(intrabc_hash_info, picture, 0,
+                                   picture->y_crop_height - 1, pic_block_hash,
+                                   pic_block_same_info);
+}
 
+void av1_generate_block_hash_rows(IntraBCHashInfo *intrabc_hash_info,
+                                  const YV12_BUFFER_CONFIG *picture,
+                                  int block_size, int y_start, int y_end,
+                                  uint32_t *src_pic_block_hash[2],
+                                  uint32_t *dst_pic_block_hash[2],
+                                  int8_t *src_pic_block_same_info[3],
+                                  int8_t *dst_pic_block_same_info[3]) {
   const int pic_width = picture->y_crop_width;
   const int x_end = picture->y_crop_width - block_size + 1;
-  const int y_end = picture->y_crop_height - block_size + 1;
 
   const int src_size = block_size >> 1;
   const int quad_size = block_size >> 2;
+  const int size_minus_1 = block_size - 1;
 
-  uint32_t p[4];
-  const int length = sizeof(p);
+  for (int y_pos = y_start; y_pos < y_end; y_pos++) {
+    const int row = y_pos * pic_width;
+    av1_hash_block_quad_row(&intrabc_hash_info->crc_calculator,
+                            src_pic_block_hash[0] + row,
+                            src_pic_block_hash[1] + row, src_size, pic_width,
+                            x_end, dst_pic_block_hash[0] + row,
+                            dst_pic_block_hash[1] + row);
 
-  int pos = 0;
-  for (int y_pos = 0; y_pos < y_end; y_pos++) {
     for (int x_pos = 0; x_pos < x_end; x_pos++) {
-      p[0] = src_pic_block_hash[0][pos];
-      p[1] = src_pic_block_hash[0][pos + src_size];
-      p[2] = src_pic_block_hash[0][pos + src_size * pic_width];
-      p[3] = src_pic_block_hash[0][pos + src_size * pic_width + src_size];
-      dst_pic_block_hash[0][pos] =
-          av1_get_crc_value(calc_1, (uint8_t *)p, length);
-
-      p[0] = src_pic_block_hash[1][pos];
-      p[1] = src_pic_block_hash[1][pos + src_size];
-      p[2] = src_pic_block_hash[1][pos + src_size * pic_width];
-      p[3] = src_pic_block_hash[1][pos + src_size * pic_width + src_size];
-      dst_pic_block_hash[1][pos] =
-          av1_get_crc_value(calc_2, (uint8_t *)p, length);
-
+      const int pos = row + x_pos;
       dst_pic_block_same_info[0][pos] =
           src_pic_block_same_info[0][pos] &&
           src_pic_block_same_info[0][pos + quad_size] &&
@@ -286,27 +322,28 @@ void av1_generate_block_hash_value(IntraBCHashInfo *intrabc_hash_info,
           src_pic_block_same_info[1][pos + quad_size * pic_width + src_size] &&
           src_pic_block_same_info[1][pos + src_size * pic_width] &&
           src_pic_block_same_info[1][pos + src_size * pic_width + src_size];
-      pos++;
-    }
-    pos += block_size - 1;
-  }
 
-  if (block_size >= 4) {
-    const int size_minus_1 = block_size - 1;
-    pos = 0;
-    for (int y_pos = 0; y_pos < y_end; y_pos++) {
-      for (int x_pos = 0; x_pos < x_end; x_pos++) {
-        dst_pic_block_same_info[2][pos] =
-            (!dst_pic_block_same_info[0][pos] &&
-             !dst_pic_block_same_info[1][pos]) ||
-            (((x_pos & size_minus_1) == 0) && ((y_pos & size_minus_1) == 0));
-        pos++;
-      }
-      pos += block_size - 1;
+      dst_pic_block_same_info[2][pos] =
+          (!dst_pic_block_same_info[0][pos] &&
+           !dst_pic_block_same_info[1][pos]) ||
+          (((x_pos & size_minus_1) == 0) && ((y_pos & size_minus_1) == 0));
     }
   }
 }
 
+void av1_generate_block_hash_value(IntraBCHashInfo *intrabc_hash_info,
+                                   const YV12_BUFFER_CONFIG *picture,
+                                   int block_size,
+                                   uint32_t *src_pic_block_hash[2],
+                                   uint32_t *dst_pic_block_hash[2],
+                                   int8_t *src_pic_block_same_info[3],
+                                   int8_t *dst_pic_block_same_info[3]) {
+  av1_generate_block_hash_rows(
+      intrabc_hash_info, picture, block_size, 0,
+      picture->y_crop_height - block_size + 1, src_pic_block_hash,
+      dst_pic_block_hash, src_pic_block_same_info, dst_pic_block_same_info);
+}
+
 void av1_add_to_hash_map_by_row_with_precal_data(hash_table *p_hash_table,
                                                  uint32_t *pic_hash[2],
                                                  int8_t *pic_is_same,
@@ -405,40 +442,40 @@ void av1_get_block_hash_value(IntraBCHashInfo *intrabc_hash_info,
   add_value <<= kSrcBits;
   const int crc_mask = (1 << kSrcBits) - 1;
 
-  CRC_CALCULATOR *calc_1 = &intrabc_hash_info->crc_calculator1;
-  CRC_CALCULATOR *calc_2 = &intrabc_hash_info->crc_calculator2;
+  CRC32C *calc = &intrabc_hash_info->crc_calculator;
   uint32_t **buf_1 = intrabc_hash_info->hash_value_buffer[0];
   uint32_t **buf_2 = intrabc_hash_info->hash_value_buffer[1];
 
   // 2x2 subblock hash values in current CU
   int sub_block_in_width = (block_size >> 1);
   if (use_highbitdepth) {
-    uint16_t pixel_to_hash[4];
+    uint16_t pixel_to_hash[4], reversed[4];
     uint16_t *y16_src = CONVERT_TO_SHORTPTR(y_src);
     for (int y_pos = 0; y_pos < block_size; y_pos += 2) {
       for (int x_pos = 0; x_pos < block_size; x_pos += 2) {
         int pos = (y_pos >> 1) * sub_block_in_width + (x_pos >> 1);
         get_pixels_in_1D_short_array_by_block_2x2(
             y16_src + y_pos * stride + x_pos, stride, pixel_to_hash);
+        reverse_pixels16_2x2(pixel_to_hash, reversed);
         assert(pos < AOM_BUFFER_SIZE_FOR_BLOCK_HASH);
-        buf_1[0][pos] = av1_get_crc_value(calc_1, (uint8_t *)pixel_to_hash,
-                                          sizeof(pixel_to_hash));
-        buf_2[0][pos] = av1_get_crc_value(calc_2, (uint8_t *)pixel_to_hash,
-                                          sizeof(pixel_to_hash));
+        buf_1[0][pos] = av1_get_crc32c_value(calc, (uint8_t *)pixel_to_hash,
+                                             sizeof(pixel_to_hash));
+        buf_2[0][pos] =
+            av1_get_crc32c_value(calc, (uint8_t *)reversed, sizeof(reversed));
       }
     }
   } else {
-    uint8_t pixel_to_hash[4];
+    uint8_t pixel_to_hash[4], reversed[4];
     for (int y_pos = 0; y_pos < block_size; y_pos += 2) {
       for (int x_pos = 0; x_pos < block_size; x_pos += 2) {
         int pos = (y_pos >> 1) * sub_block_in_width + (x_pos >> 1);
         get_pixels_in_1D_char_array_by_block_2x2(y_src + y_pos * stride + x_pos,
                                                  stride, pixel_to_hash);
+        reverse_pixels_2x2(pixel_to_hash, reversed);
         assert(pos < AOM_BUFFER_SIZE_FOR_BLOCK_HASH);
         buf_1[0][pos] =
-            av1_get_crc_value(calc_1, pixel_to_hash, sizeof(pixel_to_hash));
-        buf_2[0][pos] =
-            av1_get_crc_value(calc_2, pixel_to_hash, sizeof(pixel_to_hash));
+            av1_get_crc32c_value(calc, pixel_to_hash, sizeof(pixel_to_hash));
+        buf_2[0][pos] = av1_get_crc32c_value(calc, reversed, sizeof(reversed));
       }
     }
   }
@@ -470,14 +507,14 @@ void av1_get_block_hash_value(IntraBCHashInfo *intrabc_hash_info,
         to_hash[3] = buf_1[src_idx][srcPos + src_sub_block_in_width + 1];
 
         buf_1[dst_idx][dst_pos] =
-            av1_get_crc_value(calc_1, (uint8_t *)to_hash, sizeof(to_hash));
+            av1_get_crc32c_value(calc, (uint8_t *)to_hash, sizeof(to_hash));
 
-        to_hash[0] = buf_2[src_idx][srcPos];
-        to_hash[1] = buf_2[src_idx][srcPos + 1];
-        to_hash[2] = buf_2[src_idx][srcPos + src_sub_block_in_width];
-        to_hash[3] = buf_2[src_idx][srcPos + src_sub_block_in_width + 1];
+        to_hash[0] = buf_2[src_idx][srcPos + src_sub_block_in_width + 1];
+        to_hash[1] = buf_2[src_idx][srcPos + src_sub_block_in_width];
+        to_hash[2] = buf_2[src_idx][srcPos + 1];
+        to_hash[3] = buf_2[src_idx][srcPos];
         buf_2[dst_idx][dst_pos] =
-            av1_get_crc_value(calc_2, (uint8_t *)to_hash, sizeof(to_hash));
+            av1_get_crc32c_value(calc, (uint8_t *)to_hash, sizeof(to_hash));
         dst_pos++;
       }
     }
@@ -489,3 +526,214 @@ void av1_get_block_hash_value(IntraBCHashInfo *intrabc_hash_info,
   *hash_value1 = (buf_1[dst_idx][0] & crc_mask) + add_value;
   *hash_value2 = buf_2[dst_idx][0];
 }
+
+void av1_free_src_block_hash_cache(SrcBlockHashCache *cache) {
+  for (int k = 0; k < 2; k++) {
+    aom_free(cache->block_hash[k]);
+    cache->block_hash[k] = NULL;
+  }
+  aom_free(cache->is_added);
+  cache->is_added = NULL;
+  aom_free(cache->src);
+  cache->src = NULL;
+  cache->width = 0;
+  cache->height = 0;
+}
+
+void av1_free_ref_frame_hash_index(RefFrameHashIndex *index) {
+  aom_free(index->blocks);
+  index->blocks = NULL;
+  aom_free(index->offsets);
+  index->offsets = NULL;
+  index->num_blocks = index->alloc_blocks = 0;
+  index->valid = 0;
+}
+
+const block_hash *av1_ref_frame_hash_lookup(const RefFrameHashIndex *index,
+                                           uint32_t hash_value1, int *count) {
+  const int key = hash_value1 & ((1 << kSrcBits) - 1);
+  *count = index->offsets[key + 1] - index->offsets[key];
+  return index->blocks + index->offsets[key];
+}
+
+// Sorts the blocks flagged in 'is_added' into 'index' by their key, with a
+// counting sort.
+static int fill_ref_frame_hash_index(RefFrameHashIndex *index,
+                                     const SrcBlockHashCache *cache) {
+  const int num_keys = 1 << kSrcBits;
+  const int crc_mask = num_keys - 1;
+  const int width = cache->width;
+  const int x_end = width - REF_FRAME_HASH_BLOCK_SIZE + 1;
+  const int y_end = cache->height - REF_FRAME_HASH_BLOCK_SIZE + 1;
+  if (index->offsets == NULL) {
+    index->offsets = aom_malloc((num_keys + 1) * sizeof(*index->offsets));
+    if (index->offsets == NULL) return 0;
+  }
+  int *const offsets = index->offsets;
+  memset(offsets, 0, (num_keys + 1) * sizeof(*offsets));
+  for (int y_pos = 0; y_pos < y_end; y_pos++) {
+    const int8_t *is_added = cache->is_added + y_pos * width;
+    const uint32_t *hash = cache->block_hash[0] + y_pos * width;
+    for (int x_pos = 0; x_pos < x_end; x_pos++) {
+      if (is_added[x_pos]) offsets[(hash[x_pos] & crc_mask) + 1]++;
+    }
+  }
+  for (int k = 0; k < num_keys; k++) offsets[k + 1] += offsets[k];
+
+  const int num_blocks = offsets[num_keys];
+  if (num_blocks > index->alloc_blocks) {
+    aom_free(index->blocks);
+    index->alloc_blocks = 0;
+    index->blocks = aom_malloc(num_blocks * sizeof(*index->blocks));
+    if (index->blocks == NULL) return 0;
+    index->alloc_blocks = num_blocks;
+  }
+  index->num_blocks = num_blocks;
+
+  // Each offsets[k] moves from the start of key k to the start of key k + 1.
+  for (int y_pos = 0; y_pos < y_end; y_pos++) {
+    const int8_t *is_added = cache->is_added + y_pos * width;
+    const uint32_t *hash1 = cache->block_hash[0] + y_pos * width;
+    const uint32_t *hash2 = cache->block_hash[1] + y_pos * width;
+    for (int x_pos = 0; x_pos < x_end; x_pos++) {
+      if (!is_added[x_pos]) continue;
+      block_hash *const block =
+          &index->blocks[offsets[hash1[x_pos] & crc_mask]++];
+      block->x = x_pos;
+      block->y = y_pos;
+      block->hash_value2 = hash2[x_pos];
+    }
+  }
+  memmove(offsets + 1, offsets, num_keys * sizeof(*offsets));
+  offsets[0] = 0;
+  return 1;
+}
+
+// Computes the hash values of the REF_FRAME_HASH_BLOCK_SIZE blocks starting on
+// rows [y_start, y_end) of 'picture' into 'cache'. y_start is a multiple of the
+// block size, so the blocks picked for the hash table are the same as when
+// hashing the whole picture.
+static int hash_block_rows(IntraBCHashInfo *intrabc_hash_info,
+                           const YV12_BUFFER_CONFIG *picture, int y_start,
+                           int y_end, SrcBlockHashCache *cache) {
+  const int block_size = REF_FRAME_HASH_BLOCK_SIZE;
+  assert(y_start % block_size == 0);
+  YV12_BUFFER_CONFIG rows = *picture;
+  rows.y_buffer += y_start * picture->y_stride;
+  rows.y_crop_height = y_end - y_start + block_size - 1;
+  const size_t num = (size_t)rows.y_crop_width * rows.y_crop_height;
+
+  uint32_t *hash_values[2][2] = { { NULL, NULL }, { NULL, NULL } };
+  int8_t *is_same[2][3] = { { NULL, NULL, NULL }, { NULL, NULL, NULL } };
+  int ok = 1;
+  for (int k = 0; k < 2; k++) {
+    for (int j = 0; j < 2; j++) {
+      hash_values[k][j] = aom_malloc(sizeof(*hash_values[k][j]) * num);
+      ok &= hash_values[k][j] != NULL;
+    }
+    for (int j = 0; j < 3; j++) {
+      is_same[k][j] = aom_malloc(sizeof(*is_same[k][j]) * num);
+      ok &= is_same[k][j] != NULL;
+    }
+  }
+
+  if (ok) {
+    av1_generate_block_2x2_hash_value(intrabc_hash_info, &rows, hash_values[0],
+                                      is_same[0]);
+    int src_idx = 0;
+    for (int size = 4; size <= block_size; size *= 2, src_idx = !src_idx) {
+      av1_generate_block_hash_value(intrabc_hash_info, &rows, size,
+                                    hash_values[src_idx], hash_values[!src_idx],
+                                    is_same[src_idx], is_same[!src_idx]);
+    }
+    const size_t offset = (size_t)y_start * cache->width;
+    const size_t count = (size_t)(y_end - y_start) * cache->width;
+    for (int k = 0; k < 2; k++) {
+      memcpy(cache->block_hash[k] + offset, hash_values[src_idx][k],
+             count * sizeof(*cache->block_hash[k]));
+    }
+    memcpy(cache->is_added + offset, is_same[src_idx][2],
+           count * sizeof(*cache->is_added));
+  }
+
+  for (int k = 0; k < 2; k++) {
+    for (int j = 0; j < 2; j++) aom_free(hash_values[k][j]);
+    for (int j = 0; j < 3; j++) aom_free(is_same[k][j]);
+  }
+  return ok;
+}
+
+int av1_build_ref_frame_hash_index(IntraBCHashInfo *intrabc_hash_info,
+                                   SrcBlockHashCache *cache,
+                                   const YV12_BUFFER_CONFIG *picture,
+                                   RefFrameHashIndex *index) {
+  const int block_size = REF_FRAME_HASH_BLOCK_SIZE;
+  const int width = picture->y_crop_width;
+  const int height = picture->y_crop_height;
+  const int use_highbitdepth = (picture->flags & YV12_FLAG_HIGHBITDEPTH) != 0;
+  const int row_bytes = width << use_highbitdepth;
+  index->valid = 0;
+  if (width < block_size || height < block_size) return 1;
+
+  av1_hash_crc_init(intrabc_hash_info);
+  int rehash_all = 0;
+  if (cache->width != width || cache->height != height ||
+      cache->use_highbitdepth != use_highbitdepth) {
+    av1_free_src_block_hash_cache(cache);
+    const size_t num = (size_t)width * height;
+    for (int k = 0; k < 2; k++) {
+      cache->block_hash[k] = aom_calloc(num, sizeof(*cache->block_hash[k]));
+    }
+    cache->is_added = aom_calloc(num, sizeof(*cache->is_added));
+    cache->src = aom_malloc(num << use_highbitdepth);
+    if (!cache->block_hash[0] || !cache->block_hash[1] || !cache->is_added ||
+        !cache->src) {
+      av1_free_src_block_hash_cache(cache);
+      return 0;
+    }
+    cache->width = width;
+    cache->height = height;
+    cache->use_highbitdepth = use_highbitdepth;
+    rehash_all = 1;
+  }
+
+  // A changed row r invalidates the blocks starting on rows r - block_size + 1
+  // to r. Rehash them in runs of consecutive rows, aligned to the block size.
+  const uint8_t *src = use_highbitdepth
+                           ? (const uint8_t *)CONVERT_TO_SHORTPTR(
+                                 picture->y_buffer)
+                           : picture->y_buffer;
+  const int src_stride = picture->y_stride << use_highbitdepth;
+  const int num_block_rows = height - block_size + 1;
+  int run_start = -1;
+  int run_end = -1;
+  for (int r = 0; r < height; r++) {
+    uint8_t *const cached = cache->src + (size_t)r * row_bytes;
+    const uint8_t *const cur = src + (size_t)r * src_stride;
+    if (!rehash_all && !memcmp(cached, cur, row_bytes)) continue;
+    memcpy(cached, cur, row_bytes);
+    const int first = AOMMAX(r - block_size + 1, 0) / block_size * block_size;
+    const int last = AOMMIN(r + 1, num_block_rows);
+    if (run_start >= 0 && first > run_end) {
+      if (!hash_block_rows(intrabc_hash_info, picture, run_start, run_end,
+                           cache)) {
+        cache->width = 0;
+        return 0;
+      }
+      run_start = -1;
+    }
+    if (run_start < 0) run_start = first;
+    run_end = AOMMAX(run_end, last);
+  }
+  if (run_start >= 0 &&
+      !hash_block_rows(intrabc_hash_info, picture, run_start, run_end, cache)) {
+    cache->width = 0;
+    return 0;
+  }
+
+  if (!fill_ref_frame_hash_index(index, cache)) return 0;
+  index->width = width;
+  index->height = height;
+  index->valid = 1;
+  return 1;
+}
@@ -25,6 +25,9 @@ extern "C" {
 // Block size used for force_integer_mv decisions
 #define FORCE_INT_MV_DECISION_BLOCK_SIZE 8
 
+// Block size of the hash index of reference frames used in inter motion search
+#define REF_FRAME_HASH_BLOCK_SIZE 8
+
 // store a block's hash info.
 // x and y are the position from the top left of the picture
 // hash_value2 is used to store the second hash value
@@ -48,11 +51,43 @@ typedef struct intrabc_hash_info {
   uint32_t *hash_value_buffer[2][2];
   hash_table intrabc_hash_table;
 
-  CRC_CALCULATOR crc_calculator1;
-  CRC_CALCULATOR crc_calculator2;
+  // Tables of the software CRC-32C. Both block hash values are CRC-32C, which
+  // is computed with hardware instructions when available.
+  CRC32C crc_calculator;
   int g_crc_initialized;
 } IntraBCHashInfo;
 
+// Hash index of the REF_FRAME_HASH_BLOCK_SIZE blocks at all positions of the
+// source of a frame. It is kept with the frame buffer (RefCntBuffer), and
+// searched for exact matches when the frame is used as a reference. The blocks
+// are sorted by the low bits of their first hash value, which a flat array
+// holds with much less allocation than hash_table.
+typedef struct RefFrameHashIndex {
+  // The blocks with key k are blocks[offsets[k]] to blocks[offsets[k + 1] - 1].
+  block_hash *blocks;
+  int *offsets;
+  int num_blocks;
+  int alloc_blocks;
+  int width;
+  int height;
+  // The frame the index was built for, so that it is built once per frame.
+  unsigned int frame_number;
+  int valid;
+} RefFrameHashIndex;
+
+// Block hash values of the last hashed source frame and a copy of its luma
+// plane, so that the hash index of the next frame only recomputes the hash
+// values of the rows that changed.
+typedef struct {
+  uint32_t *block_hash[2];
+  int8_t *is_added;
+  uint8_t *src;
+  int width;
+  int height;
+  int use_highbitdepth;
+} SrcBlockHashCache;
+
+void av1_hash_crc_init(IntraBCHashInfo *intra_bc_hash_info);
 void av1_hash_table_init(IntraBCHashInfo *intra_bc_hash_info);
 void av1_hash_table_clear_all(hash_table *p_hash_table);
 void av1_hash_table_destroy(hash_table *p_hash_table);
@@ -74,6 +109,21 @@ void av1_generate_block_hash_value(IntraBCHashInfo *intra_bc_hash_info,
                                    uint32_t *dst_pic_block_hash[2],
                                    int8_t *src_pic_block_same_info[3],
                                    int8_t *dst_pic_block_same_info[3]);
+// Same as av1_generate_block_2x2_hash_value() and
+// av1_generate_block_hash_value(), for the blocks starting on rows
+// [y_start, y_end) only. The rows of a level can be split between threads.
+void av1_generate_block_2x2_hash_rows(IntraBCHashInfo *intra_bc_hash_info,
+                                      const YV12_BUFFER_CONFIG *picture,
+                                      int y_start, int y_end,
+                                      uint32_t *pic_block_hash[2],
+                                      int8_t *pic_block_same_info[3]);
+void av1_generate_block_hash_rows(IntraBCHashInfo *intra_bc_hash_info,
+                                  const YV12_BUFFER_CONFIG *picture,
+                                  int block_size, int y_start, int y_end,
+                                  uint32_t *src_pic_block_hash[2],
+                                  uint32_t *dst_pic_block_hash[2],
+                                  int8_t *src_pic_block_same_info[3],
+                                  int8_t *dst_pic_block_same_info[3]);
 void av1_add_to_hash_map_by_row_with_precal_data(hash_table *p_hash_table,
                                                  uint32_t *pic_hash[2],
                                                  int8_t *pic_is_same,
@@ -94,6 +144,20 @@ void av1_get_block_hash_value(IntraBCHashInfo *intrabc_hash_info,
                               uint32_t *hash_value1, uint32_t *hash_value2,
                               int use_highbitdepth);
 
+// Builds the hash index of 'picture', recomputing the block hash values only
+// for the rows that differ from the source held in 'cache'. Returns 0 on
+// memory allocation failure.
+int av1_build_ref_frame_hash_index(IntraBCHashInfo *intra_bc_hash_info,
+                                   SrcBlockHashCache *cache,
+                                   const YV12_BUFFER_CONFIG *picture,
+                                   RefFrameHashIndex *index);
+// Returns the blocks of 'index' with the first hash value 'hash_value1', as
+// returned by av1_get_block_hash_value(), and sets 'count' to their number.
+const block_hash *av1_ref_frame_hash_lookup(const RefFrameHashIndex *index,
+                                           uint32_t hash_value1, int *count);
+void av1_free_ref_frame_hash_index(RefFrameHashIndex *index);
+void av1_free_src_block_hash_cache(SrcBlockHashCache *cache);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif
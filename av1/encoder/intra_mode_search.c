@@ -1215,6 +1215,52 @@ int av1_search_intra_uv_modes_in_interframe(
   return 1;
 }
 
+// Returns 1 if the model rd of the directional modes is computed for all the
+// angle deltas of a mode at once, from neighboring pixels gathered once. This
+// requires the model to use a single transform block.
+static AOM_INLINE int use_shared_dr_edges(const AV1_COMP *const cpi,
+                                          const MACROBLOCK *const x,
+                                          BLOCK_SIZE bsize, TX_SIZE tx_size) {
+  const MACROBLOCKD *const xd = &x->e_mbd;
+  return cpi->sf.intra_sf.share_dr_pred_edges && !is_cur_buf_hbd(xd) &&
+         max_block_wide(xd, bsize, 0) <= tx_size_wide_unit[tx_size] &&
+         max_block_high(xd, bsize, 0) <= tx_size_high_unit[tx_size];
+}
+
+// Computes the same model rd as intra_model_rd() for all the angle deltas of
+// the given directional mode, up to max_angle_delta. The neighboring pixels
+// are gathered once and the predictions are built in a local buffer.
+static void dr_model_rd_all_angles(const AV1_COMMON *cm, MACROBLOCK *x,
+                                   BLOCK_SIZE bsize, TX_SIZE tx_size,
+                                   PREDICTION_MODE mode, int max_angle_delta,
+                                   int64_t model_rd[2 * MAX_ANGLE_DELTA + 1]) {
+  MACROBLOCKD *const xd = &x->e_mbd;
+  const BitDepthInfo bd_info = get_bit_depth_info(xd);
+  const struct macroblock_plane *const p = &x->plane[0];
+  const struct macroblockd_plane *const pd = &xd->plane[0];
+  const int txbw = tx_size_wide[tx_size];
+  const int txbh = tx_size_high[tx_size];
+  const int diff_stride = block_size_wide[bsize];
+  DECLARE_ALIGNED(16, uint8_t, pred[32 * 32]);
+  assert(txbw <= 32 && txbh <= 32);
+
+  IntraDrEdges edges;
+  av1_prepare_intra_dr_edges(xd, cm->seq_params->sb_size,
+                             cm->seq_params->enable_intra_edge_filter,
+                             pd->width, pd->height, tx_size, pd->dst.buf,
+                             pd->dst.stride, 0, 0, 0, &edges);
+  for (int delta = -max_angle_delta; delta <= max_angle_delta; ++delta) {
+    const int p_angle = mode_to_angle_map[mode] + delta * ANGLE_STEP;
+    av1_predict_intra_dr_from_edges(&edges, p_angle, pred, txbw);
+    av1_subtract_block(bd_info, txbh, txbw, p->src_diff, diff_stride,
+                       p->src.buf, p->src.stride, pred, txbw);
+    av1_quick_txfm(/*use_hadamard=*/1, tx_size, bd_info, p->src_diff,
+                   diff_stride, p->coeff);
+    model_rd[delta + MAX_ANGLE_DELTA] =
+        aom_satd(p->coeff, tx_size_2d[tx_size]);
+  }
+}
+
 // Finds the best non-intrabc mode on an intra frame.
 int64_t av1_rd_pick_intra_sby_mode(const AV1_COMP *const cpi, MACROBLOCK *x,
                                    int *rate, int *rate_tokenonly,
@@ -1275,6 +1321,11 @@ int64_t av1_rd_pick_intra_sby_mode(const AV1_COMP *const cpi, MACROBLOCK *x,
   for (int i = 0; i < TOP_INTRA_MODEL_COUNT; i++) {
     top_intra_model_rd[i] = INT64_MAX;
   }
+  const TX_SIZE model_tx_size = AOMMIN(TX_32X32, max_txsize_lookup[bsize]);
+  const int shared_dr_edges =
+      use_shared_dr_edges(cpi, x, bsize, model_tx_size);
+  int64_t dr_model_rd[DIRECTIONAL_MODES][2 * MAX_ANGLE_DELTA + 1];
+  uint8_t dr_model_rd_done[DIRECTIONAL_MODES] = { 0 };
   for (int mode_idx = INTRA_MODE_START; mode_idx < LUMA_MODE_COUNT;
        ++mode_idx) {
     set_y_mode_and_delta_angle(mode_idx, mbmi);
@@ -1324,9 +1375,25 @@ int64_t av1_rd_pick_intra_sby_mode(const AV1_COMP *const cpi, MACROBLOCK *x,
           (1 << mbmi->mode)))
       continue;
 
-    const TX_SIZE tx_size = AOMMIN(TX_32X32, max_txsize_lookup[bsize]);
-    const int64_t this_model_rd =
-        intra_model_rd(&cpi->common, x, 0, bsize, tx_size, /*use_hadamard=*/1);
+    int64_t this_model_rd;
+    if (shared_dr_edges && is_directional_mode) {
+      const int dr_idx = mbmi->mode - V_PRED;
+      if (!dr_model_rd_done[dr_idx]) {
+        const int max_angle_delta =
+            (av1_use_angle_delta(bsize) && intra_mode_cfg->enable_angle_delta)
+                ? MAX_ANGLE_DELTA
+                : 0;
+        dr_model_rd_all_angles(&cpi->common, x, bsize, model_tx_size,
+                               mbmi->mode, max_angle_delta,
+                               dr_model_rd[dr_idx]);
+        dr_model_rd_done[dr_idx] = 1;
+      }
+      const int angle_idx = mbmi->angle_delta[PLANE_TYPE_Y] + MAX_ANGLE_DELTA;
+      this_model_rd = dr_model_rd[dr_idx][angle_idx];
+    } else {
+      this_model_rd = intra_model_rd(&cpi->common, x, 0, bsize, model_tx_size,
+                                     /*use_hadamard=*/1);
+    }
 
     const int model_rd_index_for_pruning =
         get_model_rd_index_for_pruning(x, intra_sf);
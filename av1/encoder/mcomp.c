@@ -1858,6 +1858,69 @@ int av1_intrabc_hash_search(const AV1_COMP *cpi, const MACROBLOCKD *xd,
   return best_hash_cost;
 }
 
+// Maximum number of reference blocks with the hash value of the source block.
+#define MAX_REF_FRAME_HASH_CANDIDATES 64
+
+int av1_ref_frame_hash_search(const AV1_COMP *cpi, MACROBLOCK *x,
+                              MV_REFERENCE_FRAME ref,
+                              const FULLPEL_MOTION_SEARCH_PARAMS *ms_params,
+                              int *cost_list, FULLPEL_MV *best_mv,
+                              FULLPEL_MV *second_best_mv) {
+  const AV1_COMMON *const cm = &cpi->common;
+  const MACROBLOCKD *const xd = &x->e_mbd;
+  const BLOCK_SIZE bsize = ms_params->bsize;
+  if (block_size_wide[bsize] < REF_FRAME_HASH_BLOCK_SIZE ||
+      block_size_high[bsize] < REF_FRAME_HASH_BLOCK_SIZE)
+    return INT_MAX;
+
+  const RefCntBuffer *const ref_buf = get_ref_frame_buf(cm, ref);
+  if (ref_buf == NULL || ref_buf->hash_index == NULL) return INT_MAX;
+  const RefFrameHashIndex *const index = ref_buf->hash_index;
+  if (!index->valid || index->width != cm->width ||
+      index->height != cm->height)
+    return INT_MAX;
+
+  // Hash the top left corner of the source block.
+  const struct buf_2d *const src = ms_params->ms_buffers.src;
+  uint32_t hash_value1, hash_value2;
+  av1_get_block_hash_value(&x->intrabc_hash_info, src->buf, src->stride,
+                           REF_FRAME_HASH_BLOCK_SIZE, &hash_value1,
+                           &hash_value2, is_cur_buf_hbd(xd));
+  int count;
+  const block_hash *const blocks =
+      av1_ref_frame_hash_lookup(index, hash_value1, &count);
+  // Too many matches are flat areas, which the regular search handles.
+  if (count == 0 || count > MAX_REF_FRAME_HASH_CANDIDATES) return INT_MAX;
+
+  const int x_pos = xd->mi_col * MI_SIZE;
+  const int y_pos = xd->mi_row * MI_SIZE;
+  int best_hash_cost = INT_MAX;
+  FULLPEL_MV hash_mv = kZeroFullMv;
+  for (int i = 0; i < count; i++) {
+    if (blocks[i].hash_value2 != hash_value2) continue;
+    const FULLPEL_MV mv = { blocks[i].y - y_pos, blocks[i].x - x_pos };
+    if (!av1_is_fullmv_in_range(&ms_params->mv_limits, mv)) continue;
+    const int cost = get_mvpred_var_cost(ms_params, &mv);
+    if (cost < best_hash_cost) {
+      best_hash_cost = cost;
+      hash_mv = mv;
+    }
+  }
+  if (best_hash_cost == INT_MAX) return INT_MAX;
+
+  // The index hashes the source of the reference, so refine the match on the
+  // reconstruction with the smallest search step.
+  const int step_param =
+      (ms_params->search_method == NSTEP ||
+       ms_params->search_method == NSTEP_8PT ||
+       ms_params->search_method == DIAMOND ||
+       ms_params->search_method == CLAMPED_DIAMOND)
+          ? ms_params->search_sites->num_search_steps - 1
+          : MAX_MVSEARCH_STEPS - 1;
+  return av1_full_pixel_search(hash_mv, ms_params, step_param, cost_list,
+                               best_mv, second_best_mv);
+}
+
 static int vector_match(int16_t *ref, int16_t *src, int bwl) {
   int best_sad = INT_MAX;
   int this_sad;
@@ -319,6 +319,15 @@ int av1_intrabc_hash_search(const struct AV1_COMP *cpi, const MACROBLOCKD *xd,
                             IntraBCHashInfo *intrabc_hash_info,
                             FULLPEL_MV *best_mv);
 
+// Looks up the source block in the hash index of reference frame 'ref' and
+// refines the best exact match with a single step full pixel search. Returns
+// INT_MAX if the reference has no index or no block matches.
+int av1_ref_frame_hash_search(const struct AV1_COMP *cpi, MACROBLOCK *x,
+                              MV_REFERENCE_FRAME ref,
+                              const FULLPEL_MOTION_SEARCH_PARAMS *ms_params,
+                              int *cost_list, FULLPEL_MV *best_mv,
+                              FULLPEL_MV *second_best_mv);
+
 int av1_obmc_full_pixel_search(const FULLPEL_MV start_mv,
                                const FULLPEL_MOTION_SEARCH_PARAMS *ms_params,
                                const int step_param, FULLPEL_MV *best_mv);
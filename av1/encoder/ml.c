@@ -11,8 +11,10 @@
 
 #include <assert.h>
 #include <math.h>
+#include <string.h>
 
 #include "aom_dsp/aom_dsp_common.h"
+#include "aom_ports/mem.h"
 #include "av1/encoder/ml.h"
 
 void av1_nn_output_prec_reduce(float *const output, int num_output) {
@@ -68,6 +70,163 @@ void av1_nn_predict_c(const float *input_nodes,
   if (reduce_prec) av1_nn_output_prec_reduce(output, nn_config->num_outputs);
 }
 
+// Calculate the predictions of num_blocks feature vectors, stored one after
+// another in input_nodes. The outputs are stored the same way. This runs
+// av1_nn_predict() on each vector, so it gets its SIMD versions; the batched
+// SIMD versions give the same result as av1_nn_predict_c().
+void av1_nn_predict_batch_c(const float *input_nodes, int num_blocks,
+                            const NN_CONFIG *const nn_config, int reduce_prec,
+                            float *const output) {
+  for (int i = 0; i < num_blocks; ++i) {
+    av1_nn_predict(input_nodes + i * nn_config->num_inputs, nn_config,
+                   reduce_prec, output + i * nn_config->num_outputs);
+  }
+}
+
+void av1_nn_fc_int16_c(const int16_t *input, const int16_t *weights,
+                       int num_inputs, int num_outputs, int32_t *output) {
+  assert(num_inputs % NN_INT16_INPUT_ALIGN == 0);
+  for (int node = 0; node < num_outputs; ++node) {
+    int32_t sum = 0;
+    for (int i = 0; i < num_inputs; ++i) sum += weights[i] * input[i];
+    output[node] = sum;
+    weights += num_inputs;
+  }
+}
+
+static INLINE int nn_int16_stride(int num_inputs) {
+  return ALIGN_POWER_OF_TWO(num_inputs, 4);
+}
+
+// Returns 2^e for e in [-126, 127].
+static INLINE float nn_pow2(int e) {
+  assert(e >= -126 && e <= 127);
+  const union {
+    uint32_t u;
+    float f;
+  } v = { (uint32_t)(e + 127) << 23 };
+  return v.f;
+}
+
+static INLINE int16_t nn_round_to_int16(float x) {
+  return (int16_t)(x >= 0 ? (int)(x + 0.5f) : -(int)(0.5f - x));
+}
+
+// Returns the shift that scales 'max_abs' to exactly 'bits' bits.
+static INLINE int nn_get_shift(float max_abs, int bits) {
+  if (max_abs == 0.0f) return 0;
+  int exp;
+  frexpf(max_abs, &exp);
+  return clamp(bits - exp, -126, 126);
+}
+
+int av1_nn_int16_buffer_size(const NN_CONFIG *const nn_config) {
+  int size = 0;
+  int num_inputs = nn_config->num_inputs;
+  for (int layer = 0; layer <= nn_config->num_hidden_layers; ++layer) {
+    const int num_outputs = layer < nn_config->num_hidden_layers
+                                ? nn_config->num_hidden_nodes[layer]
+                                : nn_config->num_outputs;
+    size += num_outputs * (nn_int16_stride(num_inputs) + 1);
+    num_inputs = num_outputs;
+  }
+  return size;
+}
+
+void av1_nn_quantize_config(const NN_CONFIG *const nn_config,
+                            NN_CONFIG_INT16 *q, int16_t *buf) {
+  q->num_inputs = nn_config->num_inputs;
+  q->num_outputs = nn_config->num_outputs;
+  q->num_hidden_layers = nn_config->num_hidden_layers;
+  memcpy(q->num_hidden_nodes, nn_config->num_hidden_nodes,
+         sizeof(q->num_hidden_nodes));
+  int num_inputs = nn_config->num_inputs;
+  for (int layer = 0; layer <= nn_config->num_hidden_layers; ++layer) {
+    const int num_outputs = layer < nn_config->num_hidden_layers
+                                ? nn_config->num_hidden_nodes[layer]
+                                : nn_config->num_outputs;
+    const int stride = nn_int16_stride(num_inputs);
+    assert(num_inputs <= NN_INT16_MAX_INPUTS);
+    const float *const weights = nn_config->weights[layer];
+    int16_t *const shifts = buf + num_outputs * stride;
+    q->weights[layer] = buf;
+    q->weight_shift[layer] = shifts;
+    q->bias[layer] = nn_config->bias[layer];
+    for (int node = 0; node < num_outputs; ++node) {
+      const float *const w = weights + node * num_inputs;
+      int16_t *const w_q = buf + node * stride;
+      float max_abs = 0.0f;
+      for (int i = 0; i < num_inputs; ++i)
+        max_abs = AOMMAX(max_abs, fabsf(w[i]));
+      const int shift = nn_get_shift(max_abs, NN_INT16_WEIGHT_BITS);
+      const float scale = nn_pow2(shift);
+      for (int i = 0; i < num_inputs; ++i)
+        w_q[i] = nn_round_to_int16(w[i] * scale);
+      for (int i = num_inputs; i < stride; ++i) w_q[i] = 0;
+      shifts[node] = shift;
+    }
+    buf = shifts + num_outputs;
+    num_inputs = num_outputs;
+  }
+}
+
+// Scales the inputs by a power of 2 so that the largest one has
+// NN_INT16_INPUT_BITS bits, and pads them with zeros to 'stride' values.
+// Returns the shift used.
+static int nn_quantize_inputs(const float *input, int num_inputs, int stride,
+                              int16_t *input_q) {
+  float max_abs = 0.0f;
+  for (int i = 0; i < num_inputs; ++i)
+    max_abs = AOMMAX(max_abs, fabsf(input[i]));
+  const int shift = nn_get_shift(max_abs, NN_INT16_INPUT_BITS);
+  const float scale = nn_pow2(shift);
+  for (int i = 0; i < num_inputs; ++i)
+    input_q[i] = nn_round_to_int16(input[i] * scale);
+  for (int i = num_inputs; i < stride; ++i) input_q[i] = 0;
+  return shift;
+}
+
+void av1_nn_predict_int16(const float *input_nodes,
+                          const NN_CONFIG_INT16 *const nn_config,
+                          int reduce_prec, float *const output) {
+  DECLARE_ALIGNED(32, int16_t, input_q[NN_INT16_MAX_INPUTS]);
+  int32_t sums[NN_MAX_NODES_PER_LAYER];
+  float buf[NN_MAX_NODES_PER_LAYER];
+  int num_input_nodes = nn_config->num_inputs;
+
+  const int num_layers = nn_config->num_hidden_layers;
+  assert(num_layers <= NN_MAX_HIDDEN_LAYERS);
+  for (int layer = 0; layer <= num_layers; ++layer) {
+    const int is_output_layer = layer == num_layers;
+    const int num_output_nodes = is_output_layer
+                                     ? nn_config->num_outputs
+                                     : nn_config->num_hidden_nodes[layer];
+    assert(num_output_nodes <= NN_MAX_NODES_PER_LAYER);
+    const int stride = nn_int16_stride(num_input_nodes);
+    const int input_shift =
+        nn_quantize_inputs(input_nodes, num_input_nodes, stride, input_q);
+    av1_nn_fc_int16(input_q, nn_config->weights[layer], stride,
+                    num_output_nodes, sums);
+
+    const int16_t *const weight_shift = nn_config->weight_shift[layer];
+    const float *const bias = nn_config->bias[layer];
+    float *const output_nodes = is_output_layer ? output : buf;
+    for (int node = 0; node < num_output_nodes; ++node) {
+      const int shift = weight_shift[node] + input_shift;
+      // Apply the scale in two steps, as each shift is at most 126.
+      float val = (float)sums[node] * nn_pow2(-(shift / 2)) *
+                  nn_pow2(-(shift - shift / 2));
+      val += bias[node];
+      // ReLU as activation function.
+      if (!is_output_layer) val = val > 0.0f ? val : 0.0f;
+      output_nodes[node] = val;
+    }
+    num_input_nodes = num_output_nodes;
+    input_nodes = buf;
+  }
+  if (reduce_prec) av1_nn_output_prec_reduce(output, nn_config->num_outputs);
+}
+
 #if CONFIG_NN_V2
 // Applies the ReLu activation to one fc layer
 // output[i] = Max(input[i],0.0f)
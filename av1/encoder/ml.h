@@ -34,6 +34,53 @@ struct NN_CONFIG {
 };
 // Typedef from struct NN_CONFIG to NN_CONFIG is in rtcd_defs
 
+// Number of bits of the largest magnitude weight of each node and of the
+// largest magnitude input of each layer of a NN_CONFIG_INT16.
+#define NN_INT16_WEIGHT_BITS 11
+#define NN_INT16_INPUT_BITS 12
+// The weight rows of a NN_CONFIG_INT16 are padded to a multiple of this many
+// inputs.
+#define NN_INT16_INPUT_ALIGN 16
+// Maximum number of inputs of a layer of a NN_CONFIG_INT16. Together with the
+// bit depths above, it keeps the int32 sums of av1_nn_fc_int16() in range.
+#define NN_INT16_MAX_INPUTS 240
+
+// Fixed point version of a NN_CONFIG, built by av1_nn_quantize_config(). The
+// weights of each output node are stored as int16_t, scaled by
+// 2^weight_shift[node] so that the largest one uses NN_INT16_WEIGHT_BITS bits.
+// Each row of weights is padded with zeros to a multiple of
+// NN_INT16_INPUT_ALIGN inputs. The biases stay in floating point.
+typedef struct {
+  int num_inputs;         // Number of input nodes, i.e. features.
+  int num_outputs;        // Number of output nodes.
+  int num_hidden_layers;  // Number of hidden layers, maximum 10.
+  // Number of nodes for each hidden layer.
+  int num_hidden_nodes[NN_MAX_HIDDEN_LAYERS];
+  // Weight parameters, indexed by layer.
+  const int16_t *weights[NN_MAX_HIDDEN_LAYERS + 1];
+  // Scaling shift of the weights of each node, indexed by layer.
+  const int16_t *weight_shift[NN_MAX_HIDDEN_LAYERS + 1];
+  // Bias parameters, indexed by layer.
+  const float *bias[NN_MAX_HIDDEN_LAYERS + 1];
+} NN_CONFIG_INT16;
+
+// Returns the number of int16_t values av1_nn_quantize_config() needs to
+// store the weights of nn_config.
+int av1_nn_int16_buffer_size(const NN_CONFIG *const nn_config);
+
+// Converts the weights of nn_config to fixed point, storing them in buf, which
+// must hold av1_nn_int16_buffer_size(nn_config) values and outlive q.
+void av1_nn_quantize_config(const NN_CONFIG *const nn_config,
+                            NN_CONFIG_INT16 *q, int16_t *buf);
+
+// Fixed point version of av1_nn_predict(). The inputs of each layer are
+// scaled by a power of 2 so that the largest one uses NN_INT16_INPUT_BITS
+// bits, and the weighted sums are computed in integers by av1_nn_fc_int16(),
+// which gives the same result in C and SIMD.
+void av1_nn_predict_int16(const float *input_nodes,
+                          const NN_CONFIG_INT16 *const nn_config,
+                          int reduce_prec, float *const output);
+
 #if CONFIG_NN_V2
 // Fully-connectedly layer configuration
 struct FC_LAYER {
@@ -209,6 +209,16 @@ void av1_single_motion_search(const AV1_COMP *const cpi, MACROBLOCK *x,
 
   switch (mbmi->motion_mode) {
     case SIMPLE_TRANSLATION: {
+      // The hash match only covers the top left corner of the block, so it is
+      // an extra candidate for the regular search.
+      int hash_sme = INT_MAX;
+      FULLPEL_MV hash_mv, hash_second_best_mv;
+      int hash_cost_list[5];
+      if (av1_use_ref_frame_hash_me(cpi) && !scaled_ref_frame) {
+        hash_sme = av1_ref_frame_hash_search(
+            cpi, x, ref, &full_ms_params, cond_cost_list(cpi, hash_cost_list),
+            &hash_mv, &hash_second_best_mv);
+      }
       // Perform a search with the top 2 candidates
       int sum_weight = 0;
       for (int m = 0; m < AOMMIN(2, cnt); m++) {
@@ -228,6 +238,13 @@ void av1_single_motion_search(const AV1_COMP *const cpi, MACROBLOCK *x,
         sum_weight += cand[m].weight;
         if (4 * sum_weight > 3 * total_weight) break;
       }
+      if (hash_sme < bestsme) {
+        bestsme = hash_sme;
+        best_mv->as_fullmv = hash_mv;
+        second_best_mv.as_fullmv = hash_second_best_mv;
+        if (cond_cost_list(cpi, cost_list))
+          memcpy(cost_list, hash_cost_list, sizeof(cost_list));
+      }
     } break;
     case OBMC_CAUSAL:
       bestsme = av1_obmc_full_pixel_search(start_mv, &full_ms_params,
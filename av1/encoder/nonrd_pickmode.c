@@ -230,9 +230,24 @@ static int combined_motion_search(AV1_COMP *cpi, MACROBLOCK *x,
                                      src_search_sites,
                                      /*fine_search_interval=*/0);
 
-  av1_full_pixel_search(start_mv, &full_ms_params, step_param,
-                        cond_cost_list(cpi, cost_list), &tmp_mv->as_fullmv,
-                        NULL);
+  // The hash match only covers the top left corner of the block, so it is an
+  // extra candidate for the regular search.
+  int hash_sme = INT_MAX;
+  FULLPEL_MV hash_mv;
+  int hash_cost_list[5];
+  if (av1_use_ref_frame_hash_me(cpi) && !scaled_ref_frame) {
+    hash_sme = av1_ref_frame_hash_search(cpi, x, ref, &full_ms_params,
+                                         cond_cost_list(cpi, hash_cost_list),
+                                         &hash_mv, NULL);
+  }
+  const int bestsme = av1_full_pixel_search(
+      start_mv, &full_ms_params, step_param, cond_cost_list(cpi, cost_list),
+      &tmp_mv->as_fullmv, NULL);
+  if (hash_sme < bestsme) {
+    tmp_mv->as_fullmv = hash_mv;
+    if (cond_cost_list(cpi, cost_list))
+      memcpy(cost_list, hash_cost_list, sizeof(cost_list));
+  }
 
   // calculate the bit cost on motion vector
   MV mvp_full = get_mv_from_fullmv(&tmp_mv->as_fullmv);
@@ -737,6 +752,42 @@ static void model_rd_for_sb_y(const AV1_COMP *const cpi, BLOCK_SIZE bsize,
   rd_stats->dist = dist;
 }
 
+/*!\brief Points at the luma predictor of a full-pel candidate in its reference
+ *
+ * \ingroup nonrd_mode_search
+ * \callgraph
+ * \callergraph
+ * For an unscaled single reference and a full-pel motion vector whose
+ * position is not clamped by the predictor, the luma predictor is a copy of
+ * the reference block. The mode evaluation can then read the reference
+ * directly and skip building the predictor.
+ *
+ * \param[in]    xd             Pointer to the MACROBLOCKD, with the reference
+ *                              planes set up in pre[0]
+ * \param[in]    mv             Motion vector of the candidate
+ * \param[in]    pred           Pointer to the predictor buffer to set
+ *
+ * \return Returns 1 and sets \c pred if the reference block can be used as
+ * the predictor, 0 otherwise.
+ */
+static INLINE int get_fullpel_ref_pred(const MACROBLOCKD *xd, const MV *mv,
+                                       struct buf_2d *pred) {
+  const struct macroblockd_plane *const pd = &xd->plane[AOM_PLANE_Y];
+  const struct buf_2d *const pre = &pd->pre[0];
+  if (is_cur_buf_hbd(xd) || av1_is_scaled(xd->block_ref_scale_factors[0]))
+    return 0;
+  if ((mv->row & 0x07) || (mv->col & 0x07)) return 0;
+  // The unscaled predictor clamps the motion vector to the UMV border with
+  // clamp_mv_to_umv_border_sb(). The reference block is only the predictor if
+  // that leaves the motion vector unchanged.
+  const MV clamped_mv = clamp_mv_to_umv_border_sb(xd, mv, pd->width,
+                                                  pd->height, 0, 0);
+  if (clamped_mv.row != mv->row * 2 || clamped_mv.col != mv->col * 2) return 0;
+  pred->buf = pre->buf + (mv->row >> 3) * pre->stride + (mv->col >> 3);
+  pred->stride = pre->stride;
+  return 1;
+}
+
 /*!\brief Calculates RD Cost using Hadamard transform.
  *
  * \ingroup nonrd_mode_search
@@ -2465,6 +2516,9 @@ void av1_nonrd_pick_inter_mode_sb(AV1_COMP *cpi, TileDataEnc *tile_data,
     PREDICTION_MODE this_mode;
     MB_MODE_INFO_EXT *const mbmi_ext = &x->mbmi_ext;
     RD_STATS nonskip_rdc;
+    // Set when the luma predictor of this mode is read from the reference.
+    int pred_from_ref = 0;
+    struct buf_2d pred_dst = pd->dst;
     av1_invalid_rd_stats(&nonskip_rdc);
     memset(txfm_info->blk_skip, 0,
            sizeof(txfm_info->blk_skip[0]) * num_8x8_blocks);
@@ -2700,11 +2754,15 @@ void av1_nonrd_pick_inter_mode_sb(AV1_COMP *cpi, TileDataEnc *tile_data,
             mi->interp_filters = av1_broadcast_interp_filter(EIGHTTAP_SMOOTH);
         }
       }
-      if (!comp_pred)
-        av1_enc_build_inter_predictor_y(xd, mi_row, mi_col);
-      else
+      pred_dst = pd->dst;
+      if (!comp_pred) {
+        // A full-pel predictor is only copied out if the mode is picked.
+        pred_from_ref = get_fullpel_ref_pred(xd, &mi->mv[0].as_mv, &pd->dst);
+        if (!pred_from_ref) av1_enc_build_inter_predictor_y(xd, mi_row, mi_col);
+      } else {
         av1_enc_build_inter_predictor(cm, xd, mi_row, mi_col, NULL, bsize, 0,
                                       0);
+      }
 
       if (use_model_yrd_large) {
         model_skip_for_sb_y_large(cpi, bsize, mi_row, mi_col, x, xd, &this_rdc,
@@ -2805,6 +2863,13 @@ void av1_nonrd_pick_inter_mode_sb(AV1_COMP *cpi, TileDataEnc *tile_data,
     (void)sse_y;
 #endif
 
+    if (pred_from_ref) {
+      if (reuse_inter_pred && this_rdc.rdcost < best_rdc.rdcost)
+        aom_convolve_copy(pd->dst.buf, pd->dst.stride, pred_dst.buf,
+                          pred_dst.stride, bw, bh);
+      pd->dst = pred_dst;
+    }
+
     mode_checked[this_mode][ref_frame] = 1;
 #if COLLECT_PICK_MODE_STAT
     aom_usec_timer_mark(&ms_stat.timer1);
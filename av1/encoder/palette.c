@@ -49,6 +49,73 @@ int av1_remove_duplicates(int *centroids, int num_centroids) {
   return num_unique;
 }
 
+static void calc_color_indices(const int *values, int num_values,
+                               const int *centroids, int k, uint8_t *indices) {
+  for (int i = 0; i < num_values; ++i) {
+    int min_dist = (values[i] - centroids[0]) * (values[i] - centroids[0]);
+    indices[i] = 0;
+    for (int j = 1; j < k; ++j) {
+      const int this_dist =
+          (values[i] - centroids[j]) * (values[i] - centroids[j]);
+      if (this_dist < min_dist) {
+        min_dist = this_dist;
+        indices[i] = j;
+      }
+    }
+  }
+}
+
+static int64_t calc_color_total_dist(const int *values, const int *counts,
+                                     int num_values, const int *centroids,
+                                     const uint8_t *indices) {
+  int64_t dist = 0;
+  for (int i = 0; i < num_values; ++i) {
+    const int diff = values[i] - centroids[indices[i]];
+    dist += (int64_t)counts[i] * diff * diff;
+  }
+  return dist;
+}
+
+void av1_k_means_colors(const int *values, const int *counts, int num_values,
+                        const int *data, int n, int *centroids, int k,
+                        int max_itr) {
+  int pre_centroids[PALETTE_MAX_SIZE];
+  uint8_t indices[MAX_PALETTE_COLORS_FOR_K_MEANS];
+  assert(num_values > 0 && num_values <= MAX_PALETTE_COLORS_FOR_K_MEANS);
+  assert(k <= PALETTE_MAX_SIZE);
+
+  calc_color_indices(values, num_values, centroids, k, indices);
+  int64_t this_dist =
+      calc_color_total_dist(values, counts, num_values, centroids, indices);
+
+  for (int i = 0; i < max_itr; ++i) {
+    const int64_t pre_dist = this_dist;
+    memcpy(pre_centroids, centroids, sizeof(pre_centroids[0]) * k);
+
+    int sum[PALETTE_MAX_SIZE] = { 0 };
+    int count[PALETTE_MAX_SIZE] = { 0 };
+    for (int j = 0; j < num_values; ++j) {
+      sum[indices[j]] += values[j] * counts[j];
+      count[indices[j]] += counts[j];
+    }
+    // Empty clusters pick a random data point, as in av1_k_means().
+    unsigned int rand_state = (unsigned int)data[0];
+    for (int j = 0; j < k; ++j) {
+      centroids[j] = count[j] == 0 ? data[lcg_rand16(&rand_state) % n]
+                                   : DIVIDE_AND_ROUND(sum[j], count[j]);
+    }
+
+    calc_color_indices(values, num_values, centroids, k, indices);
+    this_dist =
+        calc_color_total_dist(values, counts, num_values, centroids, indices);
+    if (this_dist > pre_dist) {
+      memcpy(centroids, pre_centroids, sizeof(pre_centroids[0]) * k);
+      break;
+    }
+    if (!memcmp(centroids, pre_centroids, sizeof(pre_centroids[0]) * k)) break;
+  }
+}
+
 static int delta_encode_cost(const int *colors, int num, int bit_depth,
                              int min_val) {
   if (num <= 0) return 0;
@@ -207,6 +274,64 @@ static AOM_INLINE void optimize_palette_colors(uint16_t *color_cache,
   }
 }
 
+// Maximum number of luma palettes searched for a block, see
+// av1_rd_pick_palette_intra_sby().
+#define MAX_EVALUATED_PALETTES \
+  (2 * (PALETTE_MAX_SIZE - PALETTE_MIN_SIZE + 1) + 1)
+
+// The luma palettes of the current block whose transform search was done.
+// The dominant colors and the k-means centroids often give the same palette,
+// notably when the block has few colors, and it need not be searched twice.
+// The mode info and rd of each search are kept so that the winner mode stats
+// of a repeated palette are stored as if it was searched again.
+typedef struct {
+  int colors[MAX_EVALUATED_PALETTES][PALETTE_MAX_SIZE];
+  int size[MAX_EVALUATED_PALETTES];
+  MB_MODE_INFO mbmi[MAX_EVALUATED_PALETTES];
+  int64_t rd[MAX_EVALUATED_PALETTES];
+  int num;
+} EvaluatedPalettes;
+
+// Returns the index of 'colors' in 'evaluated', or -1 if it was not evaluated.
+static AOM_INLINE int find_evaluated_palette(
+    const EvaluatedPalettes *evaluated, const int *colors, int n) {
+  for (int i = 0; i < evaluated->num; ++i) {
+    if (evaluated->size[i] == n &&
+        !memcmp(evaluated->colors[i], colors, n * sizeof(colors[0]))) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+static AOM_INLINE void add_evaluated_palette(EvaluatedPalettes *evaluated,
+                                             const int *colors, int n,
+                                             const MB_MODE_INFO *mbmi,
+                                             int64_t rd) {
+  if (evaluated->num == MAX_EVALUATED_PALETTES) return;
+  memcpy(evaluated->colors[evaluated->num], colors, n * sizeof(colors[0]));
+  evaluated->size[evaluated->num] = n;
+  evaluated->mbmi[evaluated->num] = *mbmi;
+  evaluated->rd[evaluated->num] = rd;
+  ++evaluated->num;
+}
+
+// Returns 1 if 'colors' was evaluated before, after storing its winner mode
+// stats again. Its rd cannot beat the best rd, which was updated with it.
+static AOM_INLINE int check_evaluated_palette(
+    const AV1_COMP *const cpi, MACROBLOCK *x, BLOCK_SIZE bsize,
+    uint8_t *color_map, const EvaluatedPalettes *evaluated, const int *colors,
+    int n) {
+  const int idx = find_evaluated_palette(evaluated, colors, n);
+  if (idx < 0) return 0;
+  const int txfm_search_done = 1;
+  store_winner_mode_stats(&cpi->common, x, &evaluated->mbmi[idx], NULL, NULL,
+                          NULL, THR_DC, color_map, bsize, evaluated->rd[idx],
+                          cpi->sf.winner_mode_sf.multi_winner_mode_type,
+                          txfm_search_done);
+  return 1;
+}
+
 /*!\brief Calculate the luma palette cost from a given color palette
  *
  * \ingroup palette_mode_search
@@ -218,8 +343,9 @@ static AOM_INLINE void palette_rd_y(
     const AV1_COMP *const cpi, MACROBLOCK *x, MB_MODE_INFO *mbmi,
     BLOCK_SIZE bsize, int dc_mode_cost, const int *data, int *centroids, int n,
     uint16_t *color_cache, int n_cache, bool do_header_rd_based_gating,
-    MB_MODE_INFO *best_mbmi, uint8_t *best_palette_color_map, int64_t *best_rd,
-    int *rate, int *rate_tokenonly, int64_t *distortion, int *skippable,
+    EvaluatedPalettes *evaluated, MB_MODE_INFO *best_mbmi,
+    uint8_t *best_palette_color_map, int64_t *best_rd, int *rate,
+    int *rate_tokenonly, int64_t *distortion, int *skippable,
     int *beat_best_rd, PICK_MODE_CONTEXT *ctx, uint8_t *blk_skip,
     uint8_t *tx_type_map, int *beat_best_palette_rd,
     bool *do_header_rd_based_breakout) {
@@ -272,14 +398,28 @@ static AOM_INLINE void palette_rd_y(
       *do_header_rd_based_breakout = true;
       return;
     }
+    if (check_evaluated_palette(cpi, x, bsize, color_map, evaluated,
+                                centroids, num_unique_colors))
+      return;
     av1_pick_uniform_tx_size_type_yrd(cpi, x, &tokenonly_rd_stats, bsize,
                                       *best_rd);
-    if (tokenonly_rd_stats.rate == INT_MAX) return;
+    if (tokenonly_rd_stats.rate == INT_MAX) {
+      add_evaluated_palette(evaluated, centroids, num_unique_colors, mbmi,
+                            INT64_MAX);
+      return;
+    }
     this_rate = tokenonly_rd_stats.rate + palette_mode_rate;
   } else {
+    if (check_evaluated_palette(cpi, x, bsize, color_map, evaluated,
+                                centroids, num_unique_colors))
+      return;
     av1_pick_uniform_tx_size_type_yrd(cpi, x, &tokenonly_rd_stats, bsize,
                                       *best_rd);
-    if (tokenonly_rd_stats.rate == INT_MAX) return;
+    if (tokenonly_rd_stats.rate == INT_MAX) {
+      add_evaluated_palette(evaluated, centroids, num_unique_colors, mbmi,
+                            INT64_MAX);
+      return;
+    }
     this_rate = tokenonly_rd_stats.rate +
                 intra_mode_info_cost_y(cpi, x, mbmi, bsize, dc_mode_cost);
   }
@@ -293,6 +433,8 @@ static AOM_INLINE void palette_rd_y(
   store_winner_mode_stats(
       &cpi->common, x, mbmi, NULL, NULL, NULL, THR_DC, color_map, bsize,
       this_rd, cpi->sf.winner_mode_sf.multi_winner_mode_type, txfm_search_done);
+  add_evaluated_palette(evaluated, centroids, num_unique_colors, mbmi,
+                        this_rd);
   if (this_rd < *best_rd) {
     *best_rd = this_rd;
     // Setting beat_best_rd flag because current mode rd is better than best_rd.
@@ -326,8 +468,9 @@ static AOM_INLINE int perform_top_color_palette_search(
     BLOCK_SIZE bsize, int dc_mode_cost, const int *data, int *top_colors,
     int start_n, int end_n, int step_size, bool do_header_rd_based_gating,
     int *last_n_searched, uint16_t *color_cache, int n_cache,
-    MB_MODE_INFO *best_mbmi, uint8_t *best_palette_color_map, int64_t *best_rd,
-    int *rate, int *rate_tokenonly, int64_t *distortion, int *skippable,
+    EvaluatedPalettes *evaluated, MB_MODE_INFO *best_mbmi,
+    uint8_t *best_palette_color_map, int64_t *best_rd, int *rate,
+    int *rate_tokenonly, int64_t *distortion, int *skippable,
     int *beat_best_rd, PICK_MODE_CONTEXT *ctx, uint8_t *best_blk_skip,
     uint8_t *tx_type_map) {
   int centroids[PALETTE_MAX_SIZE];
@@ -342,10 +485,10 @@ static AOM_INLINE int perform_top_color_palette_search(
     bool do_header_rd_based_breakout = false;
     memcpy(centroids, top_colors, n * sizeof(top_colors[0]));
     palette_rd_y(cpi, x, mbmi, bsize, dc_mode_cost, data, centroids, n,
-                 color_cache, n_cache, do_header_rd_based_gating, best_mbmi,
-                 best_palette_color_map, best_rd, rate, rate_tokenonly,
-                 distortion, skippable, beat_best_rd, ctx, best_blk_skip,
-                 tx_type_map, &beat_best_palette_rd,
+                 color_cache, n_cache, do_header_rd_based_gating, evaluated,
+                 best_mbmi, best_palette_color_map, best_rd, rate,
+                 rate_tokenonly, distortion, skippable, beat_best_rd, ctx,
+                 best_blk_skip, tx_type_map, &beat_best_palette_rd,
                  &do_header_rd_based_breakout);
     *last_n_searched = n;
     if (do_header_rd_based_breakout) {
@@ -367,17 +510,19 @@ static AOM_INLINE int perform_top_color_palette_search(
 // Performs k-means based palette search with number of colors in interval
 // [start_n, end_n) with step size step_size. If step_size < 0, then end_n can
 // be less than start_n. Saves the last numbers searched in last_n_searched and
-// returns the best number of colors found.
+// returns the best number of colors found. When num_colors > 0, the clustering
+// is done on the distinct colors of the block, color_values and color_counts.
 static AOM_INLINE int perform_k_means_palette_search(
     const AV1_COMP *const cpi, MACROBLOCK *x, MB_MODE_INFO *mbmi,
     BLOCK_SIZE bsize, int dc_mode_cost, const int *data, int lower_bound,
     int upper_bound, int start_n, int end_n, int step_size,
     bool do_header_rd_based_gating, int *last_n_searched, uint16_t *color_cache,
-    int n_cache, MB_MODE_INFO *best_mbmi, uint8_t *best_palette_color_map,
-    int64_t *best_rd, int *rate, int *rate_tokenonly, int64_t *distortion,
-    int *skippable, int *beat_best_rd, PICK_MODE_CONTEXT *ctx,
-    uint8_t *best_blk_skip, uint8_t *tx_type_map, uint8_t *color_map,
-    int data_points) {
+    int n_cache, EvaluatedPalettes *evaluated, MB_MODE_INFO *best_mbmi,
+    uint8_t *best_palette_color_map, int64_t *best_rd, int *rate,
+    int *rate_tokenonly, int64_t *distortion, int *skippable,
+    int *beat_best_rd, PICK_MODE_CONTEXT *ctx, uint8_t *best_blk_skip,
+    uint8_t *tx_type_map, uint8_t *color_map, int data_points,
+    const int *color_values, const int *color_counts, int num_colors) {
   int centroids[PALETTE_MAX_SIZE];
   const int max_itr = 50;
   int n = start_n;
@@ -393,12 +538,17 @@ static AOM_INLINE int perform_k_means_palette_search(
       centroids[i] =
           lower_bound + (2 * i + 1) * (upper_bound - lower_bound) / n / 2;
     }
-    av1_k_means(data, centroids, color_map, data_points, n, 1, max_itr);
+    if (num_colors > 0) {
+      av1_k_means_colors(color_values, color_counts, num_colors, data,
+                         data_points, centroids, n, max_itr);
+    } else {
+      av1_k_means(data, centroids, color_map, data_points, n, 1, max_itr);
+    }
     palette_rd_y(cpi, x, mbmi, bsize, dc_mode_cost, data, centroids, n,
-                 color_cache, n_cache, do_header_rd_based_gating, best_mbmi,
-                 best_palette_color_map, best_rd, rate, rate_tokenonly,
-                 distortion, skippable, beat_best_rd, ctx, best_blk_skip,
-                 tx_type_map, &beat_best_palette_rd,
+                 color_cache, n_cache, do_header_rd_based_gating, evaluated,
+                 best_mbmi, best_palette_color_map, best_rd, rate,
+                 rate_tokenonly, distortion, skippable, beat_best_rd, ctx,
+                 best_blk_skip, tx_type_map, &beat_best_palette_rd,
                  &do_header_rd_based_breakout);
     *last_n_searched = n;
     if (do_header_rd_based_breakout) {
@@ -467,6 +617,42 @@ static AOM_INLINE void fill_data_and_get_bounds(
   }
 }
 
+// Finds the n_top most frequent levels of count_buf in one pass, ordered by
+// count and then by level, and returns them in top_colors. Also lists the
+// distinct levels in ascending order in color_values with their counts in
+// color_counts, and returns how many there are, or 0 if there are more than
+// MAX_PALETTE_COLORS_FOR_K_MEANS.
+static int get_block_colors(const int *count_buf, int num_levels, int n_top,
+                            int *top_colors, int *color_values,
+                            int *color_counts) {
+  int top_counts[PALETTE_MAX_SIZE];
+  int num_top = 0;
+  int num_colors = 0;
+  for (int j = 0; j < num_levels; ++j) {
+    const int count = count_buf[j];
+    if (count == 0) continue;
+    if (num_colors <= MAX_PALETTE_COLORS_FOR_K_MEANS) {
+      if (num_colors < MAX_PALETTE_COLORS_FOR_K_MEANS) {
+        color_values[num_colors] = j;
+        color_counts[num_colors] = count;
+      }
+      ++num_colors;
+    }
+    if (num_top == n_top && count <= top_counts[n_top - 1]) continue;
+    int i = AOMMIN(num_top, n_top - 1);
+    while (i > 0 && top_counts[i - 1] < count) {
+      top_counts[i] = top_counts[i - 1];
+      top_colors[i] = top_colors[i - 1];
+      --i;
+    }
+    top_counts[i] = count;
+    top_colors[i] = j;
+    if (num_top < n_top) ++num_top;
+  }
+  assert(num_top == n_top);
+  return num_colors <= MAX_PALETTE_COLORS_FOR_K_MEANS ? num_colors : 0;
+}
+
 void av1_rd_pick_palette_intra_sby(
     const AV1_COMP *cpi, MACROBLOCK *x, BLOCK_SIZE bsize, int dc_mode_cost,
     MB_MODE_INFO *best_mbmi, uint8_t *best_palette_color_map, int64_t *best_rd,
@@ -516,19 +702,16 @@ void av1_rd_pick_palette_intra_sby(
     uint16_t color_cache[2 * PALETTE_MAX_SIZE];
     const int n_cache = av1_get_palette_cache(xd, 0, color_cache);
 
-    // Find the dominant colors, stored in top_colors[].
+    // Find the dominant colors, stored in top_colors[], and the distinct
+    // colors of the block for k-means.
     int top_colors[PALETTE_MAX_SIZE] = { 0 };
-    for (int i = 0; i < AOMMIN(colors, PALETTE_MAX_SIZE); ++i) {
-      int max_count = 0;
-      for (int j = 0; j < (1 << bit_depth); ++j) {
-        if (count_buf[j] > max_count) {
-          max_count = count_buf[j];
-          top_colors[i] = j;
-        }
-      }
-      assert(max_count > 0);
-      count_buf[top_colors[i]] = 0;
-    }
+    int color_values[MAX_PALETTE_COLORS_FOR_K_MEANS];
+    int color_counts[MAX_PALETTE_COLORS_FOR_K_MEANS];
+    const int num_colors = get_block_colors(
+        count_buf, 1 << bit_depth, AOMMIN(colors, PALETTE_MAX_SIZE),
+        top_colors, color_values, color_counts);
+    EvaluatedPalettes evaluated;
+    evaluated.num = 0;
 
     // The following are the approaches used for header rdcost based gating
     // for early termination for different values of prune_palette_search_level.
@@ -580,8 +763,9 @@ void av1_rd_pick_palette_intra_sby(
       const int top_color_winner = perform_top_color_palette_search(
           cpi, x, mbmi, bsize, dc_mode_cost, data, top_colors, min_n, max_n + 1,
           step_size, do_header_rd_based_gating, &unused, color_cache, n_cache,
-          best_mbmi, best_palette_color_map, best_rd, rate, rate_tokenonly,
-          distortion, skippable, beat_best_rd, ctx, best_blk_skip, tx_type_map);
+          &evaluated, best_mbmi, best_palette_color_map, best_rd, rate,
+          rate_tokenonly, distortion, skippable, beat_best_rd, ctx,
+          best_blk_skip, tx_type_map);
       // Evaluate neighbors for the winner color (if winner is found) in the
       // above coarse search for dominant colors
       if (top_color_winner <= max_n) {
@@ -593,18 +777,19 @@ void av1_rd_pick_palette_intra_sby(
             cpi, x, mbmi, bsize, dc_mode_cost, data, top_colors, stage2_min_n,
             stage2_max_n + 1, stage2_step_size,
             /*do_header_rd_based_gating=*/false, &unused, color_cache, n_cache,
-            best_mbmi, best_palette_color_map, best_rd, rate, rate_tokenonly,
-            distortion, skippable, beat_best_rd, ctx, best_blk_skip,
-            tx_type_map);
+            &evaluated, best_mbmi, best_palette_color_map, best_rd, rate,
+            rate_tokenonly, distortion, skippable, beat_best_rd, ctx,
+            best_blk_skip, tx_type_map);
       }
       // K-means clustering.
       // Perform k-means coarse palette search to find the winner candidate
       const int k_means_winner = perform_k_means_palette_search(
           cpi, x, mbmi, bsize, dc_mode_cost, data, lower_bound, upper_bound,
           min_n, max_n + 1, step_size, do_header_rd_based_gating, &unused,
-          color_cache, n_cache, best_mbmi, best_palette_color_map, best_rd,
-          rate, rate_tokenonly, distortion, skippable, beat_best_rd, ctx,
-          best_blk_skip, tx_type_map, color_map, rows * cols);
+          color_cache, n_cache, &evaluated, best_mbmi, best_palette_color_map,
+          best_rd, rate, rate_tokenonly, distortion, skippable, beat_best_rd,
+          ctx, best_blk_skip, tx_type_map, color_map, rows * cols,
+          color_values, color_counts, num_colors);
       // Evaluate neighbors for the winner color (if winner is found) in the
       // above coarse search for k-means
       if (k_means_winner <= max_n) {
@@ -616,9 +801,10 @@ void av1_rd_pick_palette_intra_sby(
             cpi, x, mbmi, bsize, dc_mode_cost, data, lower_bound, upper_bound,
             start_n_stage2, end_n_stage2 + 1, step_size_stage2,
             /*do_header_rd_based_gating=*/false, &unused, color_cache, n_cache,
-            best_mbmi, best_palette_color_map, best_rd, rate, rate_tokenonly,
-            distortion, skippable, beat_best_rd, ctx, best_blk_skip,
-            tx_type_map, color_map, rows * cols);
+            &evaluated, best_mbmi, best_palette_color_map, best_rd, rate,
+            rate_tokenonly, distortion, skippable, beat_best_rd, ctx,
+            best_blk_skip, tx_type_map, color_map, rows * cols, color_values,
+            color_counts, num_colors);
       }
     } else {
       const int max_n = AOMMIN(colors, PALETTE_MAX_SIZE),
@@ -628,16 +814,17 @@ void av1_rd_pick_palette_intra_sby(
       perform_top_color_palette_search(
           cpi, x, mbmi, bsize, dc_mode_cost, data, top_colors, min_n, max_n + 1,
           1, do_header_rd_based_gating, &last_n_searched, color_cache, n_cache,
-          best_mbmi, best_palette_color_map, best_rd, rate, rate_tokenonly,
-          distortion, skippable, beat_best_rd, ctx, best_blk_skip, tx_type_map);
+          &evaluated, best_mbmi, best_palette_color_map, best_rd, rate,
+          rate_tokenonly, distortion, skippable, beat_best_rd, ctx,
+          best_blk_skip, tx_type_map);
       if (last_n_searched < max_n) {
         // Search in descending order until we get to the previous best
         perform_top_color_palette_search(
             cpi, x, mbmi, bsize, dc_mode_cost, data, top_colors, max_n,
             last_n_searched, -1, /*do_header_rd_based_gating=*/false, &unused,
-            color_cache, n_cache, best_mbmi, best_palette_color_map, best_rd,
-            rate, rate_tokenonly, distortion, skippable, beat_best_rd, ctx,
-            best_blk_skip, tx_type_map);
+            color_cache, n_cache, &evaluated, best_mbmi,
+            best_palette_color_map, best_rd, rate, rate_tokenonly, distortion,
+            skippable, beat_best_rd, ctx, best_blk_skip, tx_type_map);
       }
       // K-means clustering.
       if (colors == PALETTE_MIN_SIZE) {
@@ -647,27 +834,29 @@ void av1_rd_pick_palette_intra_sby(
         centroids[1] = upper_bound;
         palette_rd_y(cpi, x, mbmi, bsize, dc_mode_cost, data, centroids, colors,
                      color_cache, n_cache, /*do_header_rd_based_gating=*/false,
-                     best_mbmi, best_palette_color_map, best_rd, rate,
-                     rate_tokenonly, distortion, skippable, beat_best_rd, ctx,
-                     best_blk_skip, tx_type_map, NULL, NULL);
+                     &evaluated, best_mbmi, best_palette_color_map, best_rd,
+                     rate, rate_tokenonly, distortion, skippable, beat_best_rd,
+                     ctx, best_blk_skip, tx_type_map, NULL, NULL);
       } else {
         // Perform k-means palette search in ascending order
         last_n_searched = min_n;
         perform_k_means_palette_search(
             cpi, x, mbmi, bsize, dc_mode_cost, data, lower_bound, upper_bound,
             min_n, max_n + 1, 1, do_header_rd_based_gating, &last_n_searched,
-            color_cache, n_cache, best_mbmi, best_palette_color_map, best_rd,
-            rate, rate_tokenonly, distortion, skippable, beat_best_rd, ctx,
-            best_blk_skip, tx_type_map, color_map, rows * cols);
+            color_cache, n_cache, &evaluated, best_mbmi, best_palette_color_map,
+            best_rd, rate, rate_tokenonly, distortion, skippable, beat_best_rd,
+            ctx, best_blk_skip, tx_type_map, color_map, rows * cols,
+            color_values, color_counts, num_colors);
         if (last_n_searched < max_n) {
           // Search in descending order until we get to the previous best
           perform_k_means_palette_search(
               cpi, x, mbmi, bsize, dc_mode_cost, data, lower_bound, upper_bound,
               max_n, last_n_searched, -1, /*do_header_rd_based_gating=*/false,
-              &unused, color_cache, n_cache, best_mbmi, best_palette_color_map,
-              best_rd, rate, rate_tokenonly, distortion, skippable,
-              beat_best_rd, ctx, best_blk_skip, tx_type_map, color_map,
-              rows * cols);
+              &unused, color_cache, n_cache, &evaluated, best_mbmi,
+              best_palette_color_map, best_rd, rate, rate_tokenonly,
+              distortion, skippable, beat_best_rd, ctx, best_blk_skip,
+              tx_type_map, color_map, rows * cols, color_values, color_counts,
+              num_colors);
         }
       }
     }
@@ -98,6 +98,37 @@ static INLINE void av1_k_means(const int *data, int *centroids,
   }
 }
 
+/*!\cond */
+// Maximum number of distinct colors of a block clustered with
+// av1_k_means_colors().
+#define MAX_PALETTE_COLORS_FOR_K_MEANS 64
+/*!\endcond */
+
+/*!\brief Performs k-means clustering on the distinct colors of a block.
+ *
+ * \ingroup palette_mode_search
+ * \param[in]    values             The distinct colors of the block.
+ * \param[in]    counts             The number of pixels of each color.
+ * \param[in]    num_values         Number of distinct colors, at most
+ *                                  MAX_PALETTE_COLORS_FOR_K_MEANS.
+ * \param[in]    data               The pixels of the block, only used to
+ *                                  reseed empty clusters.
+ * \param[in]    n                  Number of pixels.
+ * \param[in]    centroids          The initial centroids, and the computed
+ *                                  centroids on return.
+ * \param[in]    k                  Number of clusters.
+ * \param[in]    max_itr            Maximum number of iterations to run.
+ *
+ * \return Returns nothing, but saves each cluster's centroid in centroids.
+ *
+ * \attention The centroids are the same as the ones av1_k_means() computes on
+ * data with dim 1, at the cost of the number of colors rather than pixels per
+ * iteration.
+ */
+void av1_k_means_colors(const int *values, const int *counts, int num_values,
+                        const int *data, int n, int *centroids, int k,
+                        int max_itr);
+
 /*!\brief Removes duplicated centroid indices.
  *
  * \ingroup palette_mode_search
@@ -128,108 +128,98 @@ static void write_features_to_file(const char *const path,
   fclose(pfile);
 }
 
-// TODO(chiyotsai@google.com): This is very much a work in progress. We still
-// need to the following:
-//   -- add support for hdres
-//   -- add support for pruning rectangular partitions
-//   -- use reconstructed pixels instead of source pixels for padding
-//   -- use chroma pixels in addition to luma pixels
-void av1_intra_mode_cnn_partition(const AV1_COMMON *const cm, MACROBLOCK *x,
-                                  int quad_tree_idx,
-                                  int intra_cnn_based_part_prune_level,
-                                  PartitionSearchState *part_state) {
-  assert(cm->seq_params->sb_size >= BLOCK_64X64 &&
-         "Invalid sb_size for intra_cnn!");
-  const PartitionBlkParams *blk_params = &part_state->part_blk_params;
-  const BLOCK_SIZE bsize = blk_params->bsize;
-
-  const int bsize_idx = convert_bsize_to_idx(bsize);
-
-  if (bsize == BLOCK_128X128) {
-    return;
-  }
-
-  PartitionSearchInfo *part_info = &x->part_search_info;
-
-  // Precompute the CNN part and cache the result in MACROBLOCK
-  if (bsize == BLOCK_64X64 && !part_info->cnn_output_valid) {
-    const CNN_CONFIG *cnn_config = &av1_intra_mode_cnn_partition_cnn_config;
-
-    // Prepare the output
-    const CNN_THREAD_DATA thread_data = { .num_workers = 1, .workers = NULL };
-    const int num_outputs = 4;
-    const int output_dims[4] = { 1, 2, 4, 8 };
-    const int out_chs[4] = { CNN_BRANCH_0_OUT_CH, CNN_BRANCH_1_OUT_CH,
-                             CNN_BRANCH_2_OUT_CH, CNN_BRANCH_3_OUT_CH };
-    float *output_buffer[CNN_TOT_OUT_CH];
-
-    float **cur_output_buf = output_buffer;
-    float *curr_buf_ptr = part_info->cnn_buffer;
-    for (int output_idx = 0; output_idx < num_outputs; output_idx++) {
-      const int num_chs = out_chs[output_idx];
-      const int ch_size = output_dims[output_idx] * output_dims[output_idx];
-      for (int ch = 0; ch < num_chs; ch++) {
-        cur_output_buf[ch] = curr_buf_ptr;
-        curr_buf_ptr += ch_size;
-      }
-      cur_output_buf += num_chs;
+// Runs the intra mode partition CNN on the 64x64 luma block at 'src', whose
+// input also covers the row above and the column to the left of the block.
+// The four outputs are stored back to back in 'cnn_buffer', which holds
+// CNN_OUT_BUF_SIZE floats.
+static void intra_mode_cnn_predict(const uint8_t *src, int stride, int is_hbd,
+                                   int bit_depth, float *cnn_buffer) {
+  const CNN_CONFIG *cnn_config = &av1_intra_mode_cnn_partition_cnn_config;
+
+  // Prepare the output
+  const CNN_THREAD_DATA thread_data = { .num_workers = 1, .workers = NULL };
+  const int num_outputs = 4;
+  const int output_dims[4] = { 1, 2, 4, 8 };
+  const int out_chs[4] = { CNN_BRANCH_0_OUT_CH, CNN_BRANCH_1_OUT_CH,
+                           CNN_BRANCH_2_OUT_CH, CNN_BRANCH_3_OUT_CH };
+  float *output_buffer[CNN_TOT_OUT_CH];
+
+  float **cur_output_buf = output_buffer;
+  float *curr_buf_ptr = cnn_buffer;
+  for (int output_idx = 0; output_idx < num_outputs; output_idx++) {
+    const int num_chs = out_chs[output_idx];
+    const int ch_size = output_dims[output_idx] * output_dims[output_idx];
+    for (int ch = 0; ch < num_chs; ch++) {
+      cur_output_buf[ch] = curr_buf_ptr;
+      curr_buf_ptr += ch_size;
     }
+    cur_output_buf += num_chs;
+  }
 
-    CNN_MULTI_OUT output = {
-      .num_outputs = 4,
-      .output_channels = out_chs,
-      .output_strides = output_dims,
-      .output_buffer = output_buffer,
-    };
-
-    // Prepare the input
-    const MACROBLOCKD *xd = &x->e_mbd;
-    const int bit_depth = xd->bd;
-    const int dc_q =
-        av1_dc_quant_QTX(x->qindex, 0, bit_depth) >> (bit_depth - 8);
-    part_info->log_q = logf(1.0f + (float)(dc_q * dc_q) / 256.0f);
-    part_info->log_q =
-        (part_info->log_q - av1_intra_mode_cnn_partition_mean[0]) /
-        av1_intra_mode_cnn_partition_std[0];
-
-    const int width = 65, height = 65,
-              stride = x->plane[AOM_PLANE_Y].src.stride;
+  CNN_MULTI_OUT output = {
+    .num_outputs = 4,
+    .output_channels = out_chs,
+    .output_strides = output_dims,
+    .output_buffer = output_buffer,
+  };
 
-    if (xd->cur_buf->flags & YV12_FLAG_HIGHBITDEPTH) {
-      uint16_t *image[1] = {
-        CONVERT_TO_SHORTPTR(x->plane[AOM_PLANE_Y].src.buf) - stride - 1
-      };
+  // Prepare the input
+  const int width = 65, height = 65;
 
-      av1_cnn_predict_img_multi_out_highbd(image, width, height, stride,
-                                           cnn_config, &thread_data, bit_depth,
-                                           &output);
-    } else {
-      uint8_t *image[1] = { x->plane[AOM_PLANE_Y].src.buf - stride - 1 };
+  if (is_hbd) {
+    uint16_t *image[1] = { CONVERT_TO_SHORTPTR(src) - stride - 1 };
 
-      av1_cnn_predict_img_multi_out(image, width, height, stride, cnn_config,
-                                    &thread_data, &output);
-    }
-
-    part_info->cnn_output_valid = 1;
-  }
+    av1_cnn_predict_img_multi_out_highbd(image, width, height, stride,
+                                         cnn_config, &thread_data, bit_depth,
+                                         &output);
+  } else {
+    uint8_t *image[1] = { (uint8_t *)src - stride - 1 };
 
-  if (!part_info->cnn_output_valid) {
-    return;
+    av1_cnn_predict_img_multi_out(image, width, height, stride, cnn_config,
+                                  &thread_data, &output);
   }
+}
 
-  const NN_CONFIG *dnn_configs[5] = {
-    NULL,
-    &av1_intra_mode_cnn_partition_branch_0_dnn_config,
-    &av1_intra_mode_cnn_partition_branch_1_dnn_config,
-    &av1_intra_mode_cnn_partition_branch_2_dnn_config,
-    &av1_intra_mode_cnn_partition_branch_3_dnn_config,
-  };
+int av1_use_intra_cnn_frame_output(const AV1_COMP *const cpi) {
+  const AV1_COMMON *const cm = &cpi->common;
+  return frame_is_intra_only(cm) &&
+         cpi->sf.part_sf.intra_cnn_based_part_prune_level &&
+         cpi->sf.part_sf.partition_search_type == SEARCH_PARTITION &&
+         !cpi->sf.rt_sf.use_nonrd_pick_mode &&
+         cm->seq_params->sb_size >= BLOCK_64X64;
+}
 
-  const NN_CONFIG *dnn_config = dnn_configs[bsize_idx];
+void av1_alloc_intra_cnn_output(AV1_COMP *const cpi) {
+  AV1_COMMON *const cm = &cpi->common;
+  const int num_blocks = av1_get_intra_cnn_output_rows(&cm->mi_params) *
+                         av1_get_intra_cnn_output_cols(&cm->mi_params);
+  aom_free(cpi->intra_cnn_output);
+  CHECK_MEM_ERROR(cm, cpi->intra_cnn_output,
+                  aom_malloc(sizeof(*cpi->intra_cnn_output) *
+                             AOMMAX(num_blocks, 1) * CNN_OUT_BUF_SIZE));
+}
 
-  float dnn_features[100];
-  float logits[4] = { 0.0f };
+void av1_intra_mode_cnn_predict_blocks(const AV1_COMP *const cpi,
+                                       int block_start, int block_end) {
+  const AV1_COMMON *const cm = &cpi->common;
+  const YV12_BUFFER_CONFIG *const source = cpi->source;
+  const int is_hbd = (source->flags & YV12_FLAG_HIGHBITDEPTH) != 0;
+  const int stride = source->y_stride;
+  const int cols = av1_get_intra_cnn_output_cols(&cm->mi_params);
+  for (int idx = block_start; idx < block_end; idx++) {
+    const int y = (idx / cols) * block_size_high[BLOCK_64X64];
+    const int x = (idx % cols) * block_size_wide[BLOCK_64X64];
+    intra_mode_cnn_predict(source->y_buffer + y * stride + x, stride, is_hbd,
+                           cm->seq_params->bit_depth,
+                           cpi->intra_cnn_output + idx * CNN_OUT_BUF_SIZE);
+  }
+}
 
+// Gathers the features of the partition DNN of quad tree node quad_tree_idx
+// from the CNN output.
+static void get_intra_cnn_dnn_features(const PartitionSearchInfo *part_info,
+                                       BLOCK_SIZE bsize, int quad_tree_idx,
+                                       float *features) {
   const float *branch_0 = part_info->cnn_buffer;
   const float *branch_1 = branch_0 + CNN_BRANCH_0_OUT_SIZE;
   const float *branch_2 = branch_1 + CNN_BRANCH_1_OUT_SIZE;
@@ -238,64 +228,162 @@ void av1_intra_mode_cnn_partition(const AV1_COMMON *const cm, MACROBLOCK *x,
   if (bsize == BLOCK_64X64) {
     int f_idx = 0;
     for (int ch_idx = 0; ch_idx < CNN_BRANCH_0_OUT_CH; ch_idx++) {
-      dnn_features[f_idx++] = branch_0[ch_idx];
+      features[f_idx++] = branch_0[ch_idx];
     }
 
     const int spa_stride = 2 * 2;
     for (int lin_idx = 0; lin_idx < spa_stride; lin_idx++) {
       for (int ch_idx = 0; ch_idx < CNN_BRANCH_1_OUT_CH; ch_idx++) {
-        dnn_features[f_idx++] = branch_1[lin_idx + ch_idx * spa_stride];
+        features[f_idx++] = branch_1[lin_idx + ch_idx * spa_stride];
       }
     }
-    dnn_features[f_idx++] = part_info->log_q;
+    features[f_idx++] = part_info->log_q;
   } else if (bsize == BLOCK_32X32) {
     int f_idx = 0;
     for (int idx = 0; idx < CNN_BRANCH_0_OUT_CH; idx++) {
-      dnn_features[f_idx++] = branch_0[idx];
+      features[f_idx++] = branch_0[idx];
     }
 
     const int curr_lin_idx = quad_to_linear_1[quad_tree_idx - 1];
     const int spa_stride = 2 * 2;
     for (int ch_idx = 0; ch_idx < CNN_BRANCH_1_OUT_CH; ch_idx++) {
-      dnn_features[f_idx++] = branch_1[curr_lin_idx + ch_idx * spa_stride];
+      features[f_idx++] = branch_1[curr_lin_idx + ch_idx * spa_stride];
     }
-    dnn_features[f_idx++] = part_info->log_q;
+    features[f_idx++] = part_info->log_q;
   } else if (bsize == BLOCK_16X16) {
     int f_idx = 0;
     const int prev_quad_idx = (quad_tree_idx - 1) / 4;
     const int prev_lin_idx = quad_to_linear_1[prev_quad_idx - 1];
     const int prev_spa_stride = 2 * 2;
     for (int ch_idx = 0; ch_idx < CNN_BRANCH_1_OUT_CH; ch_idx++) {
-      dnn_features[f_idx++] = branch_1[prev_lin_idx + ch_idx * prev_spa_stride];
+      features[f_idx++] = branch_1[prev_lin_idx + ch_idx * prev_spa_stride];
     }
 
     const int curr_lin_idx = quad_to_linear_2[quad_tree_idx - 5];
     const int spa_stride = 4 * 4;
     for (int ch_idx = 0; ch_idx < CNN_BRANCH_2_OUT_CH; ch_idx++) {
-      dnn_features[f_idx++] = branch_2[curr_lin_idx + ch_idx * spa_stride];
+      features[f_idx++] = branch_2[curr_lin_idx + ch_idx * spa_stride];
     }
-    dnn_features[f_idx++] = part_info->log_q;
+    features[f_idx++] = part_info->log_q;
   } else if (bsize == BLOCK_8X8) {
     int f_idx = 0;
     const int prev_quad_idx = (quad_tree_idx - 1) / 4;
     const int prev_lin_idx = quad_to_linear_2[prev_quad_idx - 5];
     const int prev_spa_stride = 4 * 4;
     for (int ch_idx = 0; ch_idx < CNN_BRANCH_2_OUT_CH; ch_idx++) {
-      dnn_features[f_idx++] = branch_2[prev_lin_idx + ch_idx * prev_spa_stride];
+      features[f_idx++] = branch_2[prev_lin_idx + ch_idx * prev_spa_stride];
     }
 
     const int curr_lin_idx = quad_to_linear_3[quad_tree_idx - 21];
     const int spa_stride = 8 * 8;
     for (int ch_idx = 0; ch_idx < CNN_BRANCH_3_OUT_CH; ch_idx++) {
-      dnn_features[f_idx++] = branch_3[curr_lin_idx + ch_idx * spa_stride];
+      features[f_idx++] = branch_3[curr_lin_idx + ch_idx * spa_stride];
     }
-    dnn_features[f_idx++] = part_info->log_q;
+    features[f_idx++] = part_info->log_q;
   } else {
     assert(0 && "Invalid bsize in intra_cnn partition");
   }
+}
 
-  // Make decision
-  av1_nn_predict(dnn_features, dnn_config, 1, logits);
+// Returns the DNN logit of quad tree node quad_tree_idx. The siblings of a node
+// use the same network and their features only depend on the CNN output, so
+// the logits of all of them are computed in one batch on the first call.
+static float get_intra_cnn_logit(PartitionSearchInfo *part_info,
+                                 BLOCK_SIZE bsize, int bsize_idx,
+                                 int quad_tree_idx) {
+  assert(quad_tree_idx < INTRA_CNN_QUAD_TREE_NODES);
+  const int group = (quad_tree_idx + 3) / 4;
+  if (!(part_info->cnn_logits_valid & (1u << group))) {
+    static const NN_CONFIG *const dnn_configs[5] = {
+      NULL,
+      &av1_intra_mode_cnn_partition_branch_0_dnn_config,
+      &av1_intra_mode_cnn_partition_branch_1_dnn_config,
+      &av1_intra_mode_cnn_partition_branch_2_dnn_config,
+      &av1_intra_mode_cnn_partition_branch_3_dnn_config,
+    };
+    const NN_CONFIG *const dnn_config = dnn_configs[bsize_idx];
+    assert(dnn_config->num_outputs == 1);
+    const int first_idx = group == 0 ? 0 : 4 * group - 3;
+    const int num_siblings = group == 0 ? 1 : 4;
+    const int num_features = dnn_config->num_inputs;
+    float features[4 * 100];
+    assert(num_features <= 100);
+    for (int i = 0; i < num_siblings; i++) {
+      get_intra_cnn_dnn_features(part_info, bsize, first_idx + i,
+                                 features + i * num_features);
+    }
+    if (num_siblings == 1) {
+      av1_nn_predict(features, dnn_config, 1, &part_info->cnn_logits[0]);
+    } else {
+      av1_nn_predict_batch(features, num_siblings, dnn_config, 1,
+                           &part_info->cnn_logits[first_idx]);
+    }
+    part_info->cnn_logits_valid |= 1u << group;
+  }
+  return part_info->cnn_logits[quad_tree_idx];
+}
+
+// TODO(chiyotsai@google.com): This is very much a work in progress. We still
+// need to the following:
+//   -- add support for hdres
+//   -- add support for pruning rectangular partitions
+//   -- use reconstructed pixels instead of source pixels for padding
+//   -- use chroma pixels in addition to luma pixels
+void av1_intra_mode_cnn_partition(const AV1_COMP *const cpi, MACROBLOCK *x,
+                                  int quad_tree_idx,
+                                  int intra_cnn_based_part_prune_level,
+                                  PartitionSearchState *part_state) {
+  const AV1_COMMON *const cm = &cpi->common;
+  assert(cm->seq_params->sb_size >= BLOCK_64X64 &&
+         "Invalid sb_size for intra_cnn!");
+  const PartitionBlkParams *blk_params = &part_state->part_blk_params;
+  const BLOCK_SIZE bsize = blk_params->bsize;
+
+  const int bsize_idx = convert_bsize_to_idx(bsize);
+
+  if (bsize == BLOCK_128X128) {
+    return;
+  }
+
+  PartitionSearchInfo *part_info = &x->part_search_info;
+
+  // Precompute the CNN part and cache the result in MACROBLOCK
+  if (bsize == BLOCK_64X64 && !part_info->cnn_output_valid) {
+    const MACROBLOCKD *xd = &x->e_mbd;
+    const int bit_depth = xd->bd;
+    const int dc_q =
+        av1_dc_quant_QTX(x->qindex, 0, bit_depth) >> (bit_depth - 8);
+    part_info->log_q = logf(1.0f + (float)(dc_q * dc_q) / 256.0f);
+    part_info->log_q =
+        (part_info->log_q - av1_intra_mode_cnn_partition_mean[0]) /
+        av1_intra_mode_cnn_partition_std[0];
+
+    if (cpi->intra_cnn_output) {
+      // The CNN was already run on the whole frame.
+      const int mi_size_64 = mi_size_wide[BLOCK_64X64];
+      const int idx = (blk_params->mi_row / mi_size_64) *
+                          av1_get_intra_cnn_output_cols(&cm->mi_params) +
+                      blk_params->mi_col / mi_size_64;
+      memcpy(part_info->cnn_buffer,
+             cpi->intra_cnn_output + idx * CNN_OUT_BUF_SIZE,
+             sizeof(part_info->cnn_buffer));
+    } else {
+      intra_mode_cnn_predict(
+          x->plane[AOM_PLANE_Y].src.buf, x->plane[AOM_PLANE_Y].src.stride,
+          (xd->cur_buf->flags & YV12_FLAG_HIGHBITDEPTH) != 0, bit_depth,
+          part_info->cnn_buffer);
+    }
+
+    part_info->cnn_output_valid = 1;
+    part_info->cnn_logits_valid = 0;
+  }
+
+  if (!part_info->cnn_output_valid) {
+    return;
+  }
+
+  const float logit =
+      get_intra_cnn_logit(part_info, bsize, bsize_idx, quad_tree_idx);
 
   const int is_720p_or_larger = AOMMIN(cm->width, cm->height) >= 720;
   const int is_480p_or_larger = AOMMIN(cm->width, cm->height) >= 480;
@@ -317,7 +405,7 @@ void av1_intra_mode_cnn_partition(const AV1_COMMON *const cm, MACROBLOCK *x,
         av1_intra_mode_cnn_partition_no_split_thresh_lowres[bsize_idx];
   }
 
-  if (logits[0] > split_only_thresh) {
+  if (logit > split_only_thresh) {
     // As screen contents tend to choose larger partitions, do not prune
     // PARTITION_NONE when intra_cnn_based_part_prune_level=1.
     if (intra_cnn_based_part_prune_level != 1) {
@@ -327,7 +415,7 @@ void av1_intra_mode_cnn_partition(const AV1_COMMON *const cm, MACROBLOCK *x,
     av1_disable_rect_partitions(part_state);
   }
 
-  if (logits[0] < no_split_thresh) {
+  if (logit < no_split_thresh) {
     av1_disable_square_split_partition(part_state);
   }
 }
@@ -355,6 +443,34 @@ static INLINE int get_simple_motion_search_prune_agg(int qindex,
   return sms_prune_agg_qindex_based[qband];
 }
 
+// Fixed point versions of the simple motion search partition models, used
+// when sf->hl_sf.use_int16_nn_inference is set.
+#define SMS_NN_INT16_BUFFER_SIZE 10240
+static NN_CONFIG_INT16 sms_split_nn_int16[5];
+static NN_CONFIG_INT16 sms_prune_rect_nn_int16[5];
+static int16_t sms_nn_int16_buffer[SMS_NN_INT16_BUFFER_SIZE];
+
+static int16_t *quantize_sms_nn_config(const NN_CONFIG *nn_config,
+                                       NN_CONFIG_INT16 *q, int16_t *buf) {
+  if (!nn_config) return buf;
+  const int size = av1_nn_int16_buffer_size(nn_config);
+  assert(buf + size <= sms_nn_int16_buffer + SMS_NN_INT16_BUFFER_SIZE);
+  av1_nn_quantize_config(nn_config, q, buf);
+  return buf + size;
+}
+
+void av1_init_partition_nn_int16(void) {
+  int16_t *buf = sms_nn_int16_buffer;
+  for (int bsize_idx = 0; bsize_idx < 5; ++bsize_idx) {
+    buf = quantize_sms_nn_config(
+        av1_simple_motion_search_split_nn_config[bsize_idx],
+        &sms_split_nn_int16[bsize_idx], buf);
+    buf = quantize_sms_nn_config(
+        av1_simple_motion_search_prune_rect_nn_config[bsize_idx],
+        &sms_prune_rect_nn_int16[bsize_idx], buf);
+  }
+}
+
 void av1_simple_motion_search_based_split(AV1_COMP *const cpi, MACROBLOCK *x,
                                           SIMPLE_MOTION_DATA_TREE *sms_tree,
                                           PartitionSearchState *part_state) {
@@ -414,7 +530,10 @@ void av1_simple_motion_search_based_split(AV1_COMP *const cpi, MACROBLOCK *x,
 
   float score = 0.0f;
 
-  av1_nn_predict(features, nn_config, 1, &score);
+  if (cpi->sf.hl_sf.use_int16_nn_inference)
+    av1_nn_predict_int16(features, &sms_split_nn_int16[bsize_idx], 1, &score);
+  else
+    av1_nn_predict(features, nn_config, 1, &score);
 
   if (score > split_only_thresh) {
     av1_set_square_split_only(part_state);
@@ -702,7 +821,11 @@ void av1_simple_motion_search_prune_rect(AV1_COMP *const cpi, MACROBLOCK *x,
                               ? PARTITION_TYPES
                               : EXT_PARTITION_TYPES;
 
-  av1_nn_predict(features, nn_config, 1, scores);
+  if (cpi->sf.hl_sf.use_int16_nn_inference)
+    av1_nn_predict_int16(features, &sms_prune_rect_nn_int16[bsize_idx], 1,
+                         scores);
+  else
+    av1_nn_predict(features, nn_config, 1, scores);
 
   av1_nn_softmax(scores, probs, num_classes);
 
@@ -1630,6 +1753,34 @@ void av1_prune_partitions_before_search(AV1_COMP *const cpi,
     }
   }
 
+  // In static superblocks, search around the block sizes of the co-located
+  // blocks in the last frame.
+  const FramePartitionMap *const ref_part_map = x->sb_enc.ref_part_map;
+  if (ref_part_map != NULL) {
+    const BLOCK_SIZE ref_bsize =
+        ref_part_map->bsize[blk_params->mi_row * ref_part_map->mi_cols +
+                            blk_params->mi_col];
+    const int ref_bw = block_size_wide[ref_bsize];
+    const int ref_bh = block_size_high[ref_bsize];
+    const int min_size = AOMMIN(ref_bw, ref_bh);
+    const int max_size = AOMMAX(ref_bw, ref_bh);
+    const int bw = block_size_wide[bsize];
+    if (bw > max_size) {
+      // The last frame split this block.
+      av1_set_square_split_only(part_state);
+      return;
+    } else if (bw < min_size) {
+      // The last frame coded a larger block here.
+      av1_disable_square_split_partition(part_state);
+      av1_disable_rect_partitions(part_state);
+      return;
+    } else if (ref_bw > ref_bh) {
+      part_state->partition_rect_allowed[VERT] = 0;
+    } else if (ref_bh > ref_bw) {
+      part_state->partition_rect_allowed[HORZ] = 0;
+    }
+  }
+
   // Prune rectangular partitions for larger blocks.
   if (bsize > cpi->sf.part_sf.rect_partition_eval_thresh) {
     part_state->do_rectangular_split = 0;
@@ -1690,7 +1841,7 @@ void av1_prune_partitions_before_search(AV1_COMP *const cpi,
 
   if (try_intra_cnn_based_part_prune) {
     av1_intra_mode_cnn_partition(
-        &cpi->common, x, x->part_search_info.quad_tree_idx,
+        cpi, x, x->part_search_info.quad_tree_idx,
         cpi->sf.part_sf.intra_cnn_based_part_prune_level, part_state);
   }
 
@@ -2525,6 +2676,90 @@ void av1_prepare_motion_search_features_block(
     sms_tree = NULL;
   }
 }
+
+// Returns 1 if the partition maps of the reference frames are kept with their
+// frame buffers. Frames encoded in parallel share their reference frames, and
+// do not use them.
+static AOM_INLINE int use_ref_partition_map(const AV1_COMP *cpi) {
+  if (!cpi->sf.part_sf.prune_part_using_ref_partition) return 0;
+#if CONFIG_FRAME_PARALLEL_ENCODE
+  return cpi->ppi->gf_group.frame_parallel_level[cpi->gf_frame_index] == 0;
+#else
+  return 1;
+#endif  // CONFIG_FRAME_PARALLEL_ENCODE
+}
+
+void av1_store_frame_partition_map(AV1_COMP *cpi) {
+  AV1_COMMON *const cm = &cpi->common;
+  if (!use_ref_partition_map(cpi) || frame_is_intra_only(cm)) return;
+
+  const CommonModeInfoParams *const mi_params = &cm->mi_params;
+  RefCntBuffer *const buf = cm->cur_frame;
+  if (buf->part_map == NULL) {
+    CHECK_MEM_ERROR(cm, buf->part_map, aom_calloc(1, sizeof(*buf->part_map)));
+  }
+  FramePartitionMap *const part_map = buf->part_map;
+  if (part_map->mi_rows != mi_params->mi_rows ||
+      part_map->mi_cols != mi_params->mi_cols) {
+    aom_free(part_map->bsize);
+    part_map->mi_rows = 0;
+    part_map->mi_cols = 0;
+    CHECK_MEM_ERROR(cm, part_map->bsize,
+                    aom_malloc(sizeof(*part_map->bsize) * mi_params->mi_rows *
+                               mi_params->mi_cols));
+    part_map->mi_rows = mi_params->mi_rows;
+    part_map->mi_cols = mi_params->mi_cols;
+  }
+
+  for (int mi_row = 0; mi_row < mi_params->mi_rows; ++mi_row) {
+    MB_MODE_INFO **mi = mi_params->mi_grid_base + mi_row * mi_params->mi_stride;
+    uint8_t *bsize = part_map->bsize + mi_row * part_map->mi_cols;
+    for (int mi_col = 0; mi_col < mi_params->mi_cols; ++mi_col) {
+      bsize[mi_col] = mi[mi_col]->bsize;
+    }
+  }
+  part_map->valid = 1;
+}
+
+const FramePartitionMap *av1_get_static_sb_ref_partition_map(
+    AV1_COMP *const cpi, const MACROBLOCK *const x, int mi_row, int mi_col) {
+  const AV1_COMMON *const cm = &cpi->common;
+  const CommonModeInfoParams *const mi_params = &cm->mi_params;
+  const BLOCK_SIZE sb_size = cm->seq_params->sb_size;
+  if (!use_ref_partition_map(cpi) || frame_is_intra_only(cm) ||
+      !is_full_sb(mi_params, mi_row, mi_col, sb_size)) {
+    return NULL;
+  }
+  const RefCntBuffer *const ref_buf = get_ref_frame_buf(cm, LAST_FRAME);
+  if (ref_buf == NULL || ref_buf->part_map == NULL) return NULL;
+  const FramePartitionMap *const part_map = ref_buf->part_map;
+  if (!part_map->valid || part_map->mi_rows != mi_params->mi_rows ||
+      part_map->mi_cols != mi_params->mi_cols ||
+      ref_buf->buf.y_crop_width != cm->width ||
+      ref_buf->buf.y_crop_height != cm->height) {
+    return NULL;
+  }
+
+  // The superblock is static if its zero motion prediction error from the last
+  // frame is small compared with the quantization step size.
+  const YV12_BUFFER_CONFIG *const src = cpi->source;
+  const YV12_BUFFER_CONFIG *const ref = &ref_buf->buf;
+  const int y = mi_row * MI_SIZE;
+  const int x_pos = mi_col * MI_SIZE;
+  unsigned int sse;
+  cpi->ppi->fn_ptr[sb_size].vf(
+      src->y_buffer + y * src->y_stride + x_pos, src->y_stride,
+      ref->y_buffer + y * ref->y_stride + x_pos, ref->y_stride, &sse);
+  const int bit_depth = x->e_mbd.bd;
+  const int qindex = cm->quant_params.base_qindex + x->delta_qindex;
+  const int64_t q = av1_ac_quant_QTX(qindex, 0, bit_depth) >> (bit_depth - 8);
+  // The ac quantizer is in the scale of the transform coefficients, 8 times
+  // the pixel domain step size.
+  const int64_t sse_per_pixel_thresh = (q * q) >> 10;
+  if (((int64_t)sse >> num_pels_log2_lookup[sb_size]) > sse_per_pixel_thresh)
+    return NULL;
+  return part_map;
+}
 #endif  // !CONFIG_REALTIME_ONLY
 
 static INLINE void init_simple_motion_search_mvs(
@@ -17,11 +17,56 @@
 #include "av1/encoder/encodemb.h"
 #include "av1/encoder/encoder.h"
 
-void av1_intra_mode_cnn_partition(const AV1_COMMON *const cm, MACROBLOCK *x,
+void av1_intra_mode_cnn_partition(const AV1_COMP *const cpi, MACROBLOCK *x,
                                   int label_idx,
                                   int intra_cnn_based_part_prune_level,
                                   PartitionSearchState *part_state);
 
+// Returns whether the intra mode partition CNN is run on the whole frame
+// before the superblocks are encoded, with the output in
+// cpi->intra_cnn_output.
+int av1_use_intra_cnn_frame_output(const AV1_COMP *const cpi);
+
+// Allocates cpi->intra_cnn_output for the current frame size.
+void av1_alloc_intra_cnn_output(AV1_COMP *const cpi);
+
+// Runs the intra mode partition CNN on the 64x64 blocks of the source frame
+// that lie fully inside the frame, for the blocks in [block_start, block_end)
+// in raster order. The output goes to cpi->intra_cnn_output.
+void av1_intra_mode_cnn_predict_blocks(const AV1_COMP *const cpi,
+                                       int block_start, int block_end);
+
+// Returns the number of rows and columns of 64x64 blocks fully inside the
+// frame, which are the blocks the CNN output is computed for.
+static INLINE int av1_get_intra_cnn_output_rows(
+    const CommonModeInfoParams *const mi_params) {
+  return mi_params->mi_rows / mi_size_high[BLOCK_64X64];
+}
+
+static INLINE int av1_get_intra_cnn_output_cols(
+    const CommonModeInfoParams *const mi_params) {
+  return mi_params->mi_cols / mi_size_wide[BLOCK_64X64];
+}
+
+// Block sizes chosen by the partition search of an inter frame, kept with its
+// frame buffer so that the frames using it as LAST_FRAME can reuse them in
+// static regions.
+typedef struct FramePartitionMap {
+  // Block size at each mi position, with a stride of mi_cols.
+  uint8_t *bsize;
+  int mi_rows;
+  int mi_cols;
+  // Set once the map is stored, reset when the frame buffer is assigned to a
+  // new frame.
+  int valid;
+} FramePartitionMap;
+
+static INLINE void av1_free_frame_partition_map(FramePartitionMap *part_map) {
+  if (part_map == NULL) return;
+  aom_free(part_map->bsize);
+  aom_free(part_map);
+}
+
 // Performs a simple_motion_search with a single reference frame and extract
 // the variance of residues. Then use the features to determine whether we want
 // to go straight to splitting without trying PARTITION_NONE
@@ -37,6 +82,10 @@ void av1_simple_motion_search_prune_rect(AV1_COMP *const cpi, MACROBLOCK *x,
                                          PartitionSearchState *part_state);
 
 #if !CONFIG_REALTIME_ONLY
+// Builds the fixed point versions of the simple motion search partition
+// models. Called once when the encoder is initialized.
+void av1_init_partition_nn_int16(void);
+
 // Early terminates PARTITION_NONE using simple_motion_search features and the
 // rate, distortion, and rdcost of PARTITION_NONE. This is only called when:
 //  - The frame is a show frame
@@ -140,6 +189,15 @@ void av1_prepare_motion_search_features_block(
     unsigned int sub_block_var[4], unsigned int horz_block_sse[2],
     unsigned int horz_block_var[2], unsigned int vert_block_sse[2],
     unsigned int vert_block_var[2]);
+
+// Stores the block sizes of the current frame in the partition map of its
+// frame buffer.
+void av1_store_frame_partition_map(AV1_COMP *cpi);
+
+// Returns the partition map of LAST_FRAME if the superblock at (mi_row,
+// mi_col) is static compared with it, and NULL otherwise.
+const FramePartitionMap *av1_get_static_sb_ref_partition_map(
+    AV1_COMP *const cpi, const MACROBLOCK *const x, int mi_row, int mi_col);
 #endif  // !CONFIG_REALTIME_ONLY
 
 // A simplified version of set_offsets meant to be used for
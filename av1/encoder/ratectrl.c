@@ -384,6 +384,9 @@ void av1_rc_init(const AV1EncoderConfig *oxcf, RATE_CONTROL *rc) {
   rc->resize_buffer_underflow = 0;
   rc->resize_count = 0;
   rc->rtc_external_ratectrl = 0;
+  rc->rt_speed_offset = 0;
+  rc->avg_encode_time = 0;
+  rc->frames_since_speed_change = 0;
 #if CONFIG_FRAME_PARALLEL_ENCODE
   rc->frame_level_fast_extra_bits = 0;
 #endif
@@ -3064,6 +3067,53 @@ void av1_get_one_pass_rt_params(AV1_COMP *cpi,
   }
 }
 
+// Speed range of the speed control against the per-frame encode time budget:
+// the real-time speed levels that use the nonrd mode search.
+#define RT_SPEED_CTRL_MIN_SPEED 7
+#define RT_SPEED_CTRL_MAX_SPEED 10
+
+static int rt_speed_control_enabled(const AV1_COMP *cpi) {
+  const AV1EncoderConfig *const oxcf = &cpi->oxcf;
+  return oxcf->mode == REALTIME && oxcf->frame_time_budget > 0 &&
+         oxcf->speed >= RT_SPEED_CTRL_MIN_SPEED && has_no_stats_stage(cpi);
+}
+
+int av1_rt_get_frame_speed(const AV1_COMP *cpi) {
+  const RATE_CONTROL *const rc = &cpi->rc;
+  const int speed = cpi->oxcf.speed;
+  if (!rt_speed_control_enabled(cpi)) return speed;
+  // Scene changes are slower to encode than the frames the offset was
+  // measured on, so use one more level for them.
+  const int offset = rc->rt_speed_offset + (rc->high_source_sad ? 1 : 0);
+  return AOMMIN(speed + offset, RT_SPEED_CTRL_MAX_SPEED);
+}
+
+void av1_rt_update_speed_control(AV1_COMP *cpi, int64_t encode_time) {
+  RATE_CONTROL *const rc = &cpi->rc;
+  const int64_t budget = cpi->oxcf.frame_time_budget;
+  if (!rt_speed_control_enabled(cpi)) return;
+  // Key frames and scene changes are not representative of the encode time
+  // of the following frames.
+  if (frame_is_intra_only(&cpi->common) || rc->high_source_sad) return;
+  if (rc->frames_since_speed_change == 0)
+    rc->avg_encode_time = encode_time;
+  else
+    rc->avg_encode_time = (3 * rc->avg_encode_time + encode_time) >> 2;
+  rc->frames_since_speed_change++;
+  if (cpi->oxcf.speed + rc->rt_speed_offset < RT_SPEED_CTRL_MAX_SPEED &&
+      (encode_time > 2 * budget ||
+       (rc->frames_since_speed_change >= 2 && rc->avg_encode_time > budget))) {
+    rc->rt_speed_offset++;
+    rc->frames_since_speed_change = 0;
+  } else if (rc->rt_speed_offset > 0 && rc->frames_since_speed_change >= 10 &&
+             rc->avg_encode_time < ((budget * 5) >> 3)) {
+    // Only step down when the next slower level is expected to fit within
+    // the budget as well.
+    rc->rt_speed_offset--;
+    rc->frames_since_speed_change = 0;
+  }
+}
+
 int av1_encodedframe_overshoot_cbr(AV1_COMP *cpi, int *q) {
   AV1_COMMON *const cm = &cpi->common;
   RATE_CONTROL *const rc = &cpi->rc;
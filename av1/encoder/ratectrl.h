@@ -233,6 +233,14 @@ typedef struct {
 
   // Flag to disable content related qp adjustment.
   int rtc_external_ratectrl;
+
+  // For the speed control against a per-frame encode time budget, 1 pass
+  // real-time: speed levels added on top of the configured speed, running
+  // average of the encode time (in us) at that speed, and number of frames
+  // encoded since the speed was last changed.
+  int rt_speed_offset;
+  int64_t avg_encode_time;
+  int frames_since_speed_change;
 #if CONFIG_FRAME_PARALLEL_ENCODE
   int frame_level_fast_extra_bits;
   double frame_level_rate_correction_factors[RATE_FACTOR_LEVELS];
@@ -754,6 +762,34 @@ void av1_get_one_pass_rt_params(struct AV1_COMP *cpi,
                                 struct EncodeFrameParams *const frame_params,
                                 unsigned int frame_flags);
 
+/*!\brief Get the speed level for the current frame in 1 pass real-time mode.
+ *
+ * Without a per-frame encode time budget this is the configured speed. With
+ * a budget, the speed is raised by the offset kept in \c cpi->rc, plus one
+ * level on frames detected as scene changes.
+ *
+ * \ingroup rate_control
+ * \param[in]       cpi          Top level encoder structure
+ *
+ * \return The speed level to encode the current frame with.
+ */
+int av1_rt_get_frame_speed(const struct AV1_COMP *cpi);
+
+/*!\brief Update the speed control with the encode time of the last frame.
+ *
+ * Tracks the average encode time of inter frames and moves the speed offset
+ * up when the average exceeds the per-frame budget, and back down when the
+ * average leaves enough headroom for the next slower speed level.
+ *
+ * \ingroup rate_control
+ * \param[in]       cpi          Top level encoder structure
+ * \param[in]       encode_time  Encode time of the last frame in us
+ *
+ * \return Nothing is returned. Instead the speed control state in \c cpi->rc
+ * is updated.
+ */
+void av1_rt_update_speed_control(struct AV1_COMP *cpi, int64_t encode_time);
+
 /*!\brief Increase q on expected encoder overshoot, for CBR mode.
  *
  *  Handles the case when encoder is expected to create a large frame:
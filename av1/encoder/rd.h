@@ -306,6 +306,18 @@ static INLINE void reset_mb_rd_record(MB_RD_RECORD *const mb_rd_record) {
   mb_rd_record->num = mb_rd_record->index_start = 0;
 }
 
+// Used to drop the transform block hash records of the previous superblock
+static INLINE void reset_txb_rd_record(TXB_RD_RECORD *const txb_rd_record) {
+  if (!txb_rd_record) return;
+
+  if (++txb_rd_record->epoch == 0) {
+    // Clear the records once the generation counter wraps around.
+    for (int i = 0; i < TXB_RD_RECORD_SIZE; ++i)
+      txb_rd_record->txb_rd_info[i].epoch = 0;
+    txb_rd_record->epoch = 1;
+  }
+}
+
 void av1_setup_pred_block(const MACROBLOCKD *xd,
                           struct buf_2d dst[MAX_MB_PLANE],
                           const YV12_BUFFER_CONFIG *src,
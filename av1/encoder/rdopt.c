@@ -1164,6 +1164,126 @@ static int64_t handle_newmv(const AV1_COMP *const cpi, MACROBLOCK *const x,
   return 0;
 }
 
+// Returns the estimated SSE per pixel of predicting a block with the given
+// source variance from a motion vector that is off by mv_diff (in 1/8 pel).
+// The error grows quadratically with the offset and saturates at 1 pel, where
+// the prediction is no longer correlated with the source.
+static INLINE int64_t get_mv_misalignment_sse(unsigned int source_variance,
+                                              int mv_diff) {
+  const int clamped_diff = AOMMIN(mv_diff, 8);
+  return ((int64_t)source_variance * clamped_diff * clamped_diff) >> 5;
+}
+
+static INLINE int get_mv_diff(const MV *a, const MV *b) {
+  return abs(a->row - b->row) + abs(a->col - b->col);
+}
+
+struct obmc_gain_ctxt {
+  const MB_MODE_INFO *mbmi;
+  unsigned int source_variance;
+  int overlap;
+  int64_t gain;
+};
+
+static INLINE void accumulate_obmc_gain(MACROBLOCKD *xd, int rel_mi_row,
+                                        int rel_mi_col, uint8_t op_mi_size,
+                                        int dir, MB_MODE_INFO *nb_mi,
+                                        void *fun_ctxt, const int num_planes) {
+  (void)xd;
+  (void)rel_mi_row;
+  (void)rel_mi_col;
+  (void)dir;
+  (void)num_planes;
+  struct obmc_gain_ctxt *ctxt = (struct obmc_gain_ctxt *)fun_ctxt;
+  // A neighbor predicting from another reference is treated as fully
+  // misaligned.
+  const int mv_diff =
+      nb_mi->ref_frame[0] == ctxt->mbmi->ref_frame[0]
+          ? get_mv_diff(&nb_mi->mv[0].as_mv, &ctxt->mbmi->mv[0].as_mv)
+          : INT_MAX;
+  const int area = op_mi_size * MI_SIZE * ctxt->overlap;
+  ctxt->gain += area * get_mv_misalignment_sse(ctxt->source_variance, mv_diff);
+}
+
+// Estimates the SSE reduction of OBMC_CAUSAL over SIMPLE_TRANSLATION. Only the
+// overlapped areas of the neighbors whose motion differs from the block's can
+// change, by at most the misalignment error of the translational prediction.
+static int64_t estimate_obmc_gain(const AV1_COMMON *cm, MACROBLOCK *x,
+                                  BLOCK_SIZE bsize, int64_t trans_sse) {
+  MACROBLOCKD *const xd = &x->e_mbd;
+  struct obmc_gain_ctxt ctxt = { xd->mi[0], x->source_variance, 0, 0 };
+  ctxt.overlap =
+      AOMMIN(block_size_high[bsize], block_size_high[BLOCK_64X64]) >> 1;
+  foreach_overlappable_nb_above(cm, xd,
+                                max_neighbor_obmc[mi_size_wide_log2[bsize]],
+                                accumulate_obmc_gain, &ctxt);
+  ctxt.overlap =
+      AOMMIN(block_size_wide[bsize], block_size_wide[BLOCK_64X64]) >> 1;
+  foreach_overlappable_nb_left(cm, xd,
+                               max_neighbor_obmc[mi_size_high_log2[bsize]],
+                               accumulate_obmc_gain, &ctxt);
+  return AOMMIN(ctxt.gain, trans_sse);
+}
+
+#if !CONFIG_REALTIME_ONLY
+// Estimates the SSE reduction of WARPED_CAUSAL over SIMPLE_TRANSLATION from
+// the spread of the MVs of the selected projection samples around the block
+// MV. Coherent samples give a model close to the translation.
+static int64_t estimate_warped_gain(const MACROBLOCK *x, BLOCK_SIZE bsize,
+                                    const MV *mv, const int *pts,
+                                    const int *pts_inref, int num_samples,
+                                    int64_t trans_sse) {
+  if (num_samples <= 0) return 0;
+  int sum_mv_diff = 0;
+  for (int i = 0; i < num_samples; ++i) {
+    const MV sample_mv = { pts_inref[2 * i + 1] - pts[2 * i + 1],
+                           pts_inref[2 * i] - pts[2 * i] };
+    sum_mv_diff += get_mv_diff(&sample_mv, mv);
+  }
+  const int mean_mv_diff = (sum_mv_diff + num_samples / 2) / num_samples;
+  const int64_t gain =
+      get_mv_misalignment_sse(x->source_variance, mean_mv_diff)
+      << num_pels_log2_lookup[bsize];
+  return AOMMIN(gain, trans_sse);
+}
+#endif  // !CONFIG_REALTIME_ONLY
+
+// Returns 1 if the estimated gain of the motion mode does not pay for the
+// extra rate of signaling it. The luma rd of the translational prediction and
+// of the prediction with the estimated SSE gain are both taken from the model
+// used for the motion mode search.
+static int prune_motion_mode_by_gain(const AV1_COMP *cpi, const MACROBLOCK *x,
+                                     BLOCK_SIZE bsize,
+                                     MOTION_MODE last_motion_mode_allowed,
+                                     MOTION_MODE motion_mode, int64_t trans_sse,
+                                     int64_t gain) {
+  const ModeCosts *mode_costs = &x->mode_costs;
+  int rate_cost;
+  if (last_motion_mode_allowed == WARPED_CAUSAL) {
+    rate_cost = mode_costs->motion_mode_cost[bsize][motion_mode] -
+                mode_costs->motion_mode_cost[bsize][SIMPLE_TRANSLATION];
+  } else {
+    assert(motion_mode == OBMC_CAUSAL);
+    rate_cost = mode_costs->motion_mode_cost1[bsize][1] -
+                mode_costs->motion_mode_cost1[bsize][0];
+  }
+  const int num_pels = 1 << num_pels_log2_lookup[bsize];
+  int trans_rate, est_rate;
+  int64_t trans_dist, est_dist;
+  model_rd_sse_fn[MODELRD_TYPE_MOTION_MODE_RD](cpi, x, bsize, AOM_PLANE_Y,
+                                               trans_sse, num_pels,
+                                               &trans_rate, &trans_dist);
+  model_rd_sse_fn[MODELRD_TYPE_MOTION_MODE_RD](cpi, x, bsize, AOM_PLANE_Y,
+                                               trans_sse - gain, num_pels,
+                                               &est_rate, &est_dist);
+  const int64_t rd_gain = RDCOST(x->rdmult, trans_rate, trans_dist) -
+                          RDCOST(x->rdmult, est_rate, est_dist);
+  const int64_t rate_rd =
+      RDCOST(x->rdmult, rate_cost, 0) *
+      cpi->sf.inter_sf.prune_motion_mode_using_est;
+  return rd_gain <= rate_rd;
+}
+
 static INLINE void update_mode_start_end_index(
     const AV1_COMP *const cpi, const MB_MODE_INFO *const mbmi,
     int *mode_index_start, int *mode_index_end, int last_motion_mode_allowed,
@@ -1328,6 +1448,21 @@ static int64_t motion_mode_rd(
   update_mode_start_end_index(cpi, mbmi, &mode_index_start, &mode_index_end,
                               last_motion_mode_allowed, interintra_allowed,
                               eval_motion_mode);
+  // SSE of the translational prediction, which bounds the estimated gains of
+  // the other motion modes. It is only available while the prediction buffer
+  // holds the translational prediction.
+  int64_t trans_sse = -1;
+  if (cpi->sf.inter_sf.prune_motion_mode_using_est &&
+      mode_index_start == SIMPLE_TRANSLATION &&
+      mode_index_end > SIMPLE_TRANSLATION &&
+      last_motion_mode_allowed > SIMPLE_TRANSLATION &&
+      !args->skip_motion_mode) {
+    unsigned int sse;
+    cpi->ppi->fn_ptr[bsize].vf(x->plane[0].src.buf, x->plane[0].src.stride,
+                               xd->plane[0].dst.buf, xd->plane[0].dst.stride,
+                               &sse);
+    trans_sse = sse;
+  }
   // Main function loop. This loops over all of the possible motion modes and
   // computes RD to determine the best one. This process includes computing
   // any necessary side information for the motion mode and performing the
@@ -1369,6 +1504,11 @@ static int64_t motion_mode_rd(
     if ((!cpi->oxcf.motion_mode_cfg.enable_obmc || prune_obmc) &&
         mbmi->motion_mode == OBMC_CAUSAL)
       continue;
+    if (trans_sse >= 0 && mbmi->motion_mode == OBMC_CAUSAL &&
+        prune_motion_mode_by_gain(
+            cpi, x, bsize, last_motion_mode_allowed, OBMC_CAUSAL, trans_sse,
+            estimate_obmc_gain(cm, x, bsize, trans_sse)))
+      continue;
 
     if (mbmi->motion_mode == SIMPLE_TRANSLATION && !is_interintra_mode) {
       // SIMPLE_TRANSLATION mode: no need to recalculate.
@@ -1409,6 +1549,13 @@ static int64_t motion_mode_rd(
         mbmi->num_proj_ref = av1_selectSamples(
             &mbmi->mv[0].as_mv, pts, pts_inref, mbmi->num_proj_ref, bsize);
       }
+      if (trans_sse >= 0 &&
+          prune_motion_mode_by_gain(
+              cpi, x, bsize, last_motion_mode_allowed, WARPED_CAUSAL,
+              trans_sse,
+              estimate_warped_gain(x, bsize, &mbmi->mv[0].as_mv, pts,
+                                   pts_inref, mbmi->num_proj_ref, trans_sse)))
+        continue;
 
       // Compute the warped motion parameters with a least squares fit
       //  using the collected samples
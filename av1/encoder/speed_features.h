@@ -261,6 +261,14 @@ typedef struct {
   // Prune tx type search using estimated RDcost
   int prune_tx_type_est_rd;
 
+  // Compute the coefficients of all the candidate tx types at once, sharing
+  // the 1D vertical transforms between them, and reuse them in the tx type
+  // search.
+  // 0: off
+  // 1: on
+  // 2: also prune the tx types whose SATD is much larger than the smallest one
+  int fused_tx_type_search;
+
   // Flag used to control the winner mode processing for tx type pruning for
   // inter blocks. It enables further tx type mode pruning based on ML model for
   // mode evaluation and disables tx type mode pruning for winner mode
@@ -408,6 +416,13 @@ typedef struct HIGH_LEVEL_SPEED_FEATURES {
    * Enable/disable second_alt_ref temporal filtering.
    */
   int second_alt_ref_filtering;
+
+  /*!
+   * Run the transform pruning and simple motion search partition models with
+   * the fixed point network (av1_nn_predict_int16()) instead of the floating
+   * point one.
+   */
+  int use_int16_nn_inference;
 } HIGH_LEVEL_SPEED_FEATURES;
 
 /*!
@@ -689,6 +704,10 @@ typedef struct PARTITION_SPEED_FEATURES {
   // 2: on top of 1, prune rectangular partitions if NONE is inter, not a newmv
   // mode and skippable
   int skip_non_sq_part_based_on_none;
+
+  // Restrict the partition search of superblocks that are static compared with
+  // LAST_FRAME to the block sizes that the last frame used in them.
+  int prune_part_using_ref_partition;
 } PARTITION_SPEED_FEATURES;
 
 typedef struct MV_SPEED_FEATURES {
@@ -762,6 +781,13 @@ typedef struct MV_SPEED_FEATURES {
   // 1: use var as the metric
   // 2: disable second MV
   int disable_second_mv;
+
+  // For screen content, keep a hash index of the source of each frame and
+  // look up exact matches of the top left corner of the block in the
+  // reference. The best match, refined with a single step search, is an extra
+  // candidate for the full pixel search. Scrolling and window moves are found
+  // directly this way. The index takes 8 bytes per pixel in each frame buffer.
+  int use_ref_frame_hash_search;
 } MV_SPEED_FEATURES;
 
 typedef struct INTER_MODE_SPEED_FEATURES {
@@ -965,6 +991,16 @@ typedef struct INTER_MODE_SPEED_FEATURES {
   // Prune warped motion search based on block size.
   int extra_prune_warped;
 
+  // Prune OBMC and warped motion candidates in motion_mode_rd() before their
+  // predictors are built. The RD gain of each candidate is estimated from the
+  // disagreement between the block MV and the neighbor MVs, the source
+  // variance and the SSE of the translational prediction, and compared with
+  // the extra rate of signaling the motion mode.
+  // 0: no pruning
+  // 1: prune if the estimated gain is below the rate cost
+  // 2: prune if the estimated gain is below twice the rate cost
+  int prune_motion_mode_using_est;
+
   // Do not search compound modes for ARF.
   // The intuition is that ARF is predicted by frames far away from it,
   // whose temporal correlations with the ARF are likely low.
@@ -1105,6 +1141,11 @@ typedef struct INTRA_MODE_SPEED_FEATURES {
   // Skips the evaluation of filter intra modes in inter frames if rd evaluation
   // of luma intra dc mode results in invalid rd stats.
   int skip_filter_intra_in_inter_frames;
+
+  // Computes the model rd of all the angle deltas of a directional luma mode
+  // at once, gathering the neighboring pixels of the block only once. This
+  // does not change the encoder output.
+  int share_dr_pred_edges;
 } INTRA_MODE_SPEED_FEATURES;
 
 typedef struct TX_SPEED_FEATURES {
@@ -1168,6 +1209,10 @@ typedef struct RD_CALC_SPEED_FEATURES {
   // to avoid repeated search on the same residue signal.
   int use_mb_rd_hash;
 
+  // Use hash table to store the transform type search results of transform
+  // blocks to avoid repeated search on the same residue signal.
+  int use_txb_rd_hash;
+
   // Flag used to control the extent of coeff R-D optimization
   int perform_coeff_opt;
 } RD_CALC_SPEED_FEATURES;
@@ -352,7 +352,12 @@ static size_params_type calculate_next_size_params(AV1_COMP *cpi) {
     rsz.resize_height = cpi->common.height;
     return rsz;
   }
-  if (is_stat_generation_stage(cpi)) return rsz;
+  if (is_stat_generation_stage(cpi)) {
+    if (is_firstpass_downscaled(cpi))
+      av1_calculate_scaled_size(&rsz.resize_width, &rsz.resize_height,
+                                2 * SCALE_NUMERATOR);
+    return rsz;
+  }
   if (resize_pending_params->width && resize_pending_params->height) {
     rsz.resize_width = resize_pending_params->width;
     rsz.resize_height = resize_pending_params->height;
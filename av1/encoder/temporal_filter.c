@@ -825,6 +825,13 @@ void av1_tf_do_filtering_row(AV1_COMP *cpi, ThreadData *td, int mb_row) {
                                // Change ref_mv sign for following frames.
         ref_mv.row *= -1;
         ref_mv.col *= -1;
+      } else if (tf_ctx->mv_info != NULL) {  // Searched ahead of filtering.
+        const TF_BLOCK_MV_INFO *mv_info =
+            &tf_ctx->mv_info[(frame * tf_ctx->mb_rows + mb_row) *
+                                 tf_ctx->mb_cols +
+                             mb_col];
+        memcpy(subblock_mvs, mv_info->subblock_mvs, sizeof(subblock_mvs));
+        memcpy(subblock_mses, mv_info->subblock_mses, sizeof(subblock_mses));
       } else {  // Other reference frames.
         tf_motion_search(cpi, mb, frame_to_filter, frames[frame], block_size,
                          mb_row, mb_col, &ref_mv, subblock_mvs, subblock_mses);
@@ -898,6 +905,58 @@ void av1_tf_do_filtering_row(AV1_COMP *cpi, ThreadData *td, int mb_row) {
   }
 }
 
+void av1_tf_motion_search_row(AV1_COMP *cpi, ThreadData *td, int mb_row,
+                              int frame) {
+  TemporalFilterCtx *tf_ctx = &cpi->tf_ctx;
+  AV1TemporalFilterSync *tf_sync = &cpi->mt_info.tf_sync;
+  YV12_BUFFER_CONFIG **frames = tf_ctx->frames;
+  const int num_frames = tf_ctx->num_frames;
+  const int mb_rows = tf_ctx->mb_rows;
+  const int mb_cols = tf_ctx->mb_cols;
+  const BLOCK_SIZE block_size = TF_BLOCK_SIZE;
+  const YV12_BUFFER_CONFIG *const frame_to_filter =
+      frames[tf_ctx->filter_frame_idx];
+  MACROBLOCK *const mb = &td->mb;
+  const int mb_height = block_size_high[block_size];
+  const int mb_width = block_size_wide[block_size];
+  const int mi_h = mi_size_high_log2[block_size];
+  const int mi_w = mi_size_wide_log2[block_size];
+  TF_BLOCK_MV_INFO *mv_info =
+      &tf_ctx->mv_info[(frame * mb_rows + mb_row) * mb_cols];
+  // The reference motion vector of a block is passed down from the search
+  // against the previous frame, so the blocks of this row wait for the search
+  // of the same blocks against the previous frame.
+  const TF_BLOCK_MV_INFO *prev_mv_info =
+      frame > 0 ? mv_info - mb_rows * mb_cols : NULL;
+
+  av1_set_mv_row_limits(&cpi->common.mi_params, &mb->mv_limits,
+                        (mb_row << mi_h), (mb_height >> MI_SIZE_LOG2),
+                        cpi->oxcf.border_in_pixels);
+  for (int mb_col = 0; mb_col < mb_cols; mb_col++) {
+    av1_tf_ms_sync_read(tf_sync, num_frames, mb_row, frame, mb_col);
+    MV ref_mv = prev_mv_info != NULL ? prev_mv_info[mb_col].ref_mv : kZeroMv;
+    TF_BLOCK_MV_INFO *const info = &mv_info[mb_col];
+    if (frame == tf_ctx->filter_frame_idx) {
+      // Change ref_mv sign for following frames.
+      ref_mv.row *= -1;
+      ref_mv.col *= -1;
+    } else if (frames[frame] != NULL) {
+      av1_set_mv_col_limits(&cpi->common.mi_params, &mb->mv_limits,
+                            (mb_col << mi_w), (mb_width >> MI_SIZE_LOG2),
+                            cpi->oxcf.border_in_pixels);
+      for (int i = 0; i < 4; i++) {
+        info->subblock_mvs[i] = kZeroMv;
+        info->subblock_mses[i] = INT_MAX;
+      }
+      tf_motion_search(cpi, mb, frame_to_filter, frames[frame], block_size,
+                       mb_row, mb_col, &ref_mv, info->subblock_mvs,
+                       info->subblock_mses);
+    }
+    info->ref_mv = ref_mv;
+    av1_tf_ms_sync_write(tf_sync, num_frames, mb_row, frame, mb_col);
+  }
+}
+
 /*!\brief Does temporal filter for a given frame.
  *
  * \ingroup src_frame_proc
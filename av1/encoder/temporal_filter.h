@@ -83,6 +83,16 @@ typedef struct {
   int64_t sse;
 } FRAME_DIFF;
 
+// Motion search result of a temporal filtering block against one frame.
+typedef struct {
+  // Motion vectors of the 4 sub-blocks.
+  MV subblock_mvs[4];
+  // Motion search errors (MSE) of the 4 sub-blocks.
+  int subblock_mses[4];
+  // Reference motion vector passed down to the search on the next frame.
+  MV ref_mv;
+} TF_BLOCK_MV_INFO;
+
 /*!\endcond */
 
 /*!
@@ -139,6 +149,12 @@ typedef struct {
    * Quantization factor used in temporal filtering.
    */
   int q_factor;
+  /*!
+   * Motion search results of all blocks against all frames, indexed by
+   * (frame * mb_rows + mb_row) * mb_cols + mb_col. If not NULL, the motion
+   * search has been done ahead of filtering by the multi-threaded path.
+   */
+  TF_BLOCK_MV_INFO *mv_info;
 } TemporalFilterCtx;
 
 /*!
@@ -255,6 +271,16 @@ typedef struct {
 #endif  // CONFIG_MULTITHREAD
   // Next temporal filter block row to be filtered.
   int next_tf_row;
+#if CONFIG_MULTITHREAD
+  // Mutex lock and condition variable, per block row, used to order the
+  // motion search of a block against consecutive frames.
+  pthread_mutex_t *ms_mutex_;
+  pthread_cond_t *ms_cond_;
+#endif  // CONFIG_MULTITHREAD
+  // Next (block row, frame) pair to be motion searched.
+  int next_ms_job;
+  // Number of blocks motion searched so far, per (block row, frame).
+  int *ms_finished_cols;
 } AV1TemporalFilterSync;
 
 // Estimates noise level from a given frame using a single plane (Y, U, or V).
@@ -290,6 +316,22 @@ modified.
 void av1_tf_do_filtering_row(struct AV1_COMP *cpi, struct ThreadData *td,
                              int mb_row);
 
+/*!\brief Does temporal filter motion search for a given macroblock row
+ * against a single frame. The results are stored in tf_ctx->mv_info and
+ * consumed by av1_tf_do_filtering_row().
+*
+* \ingroup src_frame_proc
+* \param[in]   cpi                   Top level encoder instance structure
+* \param[in]   td                    Pointer to thread data
+* \param[in]   mb_row                Macroblock row to be searched
+* \param[in]   frame                 Index of the frame to be searched against
+*
+* \return Nothing will be returned, but the contents of tf_ctx->mv_info will
+be modified.
+*/
+void av1_tf_motion_search_row(struct AV1_COMP *cpi, struct ThreadData *td,
+                              int mb_row, int frame);
+
 /*!\brief Performs temporal filtering if needed on a source frame.
  * For example to create a filtered alternate reference frame (ARF)
  *
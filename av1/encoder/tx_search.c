@@ -330,12 +330,26 @@ static int get_search_init_depth(int mi_width, int mi_height, int is_inter,
   }
 }
 
+// The ML split scores of the sub-blocks of a transform block. They only depend
+// on the residue, so the scores of a sub-block and of the ones searched after
+// it are computed together, when it first needs its score.
+typedef struct {
+  int blk_rows[4];
+  int blk_cols[4];
+  int scores[4];
+  int num_blocks;
+  TX_SIZE tx_size;
+  // The scores of the sub-blocks from this index on are computed.
+  int computed_from;
+} TxSplitScoreBatch;
+
 static AOM_INLINE void select_tx_block(
     const AV1_COMP *cpi, MACROBLOCK *x, int blk_row, int blk_col, int block,
     TX_SIZE tx_size, int depth, BLOCK_SIZE plane_bsize, ENTROPY_CONTEXT *ta,
     ENTROPY_CONTEXT *tl, TXFM_CONTEXT *tx_above, TXFM_CONTEXT *tx_left,
     RD_STATS *rd_stats, int64_t prev_level_rd, int64_t ref_best_rd,
-    int *is_cost_valid, FAST_TX_SEARCH_MODE ftxs_mode);
+    int *is_cost_valid, FAST_TX_SEARCH_MODE ftxs_mode,
+    TxSplitScoreBatch *ml_split_batch, int ml_split_idx);
 
 // NOTE: CONFIG_COLLECT_RD_STATS has 3 possible values
 // 0: Do not collect any RD stats
@@ -1073,13 +1087,74 @@ static INLINE void dist_block_tx_domain(MACROBLOCK *x, int plane, int block,
   *out_sse = RIGHT_SIGNED_SHIFT(this_sse, shift);
 }
 
+// Computes the coefficients of all the transform types in tx_mask with the
+// 1D transforms shared between the types. If prune is set, the types whose
+// SATD is much larger than the smallest one are dropped from the returned
+// mask: the transforms preserve the energy of the residue, so a larger SATD
+// means the energy is spread over more coefficients.
+static uint16_t fwd_txfm_tx_types(MACROBLOCK *x, int plane, int blk_row,
+                                  int blk_col, BLOCK_SIZE plane_bsize,
+                                  TX_SIZE tx_size, uint16_t tx_mask, int prune,
+                                  tran_low_t *txk_coeff) {
+  const int diff_stride = block_size_wide[plane_bsize];
+  const int16_t *src_diff =
+      x->plane[plane].src_diff +
+      ((blk_row * diff_stride + blk_col) << MI_SIZE_LOG2);
+  av1_fwd_txfm2d_tx_types(src_diff, txk_coeff, diff_stride, tx_size, tx_mask,
+                          x->e_mbd.bd);
+  if (!prune) return tx_mask;
+
+  const int num_coeffs = tx_size_2d[tx_size];
+  int satd[TX_TYPES];
+  int min_satd = INT_MAX;
+  for (int tx_type = 0; tx_type < TX_TYPES; ++tx_type) {
+    if (!(tx_mask & (1 << tx_type))) continue;
+    satd[tx_type] = aom_satd(txk_coeff + tx_type * num_coeffs, num_coeffs);
+    min_satd = AOMMIN(min_satd, satd[tx_type]);
+  }
+  const int64_t satd_thresh = (int64_t)min_satd + (min_satd >> 3);
+  for (int tx_type = 0; tx_type < TX_TYPES; ++tx_type) {
+    if ((tx_mask & (1 << tx_type)) && satd[tx_type] > satd_thresh)
+      tx_mask &= ~(1 << tx_type);
+  }
+  return tx_mask;
+}
+
+// Copies the coefficients of tx_type computed by fwd_txfm_tx_types() to the
+// coefficient buffer of the transform block.
+static INLINE void load_txk_coeff(MACROBLOCK *x, int plane, int block,
+                                  TX_SIZE tx_size, TX_TYPE tx_type,
+                                  const tran_low_t *txk_coeff) {
+  const int num_coeffs = tx_size_2d[tx_size];
+  memcpy(x->plane[plane].coeff + BLOCK_OFFSET(block),
+         txk_coeff + tx_type * num_coeffs, num_coeffs * sizeof(*txk_coeff));
+}
+
+// Transforms and quantizes the residue of a transform block, or only
+// quantizes it if txk_coeff holds the coefficients of all the tx types.
+static INLINE void xform_quant_txk(MACROBLOCK *x, int plane, int block,
+                                   int blk_row, int blk_col,
+                                   BLOCK_SIZE plane_bsize,
+                                   TxfmParam *txfm_param,
+                                   const QUANT_PARAM *quant_param,
+                                   const tran_low_t *txk_coeff) {
+  if (txk_coeff) {
+    load_txk_coeff(x, plane, block, txfm_param->tx_size, txfm_param->tx_type,
+                   txk_coeff);
+    av1_quant(x, plane, block, txfm_param, quant_param);
+  } else {
+    av1_xform_quant(x, plane, block, blk_row, blk_col, plane_bsize,
+                    txfm_param, quant_param);
+  }
+}
+
 uint16_t prune_txk_type_separ(const AV1_COMP *cpi, MACROBLOCK *x, int plane,
                               int block, TX_SIZE tx_size, int blk_row,
                               int blk_col, BLOCK_SIZE plane_bsize, int *txk_map,
                               int16_t allowed_tx_mask, int prune_factor,
                               const TXB_CTX *const txb_ctx,
                               int reduced_tx_set_used, int64_t ref_best_rd,
-                              int num_sel) {
+                              int num_sel, const tran_low_t *txk_coeff) {
   const AV1_COMMON *cm = &cpi->common;
   MACROBLOCKD *xd = &x->e_mbd;
 
@@ -1126,8 +1201,9 @@ uint16_t prune_txk_type_separ(const AV1_COMP *cpi, MACROBLOCK *x, int plane,
     av1_setup_qmatrix(&cm->quant_params, xd, plane, tx_size, tx_type,
                       &quant_param);
 
-    av1_xform_quant(x, plane, block, blk_row, blk_col, plane_bsize, &txfm_param,
-                    &quant_param);
+    xform_quant_txk(x, plane, block, blk_row, blk_col, plane_bsize, &txfm_param,
+                    &quant_param,
+                    (allowed_tx_mask & (1 << tx_type)) ? txk_coeff : NULL);
 
     dist_block_tx_domain(x, plane, block, tx_size, &dist, &sse);
 
@@ -1159,8 +1235,9 @@ uint16_t prune_txk_type_separ(const AV1_COMP *cpi, MACROBLOCK *x, int plane,
     av1_setup_qmatrix(&cm->quant_params, xd, plane, tx_size, tx_type,
                       &quant_param);
 
-    av1_xform_quant(x, plane, block, blk_row, blk_col, plane_bsize, &txfm_param,
-                    &quant_param);
+    xform_quant_txk(x, plane, block, blk_row, blk_col, plane_bsize, &txfm_param,
+                    &quant_param,
+                    (allowed_tx_mask & (1 << tx_type)) ? txk_coeff : NULL);
 
     dist_block_tx_domain(x, plane, block, tx_size, &dist, &sse);
 
@@ -1217,7 +1294,8 @@ uint16_t prune_txk_type(const AV1_COMP *cpi, MACROBLOCK *x, int plane,
                         int block, TX_SIZE tx_size, int blk_row, int blk_col,
                         BLOCK_SIZE plane_bsize, int *txk_map,
                         uint16_t allowed_tx_mask, int prune_factor,
-                        const TXB_CTX *const txb_ctx, int reduced_tx_set_used) {
+                        const TXB_CTX *const txb_ctx, int reduced_tx_set_used,
+                        const tran_low_t *txk_coeff) {
   const AV1_COMMON *cm = &cpi->common;
   MACROBLOCKD *xd = &x->e_mbd;
   int tx_type;
@@ -1248,8 +1326,8 @@ uint16_t prune_txk_type(const AV1_COMP *cpi, MACROBLOCK *x, int plane,
                       &quant_param);
 
     // do txfm and quantization
-    av1_xform_quant(x, plane, block, blk_row, blk_col, plane_bsize, &txfm_param,
-                    &quant_param);
+    xform_quant_txk(x, plane, block, blk_row, blk_col, plane_bsize, &txfm_param,
+                    &quant_param, txk_coeff);
     // estimate rate cost
     rate_cost = av1_cost_coeffs_txb_laplacian(x, plane, block, tx_size, tx_type,
                                               txb_ctx, reduced_tx_set_used, 0);
@@ -1433,10 +1511,43 @@ static AOM_INLINE void unset_bit_mask(uint16_t *mask, int val) {
   *mask &= ~(1 << val);
 }
 
+// Fixed point versions of the transform split and type pruning models, used
+// when sf->hl_sf.use_int16_nn_inference is set.
+#define TX_NN_INT16_BUFFER_SIZE 16384
+static NN_CONFIG_INT16 tx_split_nn_int16[TX_SIZES_ALL];
+#if !CONFIG_NN_V2
+static NN_CONFIG_INT16 tx_type_nn_int16_hor[TX_SIZES_ALL];
+static NN_CONFIG_INT16 tx_type_nn_int16_ver[TX_SIZES_ALL];
+#endif
+static int16_t tx_nn_int16_buffer[TX_NN_INT16_BUFFER_SIZE];
+
+static int16_t *quantize_tx_nn_config(const NN_CONFIG *nn_config,
+                                      NN_CONFIG_INT16 *q, int16_t *buf) {
+  if (!nn_config) return buf;
+  const int size = av1_nn_int16_buffer_size(nn_config);
+  assert(buf + size <= tx_nn_int16_buffer + TX_NN_INT16_BUFFER_SIZE);
+  av1_nn_quantize_config(nn_config, q, buf);
+  return buf + size;
+}
+
+void av1_init_tx_search_nn_int16(void) {
+  int16_t *buf = tx_nn_int16_buffer;
+  for (int tx_size = 0; tx_size < TX_SIZES_ALL; ++tx_size) {
+    buf = quantize_tx_nn_config(av1_tx_split_nnconfig_map[tx_size],
+                                &tx_split_nn_int16[tx_size], buf);
+#if !CONFIG_NN_V2
+    buf = quantize_tx_nn_config(av1_tx_type_nnconfig_map_hor[tx_size],
+                                &tx_type_nn_int16_hor[tx_size], buf);
+    buf = quantize_tx_nn_config(av1_tx_type_nnconfig_map_ver[tx_size],
+                                &tx_type_nn_int16_ver[tx_size], buf);
+#endif
+  }
+}
+
 static void prune_tx_2D(MACROBLOCK *x, BLOCK_SIZE bsize, TX_SIZE tx_size,
                         int blk_row, int blk_col, TxSetType tx_set_type,
                         TX_TYPE_PRUNE_MODE prune_2d_txfm_mode, int *txk_map,
-                        uint16_t *allowed_tx_mask) {
+                        uint16_t *allowed_tx_mask, int use_int16_nn) {
   // This table is used because the search order is different from the enum
   // order.
   static const int tx_type_table_2D[16] = {
@@ -1480,9 +1591,17 @@ static void prune_tx_2D(MACROBLOCK *x, BLOCK_SIZE bsize, TX_SIZE tx_size,
 #if CONFIG_NN_V2
   av1_nn_predict_v2(hfeatures, nn_config_hor, 0, hscores);
   av1_nn_predict_v2(vfeatures, nn_config_ver, 0, vscores);
+  (void)use_int16_nn;
 #else
-  av1_nn_predict(hfeatures, nn_config_hor, 1, hscores);
-  av1_nn_predict(vfeatures, nn_config_ver, 1, vscores);
+  if (use_int16_nn) {
+    av1_nn_predict_int16(hfeatures, &tx_type_nn_int16_hor[tx_size], 1,
+                         hscores);
+    av1_nn_predict_int16(vfeatures, &tx_type_nn_int16_ver[tx_size], 1,
+                         vscores);
+  } else {
+    av1_nn_predict(hfeatures, nn_config_hor, 1, hscores);
+    av1_nn_predict(vfeatures, nn_config_ver, 1, vscores);
+  }
 #endif
 
   for (int i = 0; i < 4; i++) {
@@ -1644,32 +1763,90 @@ static AOM_INLINE void get_mean_dev_features(const int16_t *data, int stride,
   }
 }
 
-static int ml_predict_tx_split(MACROBLOCK *x, BLOCK_SIZE bsize, int blk_row,
-                               int blk_col, TX_SIZE tx_size) {
-  const NN_CONFIG *nn_config = av1_tx_split_nnconfig_map[tx_size];
-  if (!nn_config) return -1;
-
+static AOM_INLINE void get_tx_split_features(const MACROBLOCK *x,
+                                             BLOCK_SIZE bsize, int blk_row,
+                                             int blk_col, TX_SIZE tx_size,
+                                             float *features) {
   const int diff_stride = block_size_wide[bsize];
   const int16_t *diff =
       x->plane[0].src_diff + 4 * blk_row * diff_stride + 4 * blk_col;
   const int bw = tx_size_wide[tx_size];
   const int bh = tx_size_high[tx_size];
+  get_mean_dev_features(diff, diff_stride, bw, bh, features);
+}
+
+static INLINE int get_tx_split_score(float score) {
+  int int_score = (int)(score * 10000);
+  return clamp(int_score, -80000, 80000);
+}
+
+static int ml_predict_tx_split(MACROBLOCK *x, BLOCK_SIZE bsize, int blk_row,
+                               int blk_col, TX_SIZE tx_size,
+                               int use_int16_nn) {
+  const NN_CONFIG *nn_config = av1_tx_split_nnconfig_map[tx_size];
+  if (!nn_config) return -1;
 
   float features[64] = { 0.0f };
-  get_mean_dev_features(diff, diff_stride, bw, bh, features);
+  get_tx_split_features(x, bsize, blk_row, blk_col, tx_size, features);
 
   float score = 0.0f;
-  av1_nn_predict(features, nn_config, 1, &score);
+  if (use_int16_nn)
+    av1_nn_predict_int16(features, &tx_split_nn_int16[tx_size], 1, &score);
+  else
+    av1_nn_predict(features, nn_config, 1, &score);
 
-  int int_score = (int)(score * 10000);
-  return clamp(int_score, -80000, 80000);
+  return get_tx_split_score(score);
+}
+
+// Computes the ML split scores of several transform blocks of the same size in
+// one batch.
+static void ml_predict_tx_split_batch(MACROBLOCK *x, BLOCK_SIZE bsize,
+                                      const int *blk_rows, const int *blk_cols,
+                                      int num_blocks, TX_SIZE tx_size,
+                                      int *scores) {
+  const NN_CONFIG *nn_config = av1_tx_split_nnconfig_map[tx_size];
+  assert(nn_config && num_blocks <= 4);
+  // get_mean_dev_features() fills exactly num_inputs features.
+  const int num_features = nn_config->num_inputs;
+  assert(num_features <= 12);
+  float features[4 * 12] = { 0.0f };
+  for (int i = 0; i < num_blocks; ++i) {
+    get_tx_split_features(x, bsize, blk_rows[i], blk_cols[i], tx_size,
+                          features + i * num_features);
+  }
+
+  float batch_scores[4];
+  // The batched networks only pay off from 3 blocks on.
+  if (num_blocks >= 3) {
+    av1_nn_predict_batch(features, num_blocks, nn_config, 1, batch_scores);
+  } else {
+    for (int i = 0; i < num_blocks; ++i) {
+      av1_nn_predict(features + i * num_features, nn_config, 1,
+                     batch_scores + i);
+    }
+  }
+  for (int i = 0; i < num_blocks; ++i)
+    scores[i] = get_tx_split_score(batch_scores[i]);
+}
+
+static int get_batched_tx_split_score(MACROBLOCK *x, BLOCK_SIZE bsize,
+                                      TxSplitScoreBatch *batch, int idx) {
+  assert(idx < batch->num_blocks);
+  if (idx < batch->computed_from) {
+    ml_predict_tx_split_batch(x, bsize, batch->blk_rows + idx,
+                              batch->blk_cols + idx, batch->computed_from - idx,
+                              batch->tx_size, batch->scores + idx);
+    batch->computed_from = idx;
+  }
+  return batch->scores[idx];
 }
 
 static INLINE uint16_t
 get_tx_mask(const AV1_COMP *cpi, MACROBLOCK *x, int plane, int block,
             int blk_row, int blk_col, BLOCK_SIZE plane_bsize, TX_SIZE tx_size,
             const TXB_CTX *const txb_ctx, FAST_TX_SEARCH_MODE ftxs_mode,
-            int64_t ref_best_rd, TX_TYPE *allowed_txk_types, int *txk_map) {
+            int64_t ref_best_rd, TX_TYPE *allowed_txk_types, int *txk_map,
+            tran_low_t *txk_coeff_buf, const tran_low_t **txk_coeff) {
   const AV1_COMMON *cm = &cpi->common;
   MACROBLOCKD *xd = &x->e_mbd;
   MB_MODE_INFO *mbmi = xd->mi[0];
@@ -1797,21 +1974,37 @@ get_tx_mask(const AV1_COMP *cpi, MACROBLOCK *x, int plane, int block,
     }
     assert(num_allowed > 0);
 
+    const int fused_tx_type_search =
+        cpi->sf.tx_sf.tx_type_search.fused_tx_type_search;
+    if (num_allowed > 2 && fused_tx_type_search) {
+      // Only transform sizes up to 16x16 have more than 2 tx types.
+      assert(txsize_sqr_up_map[tx_size] <= TX_16X16);
+      allowed_tx_mask = fwd_txfm_tx_types(
+          x, plane, blk_row, blk_col, plane_bsize, tx_size, allowed_tx_mask,
+          fused_tx_type_search >= 2, txk_coeff_buf);
+      *txk_coeff = txk_coeff_buf;
+      num_allowed = 0;
+      for (i = 0; i < TX_TYPES; i++) {
+        if (allowed_tx_mask & (1 << i)) num_allowed++;
+      }
+    }
+
     if (num_allowed > 2 && cpi->sf.tx_sf.tx_type_search.prune_tx_type_est_rd) {
       int pf = prune_factors[txfm_params->prune_2d_txfm_mode];
       int mf = mul_factors[txfm_params->prune_2d_txfm_mode];
       if (num_allowed <= 7) {
-        const uint16_t prune =
-            prune_txk_type(cpi, x, plane, block, tx_size, blk_row, blk_col,
-                           plane_bsize, txk_map, allowed_tx_mask, pf, txb_ctx,
-                           cm->features.reduced_tx_set_used);
+        const uint16_t prune = prune_txk_type(
+            cpi, x, plane, block, tx_size, blk_row, blk_col, plane_bsize,
+            txk_map, allowed_tx_mask, pf, txb_ctx,
+            cm->features.reduced_tx_set_used, *txk_coeff);
         allowed_tx_mask &= (~prune);
       } else {
         const int num_sel = (num_allowed * mf + 50) / 100;
         const uint16_t prune = prune_txk_type_separ(
             cpi, x, plane, block, tx_size, blk_row, blk_col, plane_bsize,
             txk_map, allowed_tx_mask, pf, txb_ctx,
-            cm->features.reduced_tx_set_used, ref_best_rd, num_sel);
+            cm->features.reduced_tx_set_used, ref_best_rd, num_sel,
+            *txk_coeff);
 
         allowed_tx_mask &= (~prune);
       }
@@ -1823,7 +2016,8 @@ get_tx_mask(const AV1_COMP *cpi, MACROBLOCK *x, int plane, int block,
       if (txfm_params->prune_2d_txfm_mode >= TX_TYPE_PRUNE_1 && is_inter &&
           num_allowed > allowed_tx_count) {
         prune_tx_2D(x, plane_bsize, tx_size, blk_row, blk_col, tx_set_type,
-                    txfm_params->prune_2d_txfm_mode, txk_map, &allowed_tx_mask);
+                    txfm_params->prune_2d_txfm_mode, txk_map, &allowed_tx_mask,
+                    cpi->sf.hl_sf.use_int16_nn_inference);
       }
     }
   }
@@ -1959,6 +2153,105 @@ static INLINE void predict_dc_only_block(
   }
 }
 
+static INLINE uint32_t get_txb_residue_hash(MACROBLOCK *x, int plane,
+                                            int blk_row, int blk_col,
+                                            BLOCK_SIZE plane_bsize,
+                                            TX_SIZE tx_size) {
+  const int txw = tx_size_wide[tx_size];
+  const int txh = tx_size_high[tx_size];
+  const int diff_stride = block_size_wide[plane_bsize];
+  const int16_t *diff =
+      x->plane[plane].src_diff +
+      ((blk_row * diff_stride + blk_col) << MI_SIZE_LOG2);
+  CRC32C *const crc = &x->txfm_search_info.txb_rd_record->crc_calculator;
+  if (txw == diff_stride)
+    return av1_get_crc32c_value(crc, (uint8_t *)diff, 2 * txw * txh);
+
+  DECLARE_ALIGNED(16, int16_t, residue[MAX_TX_SQUARE]);
+  for (int r = 0; r < txh; ++r)
+    memcpy(residue + r * txw, diff + r * diff_stride, txw * sizeof(*diff));
+  return av1_get_crc32c_value(crc, (uint8_t *)residue, 2 * txw * txh);
+}
+
+// Packs everything besides the residue and the transform type that the
+// result of the search of one transform type depends on.
+static INLINE uint64_t get_txb_search_ctx(const MACROBLOCK *x, int plane,
+                                          TX_SIZE tx_size,
+                                          const TXB_CTX *txb_ctx,
+                                          int skip_trellis,
+                                          int use_transform_domain_distortion) {
+  const MB_MODE_INFO *mbmi = x->e_mbd.mi[0];
+  const int is_inter = is_inter_block(mbmi);
+  // The cost of the transform type of intra luma blocks depends on the mode.
+  int intra_dir = 0;
+  if (plane == 0 && !is_inter) {
+    intra_dir =
+        1 + (mbmi->filter_intra_mode_info.use_filter_intra
+                 ? fimode_to_intradir[mbmi->filter_intra_mode_info
+                                          .filter_intra_mode]
+                 : mbmi->mode);
+  }
+  uint64_t ctx = tx_size;
+  ctx = (ctx << 2) | plane;
+  ctx = (ctx << 4) | txb_ctx->txb_skip_ctx;
+  ctx = (ctx << 2) | txb_ctx->dc_sign_ctx;
+  ctx = (ctx << 1) | is_inter;
+  ctx = (ctx << 4) | intra_dir;
+  ctx = (ctx << 1) | (skip_trellis != 0);
+  ctx = (ctx << 1) | (use_transform_domain_distortion != 0);
+  ctx = (ctx << 3) | mbmi->segment_id;
+  ctx = (ctx << 8) | x->qindex;
+  return ctx;
+}
+
+static INLINE TXB_RD_INFO *get_txb_rd_info(TXB_RD_RECORD *txb_rd_record,
+                                           uint32_t hash, uint64_t search_ctx) {
+  const uint32_t ctx_hash =
+      (uint32_t)(search_ctx ^ (search_ctx >> 32)) * 0x9E3779B1u;
+  return &txb_rd_record->txb_rd_info[(hash ^ (ctx_hash >> 16)) &
+                                     (TXB_RD_RECORD_SIZE - 1)];
+}
+
+// Transforms and quantizes the residue of a transform block with the
+// transform type in txfm_param, and returns the rate of the coefficients.
+// txk_coeff holds the coefficients of all the transform types if they have
+// been computed already.
+static int xform_quant_txb(const AV1_COMP *cpi, MACROBLOCK *x, int plane,
+                           int block, int blk_row, int blk_col,
+                           BLOCK_SIZE plane_bsize, TX_SIZE tx_size,
+                           const TXB_CTX *const txb_ctx, int dc_only_blk,
+                           int64_t per_px_mean, int qstep, int skip_trellis,
+                           const tran_low_t *txk_coeff, TxfmParam *txfm_param,
+                           QUANT_PARAM *quant_param,
+                           int *skip_trellis_based_on_satd) {
+  const AV1_COMMON *cm = &cpi->common;
+  const TX_TYPE tx_type = txfm_param->tx_type;
+  if (txk_coeff)
+    load_txk_coeff(x, plane, block, tx_size, tx_type, txk_coeff);
+  else if (!dc_only_blk)
+    av1_xform(x, plane, block, blk_row, blk_col, plane_bsize, txfm_param);
+  else
+    av1_xform_dc_only(x, plane, block, txfm_param, per_px_mean);
+
+  *skip_trellis_based_on_satd = skip_trellis_opt_based_on_satd(
+      x, quant_param, plane, block, tx_size, cpi->oxcf.q_cfg.quant_b_adapt,
+      qstep, x->txfm_search_params.coeff_opt_thresholds[1], skip_trellis,
+      dc_only_blk);
+
+  av1_quant(x, plane, block, txfm_param, quant_param);
+
+  // Calculate rate cost of quantized coefficients.
+  int rate_cost;
+  if (quant_param->use_optimize_b) {
+    av1_optimize_b(cpi, x, plane, block, tx_size, tx_type, txb_ctx,
+                   &rate_cost);
+  } else {
+    rate_cost = cost_coeffs(x, plane, block, tx_size, tx_type, txb_ctx,
+                            cm->features.reduced_tx_set_used);
+  }
+  return rate_cost;
+}
+
 // Search for the best transform type for a given transform block.
 // This function can be used for both inter and intra, both luma and chroma.
 static void search_tx_type(const AV1_COMP *cpi, MACROBLOCK *x, int plane,
@@ -2023,6 +2316,10 @@ static void search_tx_type(const AV1_COMP *cpi, MACROBLOCK *x, int plane,
 
   // Bit mask to indicate which transform types are allowed in the RD search.
   uint16_t tx_mask;
+  // Coefficients of all the allowed transform types if get_tx_mask() has
+  // computed them at once.
+  DECLARE_ALIGNED(32, tran_low_t, txk_coeff_buf[TX_TYPES * 16 * 16]);
+  const tran_low_t *txk_coeff = NULL;
 
   // Use DCT_DCT transform for DC only block.
   if (dc_only_blk)
@@ -2030,7 +2327,8 @@ static void search_tx_type(const AV1_COMP *cpi, MACROBLOCK *x, int plane,
   else
     tx_mask = get_tx_mask(cpi, x, plane, block, blk_row, blk_col, plane_bsize,
                           tx_size, txb_ctx, ftxs_mode, ref_best_rd,
-                          &txk_allowed, txk_map);
+                          &txk_allowed, txk_map, txk_coeff_buf, &txk_coeff);
+
   const uint16_t allowed_tx_mask = tx_mask;
 
   if (is_cur_buf_hbd(xd)) {
@@ -2083,6 +2381,28 @@ static void search_tx_type(const AV1_COMP *cpi, MACROBLOCK *x, int plane,
                                : AV1_XFORM_QUANT_FP,
                   cpi->oxcf.q_cfg.quant_b_adapt, &quant_param);
 
+  // Results of the search are reused across partition candidates and
+  // transform partitions of the superblock with the same residue. DC only
+  // blocks are cheap to search, and blocks crossing the frame boundary are
+  // only partially covered by the residue.
+  TXB_RD_RECORD *const txb_rd_record = x->txfm_search_info.txb_rd_record;
+  const int use_txb_rd_record =
+      txb_rd_record != NULL && !dc_only_blk &&
+      blk_col + tx_size_wide_unit[tx_size] <=
+          max_block_wide(xd, plane_bsize, plane) &&
+      blk_row + tx_size_high_unit[tx_size] <=
+          max_block_high(xd, plane_bsize, plane);
+  uint32_t txb_hash = 0;
+  uint64_t txb_search_ctx = 0;
+  if (use_txb_rd_record) {
+    txb_hash =
+        get_txb_residue_hash(x, plane, blk_row, blk_col, plane_bsize, tx_size);
+    txb_search_ctx = get_txb_search_ctx(x, plane, tx_size, txb_ctx,
+                                        skip_trellis,
+                                        use_transform_domain_distortion);
+  }
+  int best_from_txb_rd_record = 0;
+
   // Iterate through all transform type candidates.
   for (int idx = 0; idx < TX_TYPES; ++idx) {
     const TX_TYPE tx_type = (TX_TYPE)txk_map[idx];
@@ -2097,24 +2417,35 @@ static void search_tx_type(const AV1_COMP *cpi, MACROBLOCK *x, int plane,
     RD_STATS this_rd_stats;
     av1_invalid_rd_stats(&this_rd_stats);
 
-    if (!dc_only_blk)
-      av1_xform(x, plane, block, blk_row, blk_col, plane_bsize, &txfm_param);
-    else
-      av1_xform_dc_only(x, plane, block, &txfm_param, per_px_mean);
-
-    skip_trellis_based_on_satd[tx_type] = skip_trellis_opt_based_on_satd(
-        x, &quant_param, plane, block, tx_size, cpi->oxcf.q_cfg.quant_b_adapt,
-        qstep, txfm_params->coeff_opt_thresholds[1], skip_trellis, dc_only_blk);
-
-    av1_quant(x, plane, block, &txfm_param, &quant_param);
-
-    // Calculate rate cost of quantized coefficients.
-    if (quant_param.use_optimize_b) {
-      av1_optimize_b(cpi, x, plane, block, tx_size, tx_type, txb_ctx,
-                     &rate_cost);
+    // Look up the result of an earlier search of the same residue.
+    TXB_RD_INFO *txb_rd_info = NULL;
+    int txb_rd_info_hit = 0;
+    const uint64_t search_ctx = (txb_search_ctx << 4) | tx_type;
+    if (use_txb_rd_record) {
+      txb_rd_info = get_txb_rd_info(txb_rd_record, txb_hash, search_ctx);
+      txb_rd_info_hit =
+          txb_rd_info->epoch == txb_rd_record->epoch &&
+          txb_rd_info->hash_value == txb_hash &&
+          txb_rd_info->search_ctx == search_ctx &&
+          txb_rd_info->rdmult == x->rdmult &&
+          txb_rd_info->coeff_opt_satd_threshold ==
+              txfm_params->coeff_opt_thresholds[1];
+    }
+
+    uint16_t eob;
+    uint8_t txb_entropy_ctx;
+    if (txb_rd_info_hit) {
+      rate_cost = txb_rd_info->rate;
+      eob = txb_rd_info->eob;
+      txb_entropy_ctx = txb_rd_info->txb_entropy_ctx;
+      skip_trellis_based_on_satd[tx_type] = txb_rd_info->skip_trellis;
     } else {
-      rate_cost = cost_coeffs(x, plane, block, tx_size, tx_type, txb_ctx,
-                              cm->features.reduced_tx_set_used);
+      rate_cost = xform_quant_txb(
+          cpi, x, plane, block, blk_row, blk_col, plane_bsize, tx_size,
+          txb_ctx, dc_only_blk, per_px_mean, qstep, skip_trellis, txk_coeff,
+          &txfm_param, &quant_param, &skip_trellis_based_on_satd[tx_type]);
+      eob = eobs_ptr[block];
+      txb_entropy_ctx = x->plane[plane].txb_entropy_ctx[block];
     }
 
     // If rd cost based on coeff rate alone is already more than best_rd,
@@ -2122,7 +2453,10 @@ static void search_tx_type(const AV1_COMP *cpi, MACROBLOCK *x, int plane,
     if (RDCOST(x->rdmult, rate_cost, 0) > best_rd) continue;
 
     // Calculate distortion.
-    if (eobs_ptr[block] == 0) {
+    if (txb_rd_info_hit) {
+      this_rd_stats.dist = txb_rd_info->dist;
+      this_rd_stats.sse = txb_rd_info->sse;
+    } else if (eobs_ptr[block] == 0) {
       // When eob is 0, pixel domain distortion is more efficient and accurate.
       this_rd_stats.dist = this_rd_stats.sse = block_sse;
     } else if (dc_only_blk) {
@@ -2169,6 +2503,21 @@ static void search_tx_type(const AV1_COMP *cpi, MACROBLOCK *x, int plane,
       this_rd_stats.sse = block_sse;
     }
 
+    if (txb_rd_info && !txb_rd_info_hit) {
+      txb_rd_info->hash_value = txb_hash;
+      txb_rd_info->epoch = txb_rd_record->epoch;
+      txb_rd_info->search_ctx = search_ctx;
+      txb_rd_info->rdmult = x->rdmult;
+      txb_rd_info->coeff_opt_satd_threshold =
+          txfm_params->coeff_opt_thresholds[1];
+      txb_rd_info->rate = rate_cost;
+      txb_rd_info->dist = this_rd_stats.dist;
+      txb_rd_info->sse = this_rd_stats.sse;
+      txb_rd_info->eob = eob;
+      txb_rd_info->txb_entropy_ctx = txb_entropy_ctx;
+      txb_rd_info->skip_trellis = skip_trellis_based_on_satd[tx_type];
+    }
+
     this_rd_stats.rate = rate_cost;
 
     const int64_t rd =
@@ -2178,12 +2527,15 @@ static void search_tx_type(const AV1_COMP *cpi, MACROBLOCK *x, int plane,
       best_rd = rd;
       *best_rd_stats = this_rd_stats;
       best_tx_type = tx_type;
-      best_txb_ctx = x->plane[plane].txb_entropy_ctx[block];
-      best_eob = x->plane[plane].eobs[block];
-      // Swap dqcoeff buffers
-      tran_low_t *const tmp_dqcoeff = best_dqcoeff;
-      best_dqcoeff = p->dqcoeff;
-      p->dqcoeff = tmp_dqcoeff;
+      best_txb_ctx = txb_entropy_ctx;
+      best_eob = eob;
+      best_from_txb_rd_record = txb_rd_info_hit;
+      if (!txb_rd_info_hit) {
+        // Swap dqcoeff buffers
+        tran_low_t *const tmp_dqcoeff = best_dqcoeff;
+        best_dqcoeff = p->dqcoeff;
+        p->dqcoeff = tmp_dqcoeff;
+      }
     }
 
 #if CONFIG_COLLECT_RD_STATS == 1
@@ -2255,6 +2607,25 @@ static void search_tx_type(const AV1_COMP *cpi, MACROBLOCK *x, int plane,
   // final pixel domain distortion calculation and recon_intra().
   p->dqcoeff = best_dqcoeff;
 
+  // The coefficients of a result taken from the hash records have not been
+  // computed, redo the transform and quantization if they are needed.
+  if (best_from_txb_rd_record && best_eob &&
+      (calc_pixel_domain_distortion_final || !is_inter_block(mbmi))) {
+    txfm_param.tx_type = best_tx_type;
+    if (av1_use_qmatrix(&cm->quant_params, xd, mbmi->segment_id)) {
+      av1_setup_qmatrix(&cm->quant_params, xd, plane, tx_size, best_tx_type,
+                        &quant_param);
+    }
+    int skip_trellis_satd;
+    xform_quant_txb(cpi, x, plane, block, blk_row, blk_col, plane_bsize,
+                    tx_size, txb_ctx, dc_only_blk, per_px_mean, qstep,
+                    skip_trellis, txk_coeff, &txfm_param, &quant_param,
+                    &skip_trellis_satd);
+    // Keep the results of the search in case of a hash collision.
+    x->plane[plane].txb_entropy_ctx[block] = best_txb_ctx;
+    x->plane[plane].eobs[block] = best_eob;
+  }
+
   if (calc_pixel_domain_distortion_final && best_eob) {
     best_rd_stats->dist = dist_block_px_domain(
         cpi, x, plane, plane_bsize, block, blk_row, blk_col, tx_size);
@@ -2359,7 +2730,28 @@ static AOM_INLINE void try_tx_block_split(
   split_rd_stats->rate =
       x->mode_costs.txfm_partition_cost[txfm_partition_ctx][1];
 
-  for (int r = 0, blk_idx = 0; r < txb_height; r += sub_txb_height) {
+  TxSplitScoreBatch ml_split_batch;
+  const int batch_ml_split =
+      xd->bd == 8 && cpi->sf.tx_sf.tx_type_search.ml_tx_split_thresh >= 0 &&
+      !cpi->sf.hl_sf.use_int16_nn_inference && sub_txs > TX_4X4 &&
+      depth + 1 < MAX_VARTX_DEPTH && av1_tx_split_nnconfig_map[sub_txs];
+  if (batch_ml_split) {
+    ml_split_batch.num_blocks = 0;
+    for (int r = 0; r < txb_height && blk_row + r < max_blocks_high;
+         r += sub_txb_height) {
+      for (int c = 0; c < txb_width; c += sub_txb_width) {
+        if (blk_col + c >= max_blocks_wide) continue;
+        ml_split_batch.blk_rows[ml_split_batch.num_blocks] = blk_row + r;
+        ml_split_batch.blk_cols[ml_split_batch.num_blocks] = blk_col + c;
+        ++ml_split_batch.num_blocks;
+      }
+    }
+    ml_split_batch.tx_size = sub_txs;
+    ml_split_batch.computed_from = ml_split_batch.num_blocks;
+  }
+
+  for (int r = 0, blk_idx = 0, ml_idx = 0; r < txb_height;
+       r += sub_txb_height) {
     const int offsetr = blk_row + r;
     if (offsetr >= max_blocks_high) break;
     for (int c = 0; c < txb_width; c += sub_txb_width, ++blk_idx) {
@@ -2372,7 +2764,8 @@ static AOM_INLINE void try_tx_block_split(
       select_tx_block(cpi, x, offsetr, offsetc, block, sub_txs, depth + 1,
                       plane_bsize, ta, tl, tx_above, tx_left, &this_rd_stats,
                       no_split_rd / nblks, ref_best_rd - split_rd_stats->rdcost,
-                      &this_cost_valid, ftxs_mode);
+                      &this_cost_valid, ftxs_mode,
+                      batch_ml_split ? &ml_split_batch : NULL, ml_idx++);
       if (!this_cost_valid) {
         split_rd_stats->rdcost = INT64_MAX;
         return;
@@ -2487,7 +2880,8 @@ static AOM_INLINE void select_tx_block(
     TX_SIZE tx_size, int depth, BLOCK_SIZE plane_bsize, ENTROPY_CONTEXT *ta,
     ENTROPY_CONTEXT *tl, TXFM_CONTEXT *tx_above, TXFM_CONTEXT *tx_left,
     RD_STATS *rd_stats, int64_t prev_level_rd, int64_t ref_best_rd,
-    int *is_cost_valid, FAST_TX_SEARCH_MODE ftxs_mode) {
+    int *is_cost_valid, FAST_TX_SEARCH_MODE ftxs_mode,
+    TxSplitScoreBatch *ml_split_batch, int ml_split_idx) {
   assert(tx_size < TX_SIZES_ALL);
   av1_init_rd_stats(rd_stats);
   if (ref_best_rd < 0) {
@@ -2550,7 +2944,11 @@ static AOM_INLINE void select_tx_block(
     const int threshold = cpi->sf.tx_sf.tx_type_search.ml_tx_split_thresh;
     if (threshold >= 0) {
       const int split_score =
-          ml_predict_tx_split(x, plane_bsize, blk_row, blk_col, tx_size);
+          ml_split_batch
+              ? get_batched_tx_split_score(x, plane_bsize, ml_split_batch,
+                                           ml_split_idx)
+              : ml_predict_tx_split(x, plane_bsize, blk_row, blk_col, tx_size,
+                                    cpi->sf.hl_sf.use_int16_nn_inference);
       if (split_score < -threshold) try_split = 0;
     }
   }
@@ -3261,7 +3659,7 @@ static int64_t select_tx_size_and_type(const AV1_COMP *cpi, MACROBLOCK *x,
       // Search for the best transform block size and type for the sub-block.
       select_tx_block(cpi, x, idy, idx, block, max_tx_size, init_depth, bsize,
                       ctxa, ctxl, tx_above, tx_left, &pn_rd_stats, INT64_MAX,
-                      best_rd_sofar, &is_cost_valid, ftxs_mode);
+                      best_rd_sofar, &is_cost_valid, ftxs_mode, NULL, 0);
       if (!is_cost_valid || pn_rd_stats.rate == INT_MAX) {
         av1_invalid_rd_stats(rd_stats);
         return INT64_MAX;
@@ -240,6 +240,27 @@ static AOM_INLINE void fill_variance_8x8avg(const uint8_t *s, int sp,
                                             int pixels_wide, int pixels_high,
                                             int is_key_frame) {
   int k;
+#if CONFIG_AV1_HIGHBITDEPTH
+  const int is_highbd = highbd_flag & YV12_FLAG_HIGHBITDEPTH;
+#else
+  const int is_highbd = 0;
+#endif
+  if (!is_highbd && x16_idx + 16 <= pixels_wide &&
+      y16_idx + 16 <= pixels_high) {
+    // All four 8x8 blocks are inside the frame: compute their averages with
+    // one call per plane.
+    int s_avg[4];
+    int d_avg[4] = { 128, 128, 128, 128 };
+    aom_avg_8x8_quad(s, sp, x16_idx, y16_idx, s_avg);
+    if (!is_key_frame) aom_avg_8x8_quad(d, dp, x16_idx, y16_idx, d_avg);
+    for (k = 0; k < 4; k++) {
+      const int sum = s_avg[k] - d_avg[k];
+      const unsigned int sse = sum * sum;
+      fill_variance(sse, sum, 0, &vst->split[k].part_variances.none);
+    }
+    return;
+  }
+
   for (k = 0; k < 4; k++) {
     int x8_idx = x16_idx + ((k & 1) << 3);
     int y8_idx = y16_idx + ((k >> 1) << 3);
@@ -13,6 +13,8 @@
 #include <immintrin.h>
 #include <math.h>
 
+#include "config/av1_rtcd.h"
+
 #include "aom_dsp/aom_dsp_common.h"
 #include "av1/common/av1_common_int.h"
 #include "av1/encoder/cnn.h"
@@ -530,3 +532,93 @@ void av1_cnn_convolve_no_maxpool_padding_valid_avx2(
         start_idx, cstep, channel_step);
   }
 }
+
+// The element-wise CNN functions below process 8 pixels of a row at a time and
+// match the C functions exactly.
+void av1_cnn_add_avx2(float **output, int channels, int width, int height,
+                      int stride, const float **add) {
+  for (int c = 0; c < channels; ++c) {
+    for (int i = 0; i < height; ++i) {
+      float *out = output[c] + i * stride;
+      const float *in = add[c] + i * stride;
+      int j = 0;
+      for (; j + 8 <= width; j += 8) {
+        _mm256_storeu_ps(out + j, _mm256_add_ps(_mm256_loadu_ps(out + j),
+                                                _mm256_loadu_ps(in + j)));
+      }
+      for (; j < width; ++j) out[j] += in[j];
+    }
+  }
+}
+
+void av1_cnn_activate_avx2(float **output, int channels, int width, int height,
+                           int stride, ACTIVATION layer_activation) {
+  if (layer_activation == NONE) return;
+  if (layer_activation != RELU && layer_activation != SOFTSIGN) {
+    av1_cnn_activate_c(output, channels, width, height, stride,
+                       layer_activation);
+    return;
+  }
+  const __m256i abs_mask = _mm256_set1_epi32(0x7fffffff);
+  const __m256 zero = _mm256_setzero_ps();
+  const __m256 one = _mm256_set1_ps(1.0f);
+  const int is_relu = layer_activation == RELU;
+  for (int c = 0; c < channels; ++c) {
+    for (int i = 0; i < height; ++i) {
+      float *out = output[c] + i * stride;
+      int j = 0;
+      for (; j + 8 <= width; j += 8) {
+        const __m256 x = _mm256_loadu_ps(out + j);
+        __m256 y;
+        if (is_relu) {
+          // max(0, x) returns x when x is -0.0 or NaN, as relu() does.
+          y = _mm256_max_ps(zero, x);
+        } else {
+          // Rounding |x| + 1 to float directly gives the same result as
+          // rounding it to double first.
+          const __m256 abs_x =
+              _mm256_and_ps(x, _mm256_castsi256_ps(abs_mask));
+          y = _mm256_div_ps(x, _mm256_add_ps(abs_x, one));
+        }
+        _mm256_storeu_ps(out + j, y);
+      }
+      for (; j < width; ++j) {
+        out[j] = is_relu ? (out[j] < 0 ? 0 : out[j])
+                         : out[j] / (float)(fabsf(out[j]) + 1.0);
+      }
+    }
+  }
+}
+
+void av1_cnn_batchnorm_avx2(float **image, int channels, int width, int height,
+                            int stride, const float *gamma, const float *beta,
+                            const float *mean, const float *std) {
+  assert(gamma && beta && beta && std && "batchnorm has null parameter!");
+  for (int ch = 0; ch < channels; ch++) {
+    const float ch_gamma = gamma[ch];
+    const float ch_beta = beta[ch];
+    const float ch_mean = mean[ch];
+    const float ch_std = std[ch];
+    const __m256 gamma_v = _mm256_set1_ps(ch_gamma);
+    const __m256 beta_v = _mm256_set1_ps(ch_beta);
+    const __m256 mean_v = _mm256_set1_ps(ch_mean);
+    const __m256 std_v = _mm256_set1_ps(ch_std);
+    float *image_row = image[ch];
+
+    for (int row = 0; row < height; row++) {
+      int col = 0;
+      for (; col + 8 <= width; col += 8) {
+        const __m256 x = _mm256_loadu_ps(image_row + col);
+        const __m256 scaled =
+            _mm256_mul_ps(gamma_v, _mm256_sub_ps(x, mean_v));
+        _mm256_storeu_ps(image_row + col,
+                         _mm256_add_ps(_mm256_div_ps(scaled, std_v), beta_v));
+      }
+      for (; col < width; col++) {
+        image_row[col] =
+            ch_gamma * (image_row[col] - ch_mean) / ch_std + ch_beta;
+      }
+      image_row += stride;
+    }
+  }
+}
@@ -12,6 +12,10 @@
 #include <stdint.h>
 #include <smmintrin.h>
 
+#include "config/av1_rtcd.h"
+
+#include "aom_ports/mem.h"
+
 // Byte-boundary alignment issues
 #define ALIGN_SIZE 8
 #define ALIGN_MASK (ALIGN_SIZE - 1)
@@ -49,3 +53,90 @@ uint32_t av1_get_crc32c_value_sse4_2(void *crc_calculator, uint8_t *p,
   CALC_CRC(_mm_crc32_u8, crc, uint8_t, buf, len);
   return (crc ^= 0xFFFFFFFF);
 }
+
+static INLINE uint32_t crc32c_u32(uint32_t word) {
+  return _mm_crc32_u32(0xFFFFFFFF, word) ^ 0xFFFFFFFF;
+}
+
+static INLINE uint32_t byte_swap_u32(uint32_t word) {
+  return (word >> 24) | ((word >> 8) & 0xff00) | ((word << 8) & 0xff0000) |
+         (word << 24);
+}
+
+// Hashes 'n' 2x2 blocks given as the 32-bit words { a, b, c, d } of their
+// pixels: the first hash value is the CRC-32C of { a, b, c, d }, the second
+// one the CRC-32C of { d, c, b, a }.
+static INLINE void hash_2x2_words(const uint32_t *pixels, int n,
+                                  uint32_t *hash1, uint32_t *hash2) {
+  for (int i = 0; i < n; i++) {
+    hash1[i] = crc32c_u32(pixels[i]);
+    hash2[i] = crc32c_u32(byte_swap_u32(pixels[i]));
+  }
+}
+
+// Computes the hash values and same-value flags of the 2x2 blocks at
+// src[0..width - 1], 16 blocks per iteration. See av1_hash_block_2x2_row_c().
+void av1_hash_block_2x2_row_sse4_2(void *crc_calculator, const uint8_t *src,
+                                   int stride, int width, uint32_t *hash1,
+                                   uint32_t *hash2, int8_t *row_same,
+                                   int8_t *col_same) {
+  (void)crc_calculator;
+  const uint8_t *src_below = src + stride;
+  const __m128i one = _mm_set1_epi8(1);
+  DECLARE_ALIGNED(16, uint32_t, pixels[16]);
+  int x = 0;
+  for (; x + 16 <= width; x += 16) {
+    const __m128i a = _mm_loadu_si128((const __m128i *)(src + x));
+    const __m128i b = _mm_loadu_si128((const __m128i *)(src + x + 1));
+    const __m128i c = _mm_loadu_si128((const __m128i *)(src_below + x));
+    const __m128i d = _mm_loadu_si128((const __m128i *)(src_below + x + 1));
+    const __m128i rows =
+        _mm_and_si128(_mm_cmpeq_epi8(a, b), _mm_cmpeq_epi8(c, d));
+    const __m128i cols =
+        _mm_and_si128(_mm_cmpeq_epi8(a, c), _mm_cmpeq_epi8(b, d));
+    _mm_storeu_si128((__m128i *)(row_same + x), _mm_and_si128(rows, one));
+    _mm_storeu_si128((__m128i *)(col_same + x), _mm_and_si128(cols, one));
+
+    // The pixels of each 2x2 block, { a, b, c, d }, as a 32-bit word.
+    const __m128i ab_lo = _mm_unpacklo_epi8(a, b);
+    const __m128i ab_hi = _mm_unpackhi_epi8(a, b);
+    const __m128i cd_lo = _mm_unpacklo_epi8(c, d);
+    const __m128i cd_hi = _mm_unpackhi_epi8(c, d);
+    _mm_store_si128((__m128i *)pixels, _mm_unpacklo_epi16(ab_lo, cd_lo));
+    _mm_store_si128((__m128i *)(pixels + 4), _mm_unpackhi_epi16(ab_lo, cd_lo));
+    _mm_store_si128((__m128i *)(pixels + 8), _mm_unpacklo_epi16(ab_hi, cd_hi));
+    _mm_store_si128((__m128i *)(pixels + 12),
+                    _mm_unpackhi_epi16(ab_hi, cd_hi));
+    hash_2x2_words(pixels, 16, hash1 + x, hash2 + x);
+  }
+  for (; x < width; x++) {
+    const uint32_t a = src[x];
+    const uint32_t b = src[x + 1];
+    const uint32_t c = src_below[x];
+    const uint32_t d = src_below[x + 1];
+    const uint32_t block = a | (b << 8) | (c << 16) | (d << 24);
+    row_same[x] = a == b && c == d;
+    col_same[x] = a == c && b == d;
+    hash_2x2_words(&block, 1, hash1 + x, hash2 + x);
+  }
+}
+
+void av1_hash_block_quad_row_sse4_2(void *crc_calculator, const uint32_t *src1,
+                                    const uint32_t *src2, int src_size,
+                                    int stride, int width, uint32_t *dst1,
+                                    uint32_t *dst2) {
+  (void)crc_calculator;
+  const int below = src_size * stride;
+  for (int x = 0; x < width; x++) {
+    uint32_t crc1 = _mm_crc32_u32(0xFFFFFFFF, src1[x]);
+    uint32_t crc2 = _mm_crc32_u32(0xFFFFFFFF, src2[x + below + src_size]);
+    crc1 = _mm_crc32_u32(crc1, src1[x + src_size]);
+    crc2 = _mm_crc32_u32(crc2, src2[x + below]);
+    crc1 = _mm_crc32_u32(crc1, src1[x + below]);
+    crc2 = _mm_crc32_u32(crc2, src2[x + src_size]);
+    crc1 = _mm_crc32_u32(crc1, src1[x + below + src_size]);
+    crc2 = _mm_crc32_u32(crc2, src2[x]);
+    dst1[x] = crc1 ^ 0xFFFFFFFF;
+    dst2[x] = crc2 ^ 0xFFFFFFFF;
+  }
+}
@@ -0,0 +1,177 @@
+/*
+ * Copyright (c) 2022, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#include <assert.h>
+#include <immintrin.h>
+
+#include "config/av1_rtcd.h"
+#include "aom_dsp/aom_dsp_common.h"
+#include "aom_ports/mem.h"
+#include "av1/encoder/ml.h"
+
+// Returns the sums of the 32-bit lanes of s0, s1, s2 and s3 in the 4 lanes of
+// the result.
+static INLINE __m128i hadd_4x8_epi32(__m256i s0, __m256i s1, __m256i s2,
+                                     __m256i s3) {
+  const __m256i s01 = _mm256_hadd_epi32(s0, s1);
+  const __m256i s23 = _mm256_hadd_epi32(s2, s3);
+  const __m256i s0123 = _mm256_hadd_epi32(s01, s23);
+  return _mm_add_epi32(_mm256_castsi256_si128(s0123),
+                       _mm256_extracti128_si256(s0123, 1));
+}
+
+// Computes the weighted sums of 16 inputs at a time with pmaddwd. The sums fit
+// in 32 bits given the limits on the weights, inputs and number of inputs of a
+// NN_CONFIG_INT16.
+void av1_nn_fc_int16_avx2(const int16_t *input, const int16_t *weights,
+                          int num_inputs, int num_outputs, int32_t *output) {
+  assert(num_inputs % NN_INT16_INPUT_ALIGN == 0);
+  int node = 0;
+  for (; node + 4 <= num_outputs; node += 4) {
+    const int16_t *const w0 = weights + node * num_inputs;
+    const int16_t *const w1 = w0 + num_inputs;
+    const int16_t *const w2 = w1 + num_inputs;
+    const int16_t *const w3 = w2 + num_inputs;
+    __m256i s0 = _mm256_setzero_si256();
+    __m256i s1 = _mm256_setzero_si256();
+    __m256i s2 = _mm256_setzero_si256();
+    __m256i s3 = _mm256_setzero_si256();
+    for (int i = 0; i < num_inputs; i += 16) {
+      const __m256i in = _mm256_loadu_si256((const __m256i *)(input + i));
+      s0 = _mm256_add_epi32(
+          s0, _mm256_madd_epi16(
+                  _mm256_loadu_si256((const __m256i *)(w0 + i)), in));
+      s1 = _mm256_add_epi32(
+          s1, _mm256_madd_epi16(
+                  _mm256_loadu_si256((const __m256i *)(w1 + i)), in));
+      s2 = _mm256_add_epi32(
+          s2, _mm256_madd_epi16(
+                  _mm256_loadu_si256((const __m256i *)(w2 + i)), in));
+      s3 = _mm256_add_epi32(
+          s3, _mm256_madd_epi16(
+                  _mm256_loadu_si256((const __m256i *)(w3 + i)), in));
+    }
+    _mm_storeu_si128((__m128i *)(output + node),
+                     hadd_4x8_epi32(s0, s1, s2, s3));
+  }
+  for (; node < num_outputs; ++node) {
+    const int16_t *const w = weights + node * num_inputs;
+    __m256i s = _mm256_setzero_si256();
+    for (int i = 0; i < num_inputs; i += 16) {
+      const __m256i in = _mm256_loadu_si256((const __m256i *)(input + i));
+      s = _mm256_add_epi32(
+          s, _mm256_madd_epi16(_mm256_loadu_si256((const __m256i *)(w + i)),
+                               in));
+    }
+    const __m128i sum = hadd_4x8_epi32(s, s, s, s);
+    output[node] = _mm_cvtsi128_si32(sum);
+  }
+}
+
+// Evaluates the network on up to 8 feature vectors, one per lane, so each
+// weight is loaded once for all of them. The sums of each lane are computed in
+// the same order as av1_nn_predict_c(), without fused multiply-adds, so the
+// results are identical.
+static void nn_predict_8x(const float *input_nodes, int num_blocks,
+                          const NN_CONFIG *const nn_config,
+                          float *const output) {
+  assert(num_blocks > 0 && num_blocks <= 8);
+  __m256 buf[2][NN_MAX_NODES_PER_LAYER];
+  const __m256 zero = _mm256_setzero_ps();
+  int num_input_nodes = nn_config->num_inputs;
+  assert(num_input_nodes <= NN_MAX_NODES_PER_LAYER);
+
+  // Transpose the inputs so that each vector holds one feature of all blocks.
+  const __m256i lane = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+  const __m256i offsets =
+      _mm256_mullo_epi32(lane, _mm256_set1_epi32(num_input_nodes));
+  const __m256 mask = _mm256_castsi256_ps(
+      _mm256_cmpgt_epi32(_mm256_set1_epi32(num_blocks), lane));
+  for (int i = 0; i < num_input_nodes; ++i) {
+    buf[0][i] =
+        _mm256_mask_i32gather_ps(zero, input_nodes + i, offsets, mask, 4);
+  }
+
+  const int num_layers = nn_config->num_hidden_layers;
+  assert(num_layers <= NN_MAX_HIDDEN_LAYERS);
+  const __m256 *in = buf[0];
+  int buf_index = 1;
+  for (int layer = 0; layer <= num_layers; ++layer) {
+    const int is_output_layer = layer == num_layers;
+    const int num_output_nodes = is_output_layer
+                                     ? nn_config->num_outputs
+                                     : nn_config->num_hidden_nodes[layer];
+    assert(num_output_nodes <= NN_MAX_NODES_PER_LAYER);
+    const float *const layer_weights = nn_config->weights[layer];
+    const float *const layer_bias = nn_config->bias[layer];
+    __m256 *const out = buf[buf_index];
+    int node = 0;
+    // Interleave the sums of 4 nodes to hide the latency of the additions.
+    for (; node + 4 <= num_output_nodes; node += 4) {
+      const float *const w0 = layer_weights + node * num_input_nodes;
+      const float *const w1 = w0 + num_input_nodes;
+      const float *const w2 = w1 + num_input_nodes;
+      const float *const w3 = w2 + num_input_nodes;
+      __m256 val0 = _mm256_set1_ps(layer_bias[node]);
+      __m256 val1 = _mm256_set1_ps(layer_bias[node + 1]);
+      __m256 val2 = _mm256_set1_ps(layer_bias[node + 2]);
+      __m256 val3 = _mm256_set1_ps(layer_bias[node + 3]);
+      for (int i = 0; i < num_input_nodes; ++i) {
+        val0 = _mm256_add_ps(val0, _mm256_mul_ps(_mm256_set1_ps(w0[i]), in[i]));
+        val1 = _mm256_add_ps(val1, _mm256_mul_ps(_mm256_set1_ps(w1[i]), in[i]));
+        val2 = _mm256_add_ps(val2, _mm256_mul_ps(_mm256_set1_ps(w2[i]), in[i]));
+        val3 = _mm256_add_ps(val3, _mm256_mul_ps(_mm256_set1_ps(w3[i]), in[i]));
+      }
+      if (!is_output_layer) {
+        // ReLU as activation function.
+        val0 = _mm256_max_ps(val0, zero);
+        val1 = _mm256_max_ps(val1, zero);
+        val2 = _mm256_max_ps(val2, zero);
+        val3 = _mm256_max_ps(val3, zero);
+      }
+      out[node] = val0;
+      out[node + 1] = val1;
+      out[node + 2] = val2;
+      out[node + 3] = val3;
+    }
+    for (; node < num_output_nodes; ++node) {
+      const float *const w = layer_weights + node * num_input_nodes;
+      __m256 val = _mm256_set1_ps(layer_bias[node]);
+      for (int i = 0; i < num_input_nodes; ++i)
+        val = _mm256_add_ps(val, _mm256_mul_ps(_mm256_set1_ps(w[i]), in[i]));
+      if (!is_output_layer) val = _mm256_max_ps(val, zero);
+      out[node] = val;
+    }
+    num_input_nodes = num_output_nodes;
+    in = out;
+    buf_index = 1 - buf_index;
+  }
+
+  const int num_outputs = nn_config->num_outputs;
+  for (int node = 0; node < num_outputs; ++node) {
+    DECLARE_ALIGNED(32, float, vals[8]);
+    _mm256_store_ps(vals, in[node]);
+    for (int i = 0; i < num_blocks; ++i)
+      output[i * num_outputs + node] = vals[i];
+  }
+}
+
+void av1_nn_predict_batch_avx2(const float *input_nodes, int num_blocks,
+                               const NN_CONFIG *const nn_config,
+                               int reduce_prec, float *const output) {
+  const int num_inputs = nn_config->num_inputs;
+  const int num_outputs = nn_config->num_outputs;
+  for (int i = 0; i < num_blocks; i += 8) {
+    nn_predict_8x(input_nodes + i * num_inputs, AOMMIN(num_blocks - i, 8),
+                  nn_config, output + i * num_outputs);
+  }
+  if (reduce_prec) av1_nn_output_prec_reduce(output, num_blocks * num_outputs);
+}
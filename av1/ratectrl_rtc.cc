@@ -11,8 +11,11 @@
 
 #include "av1/ratectrl_rtc.h"
 
+#include <cstddef>
+#include <cstring>
 #include <memory>
 #include <new>
+#include <vector>
 
 #include "aom/aomcx.h"
 #include "aom/aom_encoder.h"
@@ -99,6 +102,7 @@ AV1RateControlRTC::~AV1RateControlRTC() {
       cpi_->enc_seg.map = nullptr;
       av1_cyclic_refresh_free(cpi_->cyclic_refresh);
     }
+    aom_free(cpi_->ppi);
     aom_free(cpi_);
   }
 }
@@ -296,4 +300,305 @@ void AV1RateControlRTC::PostEncodeUpdate(uint64_t encoded_frame_size) {
   cpi_->common.current_frame.frame_number++;
 }
 
+namespace {
+
+// The one pass rate control does not use the first pass regions, which take
+// most of PRIMARY_RATE_CONTROL. The streams keep the fields around them.
+constexpr size_t kRegionsOffset = offsetof(PRIMARY_RATE_CONTROL, regions);
+constexpr size_t kRegionsSize = sizeof(PRIMARY_RATE_CONTROL::regions);
+constexpr size_t kStreamPrimaryRcSize =
+    sizeof(PRIMARY_RATE_CONTROL) - kRegionsSize;
+// Each layer context holds a PRIMARY_RATE_CONTROL as well.
+constexpr size_t kLayerRegionsOffset =
+    offsetof(LAYER_CONTEXT, p_rc) + kRegionsOffset;
+constexpr size_t kStreamLayerSize = sizeof(LAYER_CONTEXT) - kRegionsSize;
+// The layer contexts of SVC are kept separately, for the active layers only.
+constexpr size_t kLayersOffset = offsetof(SVC, layer_context);
+constexpr size_t kLayersSize = sizeof(SVC::layer_context);
+constexpr size_t kStreamSvcSize = sizeof(SVC) - kLayersSize;
+
+// Copies the 'size' bytes at 'src' to 'dst', leaving out the 'gap_size' bytes
+// at offset 'gap'.
+void pack(uint8_t *dst, const void *src, size_t size, size_t gap,
+          size_t gap_size) {
+  const uint8_t *const src8 = static_cast<const uint8_t *>(src);
+  memcpy(dst, src8, gap);
+  memcpy(dst + gap, src8 + gap + gap_size, size - gap - gap_size);
+}
+
+// Reverses pack(), leaving the 'gap_size' bytes at offset 'gap' of 'dst'
+// unchanged.
+void unpack(void *dst, const uint8_t *src, size_t size, size_t gap,
+            size_t gap_size) {
+  uint8_t *const dst8 = static_cast<uint8_t *>(dst);
+  memcpy(dst8, src, gap);
+  memcpy(dst8 + gap + gap_size, src + gap, size - gap - gap_size);
+}
+
+int num_active_layers(const SVC *svc) {
+  const int num_layers =
+      svc->number_spatial_layers * svc->number_temporal_layers;
+  return num_layers > 1 ? num_layers : 0;
+}
+
+}  // namespace
+
+// The state of one stream of AV1RateControlRTCBatch: the parts of AV1_COMP
+// that rate control keeps across frames, or between ComputeQP() and
+// PostEncodeUpdate(), and that differ between streams.
+struct AV1RateControlRtcStream {
+  // The fields of AV1EncoderConfig set from AV1RateControlRtcConfig. The rest
+  // of the config is the same for all streams.
+  RateControlCfg rc_cfg;
+  int config_width;
+  int config_height;
+  double init_framerate;
+  AQ_MODE aq_mode;
+  RATE_CONTROL rc;
+  uint8_t p_rc[kStreamPrimaryRcSize];
+  struct segmentation seg;
+  int width;
+  int height;
+  int initial_width;
+  int initial_height;
+  FRAME_TYPE frame_type;
+  unsigned int frame_number;
+  int base_qindex;
+  double framerate;
+  bool refresh_golden_frame;
+  int use_svc;
+  BLOCK_SIZE sb_size;
+  int max_mv_magnitude;
+  FRAME_UPDATE_TYPE update_type;
+  FRAME_TYPE gf_frame_type;
+  REFBUF_STATE refbuf_state;
+  CYCLIC_REFRESH *cyclic_refresh;
+  uint8_t *seg_map;
+  uint8_t svc[kStreamSvcSize];
+  // The layer contexts, only for streams with spatial or temporal layers.
+  std::vector<uint8_t> layers;
+};
+
+std::unique_ptr<AV1RateControlRTCBatch> AV1RateControlRTCBatch::Create() {
+  std::unique_ptr<AV1RateControlRTCBatch> batch(new (std::nothrow)
+                                                    AV1RateControlRTCBatch());
+  if (!batch) return nullptr;
+  batch->rc_ = AV1RateControlRTC::Create(AV1RateControlRtcConfig());
+  if (!batch->rc_) return nullptr;
+  return batch;
+}
+
+AV1RateControlRTCBatch::~AV1RateControlRTCBatch() {
+  for (size_t i = 0; i < streams_.size(); ++i) {
+    if (streams_[i]) RemoveStream(static_cast<int>(i));
+  }
+}
+
+AV1RateControlRtcStream *AV1RateControlRTCBatch::GetStream(
+    int stream_id) const {
+  if (stream_id < 0 || static_cast<size_t>(stream_id) >= streams_.size())
+    return nullptr;
+  return streams_[stream_id].get();
+}
+
+bool AV1RateControlRTCBatch::HasStreams(
+    const AV1RateControlRtcBatchFrames &frames) const {
+  for (int i = 0; i < frames.num_streams; ++i) {
+    if (!GetStream(frames.stream_ids[i])) return false;
+  }
+  return true;
+}
+
+void AV1RateControlRTCBatch::LoadStream(const AV1RateControlRtcStream &stream) {
+  AV1_COMP *const cpi = rc_->cpi_;
+  AV1_COMMON *const cm = &cpi->common;
+  AV1EncoderConfig *const oxcf = &cpi->oxcf;
+  oxcf->rc_cfg = stream.rc_cfg;
+  oxcf->frm_dim_cfg.width = stream.config_width;
+  oxcf->frm_dim_cfg.height = stream.config_height;
+  oxcf->input_cfg.init_framerate = stream.init_framerate;
+  oxcf->q_cfg.aq_mode = stream.aq_mode;
+  cpi->rc = stream.rc;
+  unpack(&cpi->ppi->p_rc, stream.p_rc, sizeof(cpi->ppi->p_rc), kRegionsOffset,
+         kRegionsSize);
+  cm->seg = stream.seg;
+  cm->width = stream.width;
+  cm->height = stream.height;
+  rc_->initial_width_ = stream.initial_width;
+  rc_->initial_height_ = stream.initial_height;
+  cm->current_frame.frame_type = stream.frame_type;
+  cm->current_frame.frame_number = stream.frame_number;
+  cm->quant_params.base_qindex = stream.base_qindex;
+  cpi->framerate = stream.framerate;
+  cpi->refresh_frame.golden_frame = stream.refresh_golden_frame;
+  cpi->ppi->use_svc = stream.use_svc;
+  set_sb_size(cm->seq_params, stream.sb_size);
+  cpi->mv_search_params.max_mv_magnitude = stream.max_mv_magnitude;
+  GF_GROUP *const gf_group = &cpi->ppi->gf_group;
+  gf_group->update_type[cpi->gf_frame_index] = stream.update_type;
+  gf_group->frame_type[cpi->gf_frame_index] = stream.gf_frame_type;
+  gf_group->refbuf_state[cpi->gf_frame_index] = stream.refbuf_state;
+  cpi->cyclic_refresh = stream.cyclic_refresh;
+  cpi->enc_seg.map = stream.seg_map;
+  unpack(&cpi->svc, stream.svc, sizeof(cpi->svc), kLayersOffset, kLayersSize);
+  const int num_layers =
+      static_cast<int>(stream.layers.size() / kStreamLayerSize);
+  for (int layer = 0; layer < num_layers; ++layer) {
+    unpack(&cpi->svc.layer_context[layer],
+           &stream.layers[layer * kStreamLayerSize], sizeof(LAYER_CONTEXT),
+           kLayerRegionsOffset, kRegionsSize);
+  }
+  enc_set_mb_mi(&cm->mi_params, cm->width, cm->height, cpi->oxcf.mode,
+                BLOCK_8X8);
+}
+
+void AV1RateControlRTCBatch::SaveStream(AV1RateControlRtcStream *stream) const {
+  const AV1_COMP *const cpi = rc_->cpi_;
+  const AV1_COMMON *const cm = &cpi->common;
+  const AV1EncoderConfig *const oxcf = &cpi->oxcf;
+  stream->rc_cfg = oxcf->rc_cfg;
+  stream->config_width = oxcf->frm_dim_cfg.width;
+  stream->config_height = oxcf->frm_dim_cfg.height;
+  stream->init_framerate = oxcf->input_cfg.init_framerate;
+  stream->aq_mode = oxcf->q_cfg.aq_mode;
+  stream->rc = cpi->rc;
+  pack(stream->p_rc, &cpi->ppi->p_rc, sizeof(cpi->ppi->p_rc), kRegionsOffset,
+       kRegionsSize);
+  stream->seg = cm->seg;
+  stream->width = cm->width;
+  stream->height = cm->height;
+  stream->initial_width = rc_->initial_width_;
+  stream->initial_height = rc_->initial_height_;
+  stream->frame_type = cm->current_frame.frame_type;
+  stream->frame_number = cm->current_frame.frame_number;
+  stream->base_qindex = cm->quant_params.base_qindex;
+  stream->framerate = cpi->framerate;
+  stream->refresh_golden_frame = cpi->refresh_frame.golden_frame;
+  stream->use_svc = cpi->ppi->use_svc;
+  stream->sb_size = cm->seq_params->sb_size;
+  stream->max_mv_magnitude = cpi->mv_search_params.max_mv_magnitude;
+  const GF_GROUP *const gf_group = &cpi->ppi->gf_group;
+  stream->update_type = gf_group->update_type[cpi->gf_frame_index];
+  stream->gf_frame_type = gf_group->frame_type[cpi->gf_frame_index];
+  stream->refbuf_state = gf_group->refbuf_state[cpi->gf_frame_index];
+  stream->cyclic_refresh = cpi->cyclic_refresh;
+  stream->seg_map = cpi->enc_seg.map;
+  pack(stream->svc, &cpi->svc, sizeof(cpi->svc), kLayersOffset, kLayersSize);
+  const int num_layers = num_active_layers(&cpi->svc);
+  stream->layers.resize(num_layers * kStreamLayerSize);
+  for (int layer = 0; layer < num_layers; ++layer) {
+    pack(&stream->layers[layer * kStreamLayerSize],
+         &cpi->svc.layer_context[layer], sizeof(LAYER_CONTEXT),
+         kLayerRegionsOffset, kRegionsSize);
+  }
+}
+
+int AV1RateControlRTCBatch::AddStream(const AV1RateControlRtcConfig &rc_cfg) {
+  std::unique_ptr<AV1RateControlRtcStream> stream(
+      new (std::nothrow) AV1RateControlRtcStream());
+  if (!stream) return -1;
+  // Start from a clean encoder state, as AV1RateControlRTC::Create() does.
+  AV1_COMP *const cpi = rc_->cpi_;
+  LoadStream(*stream);
+  av1_zero(cpi->svc);
+  rc_->InitRateControl(rc_cfg);
+  bool ok = true;
+  if (rc_cfg.aq_mode) {
+    cpi->enc_seg.map = static_cast<uint8_t *>(aom_calloc(
+        cpi->common.mi_params.mi_rows * cpi->common.mi_params.mi_cols,
+        sizeof(*cpi->enc_seg.map)));
+    cpi->cyclic_refresh = av1_cyclic_refresh_alloc(
+        cpi->common.mi_params.mi_rows, cpi->common.mi_params.mi_cols);
+    ok = cpi->enc_seg.map && cpi->cyclic_refresh;
+  }
+  SaveStream(stream.get());
+
+  size_t id = 0;
+  while (id < streams_.size() && streams_[id]) ++id;
+  if (id == streams_.size()) streams_.emplace_back();
+  streams_[id] = std::move(stream);
+  if (!ok) {
+    RemoveStream(static_cast<int>(id));
+    return -1;
+  }
+  return static_cast<int>(id);
+}
+
+bool AV1RateControlRTCBatch::RemoveStream(int stream_id) {
+  AV1RateControlRtcStream *const stream = GetStream(stream_id);
+  if (!stream) return false;
+  // The layer maps are only reachable through the loaded layer contexts.
+  LoadStream(*stream);
+  AV1_COMP *const cpi = rc_->cpi_;
+  SVC *const svc = &cpi->svc;
+  if (num_active_layers(svc)) {
+    for (int sl = 0; sl < svc->number_spatial_layers; sl++) {
+      for (int tl = 0; tl < svc->number_temporal_layers; tl++) {
+        const int layer = LAYER_IDS_TO_IDX(sl, tl, svc->number_temporal_layers);
+        aom_free(svc->layer_context[layer].map);
+      }
+    }
+  }
+  aom_free(stream->seg_map);
+  av1_cyclic_refresh_free(stream->cyclic_refresh);
+  // Leave nothing of the stream in the shared encoder for its destructor.
+  svc->number_spatial_layers = 1;
+  svc->number_temporal_layers = 1;
+  cpi->enc_seg.map = nullptr;
+  cpi->cyclic_refresh = nullptr;
+  streams_[stream_id].reset();
+  return true;
+}
+
+bool AV1RateControlRTCBatch::UpdateRateControl(
+    int stream_id, const AV1RateControlRtcConfig &rc_cfg) {
+  AV1RateControlRtcStream *const stream = GetStream(stream_id);
+  if (!stream) return false;
+  LoadStream(*stream);
+  rc_->UpdateRateControl(rc_cfg);
+  SaveStream(stream);
+  return true;
+}
+
+signed char *AV1RateControlRTCBatch::GetCyclicRefreshMap(int stream_id) const {
+  const AV1RateControlRtcStream *const stream = GetStream(stream_id);
+  if (!stream || !stream->cyclic_refresh) return nullptr;
+  return stream->cyclic_refresh->map;
+}
+
+int *AV1RateControlRTCBatch::GetDeltaQ(int stream_id) const {
+  const AV1RateControlRtcStream *const stream = GetStream(stream_id);
+  if (!stream || !stream->cyclic_refresh) return nullptr;
+  return stream->cyclic_refresh->qindex_delta;
+}
+
+bool AV1RateControlRTCBatch::ComputeQP(
+    const AV1RateControlRtcBatchFrames &frames) {
+  if (!HasStreams(frames)) return false;
+  for (int i = 0; i < frames.num_streams; ++i) {
+    AV1RateControlRtcStream *const stream = GetStream(frames.stream_ids[i]);
+    AV1FrameParamsRTC frame_params;
+    frame_params.frame_type = frames.frame_types[i];
+    frame_params.spatial_layer_id = frames.spatial_layer_ids[i];
+    frame_params.temporal_layer_id = frames.temporal_layer_ids[i];
+    LoadStream(*stream);
+    rc_->ComputeQP(frame_params);
+    frames.qps[i] = rc_->GetQP();
+    SaveStream(stream);
+  }
+  return true;
+}
+
+bool AV1RateControlRTCBatch::PostEncodeUpdate(
+    const AV1RateControlRtcBatchFrames &frames) {
+  if (!HasStreams(frames)) return false;
+  for (int i = 0; i < frames.num_streams; ++i) {
+    AV1RateControlRtcStream *const stream = GetStream(frames.stream_ids[i]);
+    LoadStream(*stream);
+    rc_->PostEncodeUpdate(frames.encoded_frame_sizes[i]);
+    SaveStream(stream);
+  }
+  return true;
+}
+
 }  // namespace aom
@@ -14,8 +14,10 @@
 
 #include <cstdint>
 #include <memory>
+#include <vector>
 
 struct AV1_COMP;
+struct SVC;
 
 namespace aom {
 
@@ -79,6 +81,7 @@ class AV1RateControlRTC {
   void PostEncodeUpdate(uint64_t encoded_frame_size);
 
  private:
+  friend class AV1RateControlRTCBatch;
   AV1RateControlRTC() = default;
   void InitRateControl(const AV1RateControlRtcConfig &cfg);
   AV1_COMP *cpi_;
@@ -86,6 +89,61 @@ class AV1RateControlRTC {
   int initial_height_;
 };
 
+// Frames of several streams for AV1RateControlRTCBatch, in a structure of
+// arrays layout: entry i of each array belongs to stream stream_ids[i].
+struct AV1RateControlRtcBatchFrames {
+  int num_streams;
+  const int *stream_ids;
+  // Inputs of ComputeQP().
+  const FRAME_TYPE *frame_types;
+  const int *spatial_layer_ids;
+  const int *temporal_layer_ids;
+  // Output of ComputeQP().
+  int *qps;
+  // Input of PostEncodeUpdate().
+  const uint64_t *encoded_frame_sizes;
+};
+
+struct AV1RateControlRtcStream;
+
+// Rate control for many streams. Each stream only keeps the state that the
+// rate control carries from frame to frame and that differs between streams
+// (RATE_CONTROL, PRIMARY_RATE_CONTROL without the first pass regions, SVC with
+// its active layers, CYCLIC_REFRESH and the rate control fields of the
+// config), and is loaded into a single encoder instance shared by all
+// streams for each update. The results are identical to one
+// AV1RateControlRTC per stream.
+class AV1RateControlRTCBatch {
+ public:
+  static std::unique_ptr<AV1RateControlRTCBatch> Create();
+  ~AV1RateControlRTCBatch();
+
+  // Returns the id of the new stream, or -1 on failure.
+  int AddStream(const AV1RateControlRtcConfig &rc_cfg);
+  // The functions taking stream ids return false, or nullptr, for ids that
+  // are not those of current streams, without updating any stream.
+  bool RemoveStream(int stream_id);
+  bool UpdateRateControl(int stream_id, const AV1RateControlRtcConfig &rc_cfg);
+  // Return nullptr as well for streams without cyclic refresh (aq_mode 0).
+  signed char *GetCyclicRefreshMap(int stream_id) const;
+  int *GetDeltaQ(int stream_id) const;
+  // Sets frames.qps[i] to the QP of the next frame of each stream.
+  bool ComputeQP(const AV1RateControlRtcBatchFrames &frames);
+  // Feedback to rate control with the encoded size of the frames of the last
+  // ComputeQP() call of each stream.
+  bool PostEncodeUpdate(const AV1RateControlRtcBatchFrames &frames);
+
+ private:
+  AV1RateControlRTCBatch() = default;
+  AV1RateControlRtcStream *GetStream(int stream_id) const;
+  // Returns true if all of frames.stream_ids are current streams.
+  bool HasStreams(const AV1RateControlRtcBatchFrames &frames) const;
+  void LoadStream(const AV1RateControlRtcStream &stream);
+  void SaveStream(AV1RateControlRtcStream *stream) const;
+  std::unique_ptr<AV1RateControlRTC> rc_;
+  std::vector<std::unique_ptr<AV1RateControlRtcStream>> streams_;
+};
+
 }  // namespace aom
 
 #endif  // AOM_AV1_RATECTRL_RTC_H_
@@ -235,6 +235,53 @@ TEST(AV1FwdTxfm2d, CfgTest) {
   }
 }
 
+TEST(AV1FwdTxfm2d, TxTypesMatch) {
+  ACMRandom rnd(ACMRandom::DeterministicSeed());
+  const int input_stride = 64;
+  DECLARE_ALIGNED(32, int16_t, input[32 * 64]);
+  DECLARE_ALIGNED(32, int32_t, output[TX_TYPES * 32 * 32]);
+  DECLARE_ALIGNED(32, int32_t, ref_output[32 * 32]);
+  for (int bd_idx = 0; bd_idx < BD_NUM; ++bd_idx) {
+    const int bd = libaom_test::bd_arr[bd_idx];
+    for (int tx_size = 0; tx_size < TX_SIZES_ALL; ++tx_size) {
+      const int rows = tx_size_high[tx_size];
+      const int cols = tx_size_wide[tx_size];
+      if (rows > 32 || cols > 32) continue;
+      uint16_t tx_mask = 0;
+      for (int tx_type = 0; tx_type < TX_TYPES; ++tx_type) {
+        if (libaom_test::IsTxSizeTypeValid(static_cast<TX_SIZE>(tx_size),
+                                           static_cast<TX_TYPE>(tx_type)))
+          tx_mask |= 1 << tx_type;
+      }
+      FwdTxfm2dFunc ref_func = libaom_test::fwd_txfm_func_ls[tx_size];
+      for (int cnt = 0; cnt < 50; ++cnt) {
+        for (int r = 0; r < rows; ++r) {
+          for (int c = 0; c < cols; ++c) {
+            const int max_val = (1 << bd) - 1;
+            input[r * input_stride + c] =
+                cnt == 0 ? max_val
+                         : (cnt == 1 ? -max_val
+                                     : rnd.Rand16() % (2 * max_val + 1) -
+                                           max_val);
+          }
+        }
+        av1_fwd_txfm2d_tx_types(input, output, input_stride,
+                                static_cast<TX_SIZE>(tx_size), tx_mask, bd);
+        for (int tx_type = 0; tx_type < TX_TYPES; ++tx_type) {
+          if (!(tx_mask & (1 << tx_type))) continue;
+          ref_func(input, ref_output, input_stride,
+                   static_cast<TX_TYPE>(tx_type), bd);
+          for (int i = 0; i < rows * cols; ++i) {
+            ASSERT_EQ(ref_output[i], output[tx_type * rows * cols + i])
+                << "i: " << i << " cnt: " << cnt << " bd: " << bd
+                << " tx_size: " << tx_size << " tx_type: " << tx_type;
+          }
+        }
+      }
+    }
+  }
+}
+
 typedef void (*lowbd_fwd_txfm_func)(const int16_t *src_diff, tran_low_t *coeff,
                                     int diff_stride, TxfmParam *txfm_param);
 
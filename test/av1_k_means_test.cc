@@ -253,6 +253,56 @@ TEST_P(AV1KmeansTest2, DISABLED_Speed) {
   RunSpeedTest(GET_PARAM(0), GET_PARAM(1), 8);
 }
 
+// av1_k_means_colors() clusters the distinct colors of a block weighted by
+// their counts, and must find the same centroids as av1_k_means_dim1_c() on
+// the pixels themselves.
+TEST(AV1KmeansColorsTest, MatchesKmeansOnPixels) {
+  libaom_test::ACMRandom rnd(libaom_test::ACMRandom::DeterministicSeed());
+  const int kNumTests = 2000;
+  int data[64 * 64];
+  uint8_t indices[64 * 64];
+  for (int i = 0; i < kNumTests; ++i) {
+    const int n = 16 * (1 + rnd(256));
+    const int num_palette = 1 + rnd(MAX_PALETTE_COLORS_FOR_K_MEANS);
+    int palette[MAX_PALETTE_COLORS_FOR_K_MEANS];
+    for (int j = 0; j < num_palette; ++j) palette[j] = rnd.Rand8();
+    for (int j = 0; j < n; ++j) data[j] = palette[rnd(num_palette)];
+
+    int count_buf[256] = { 0 };
+    int lower_bound = 255, upper_bound = 0;
+    for (int j = 0; j < n; ++j) {
+      ++count_buf[data[j]];
+      lower_bound = AOMMIN(lower_bound, data[j]);
+      upper_bound = AOMMAX(upper_bound, data[j]);
+    }
+    int values[MAX_PALETTE_COLORS_FOR_K_MEANS];
+    int counts[MAX_PALETTE_COLORS_FOR_K_MEANS];
+    int num_values = 0;
+    for (int j = 0; j < 256; ++j) {
+      if (count_buf[j] == 0) continue;
+      values[num_values] = j;
+      counts[num_values++] = count_buf[j];
+    }
+
+    const int k =
+        PALETTE_MIN_SIZE + rnd(PALETTE_MAX_SIZE - PALETTE_MIN_SIZE + 1);
+    const int max_itr = 1 + rnd(50);
+    int centroids_ref[PALETTE_MAX_SIZE];
+    int centroids[PALETTE_MAX_SIZE];
+    for (int j = 0; j < k; ++j) {
+      centroids_ref[j] = centroids[j] =
+          lower_bound + (2 * j + 1) * (upper_bound - lower_bound) / k / 2;
+    }
+    av1_k_means_dim1_c(data, centroids_ref, indices, n, k, max_itr);
+    av1_k_means_colors(values, counts, num_values, data, n, centroids, k,
+                       max_itr);
+    for (int j = 0; j < k; ++j) {
+      ASSERT_EQ(centroids_ref[j], centroids[j])
+          << "test " << i << " k " << k << " centroid " << j;
+    }
+  }
+}
+
 #if HAVE_AVX2 || HAVE_SSE2
 const BLOCK_SIZE kValidBlockSize[] = { BLOCK_8X8,   BLOCK_8X16,  BLOCK_8X32,
                                        BLOCK_16X8,  BLOCK_16X16, BLOCK_16X32,
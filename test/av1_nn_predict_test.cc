@@ -9,12 +9,15 @@
  * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
  */
 
+#include <memory>
 #include <tuple>
 
 #include "third_party/googletest/src/googletest/include/gtest/gtest.h"
 
 #include "aom/aom_integer.h"
+#include "aom_mem/aom_mem.h"
 #include "aom_ports/aom_timer.h"
+#include "aom_ports/mem.h"
 #include "av1/encoder/ml.h"
 #include "config/aom_config.h"
 #include "config/aom_dsp_rtcd.h"
@@ -215,4 +218,215 @@ INSTANTIATE_TEST_SUITE_P(NEON, NnPredictTest,
                          ::testing::Values(av1_nn_predict_neon));
 #endif
 
+typedef void (*NnPredictBatch_Func)(const float *input_nodes, int num_blocks,
+                                    const NN_CONFIG *const nn_config,
+                                    int reduce_prec, float *const output);
+
+class NnPredictBatchTest
+    : public ::testing::TestWithParam<NnPredictBatch_Func> {
+ protected:
+  void RunTest(const NN_CONFIG &shape);
+
+  libaom_test::ACMRandom rng_;
+};
+GTEST_ALLOW_UNINSTANTIATED_PARAMETERIZED_TEST(NnPredictBatchTest);
+
+void NnPredictBatchTest::RunTest(const NN_CONFIG &shape) {
+  const int kMaxBlocks = 20;
+  const int kNumLayers = NN_MAX_HIDDEN_LAYERS + 1;
+  const int kMaxNodes2 = NN_MAX_NODES_PER_LAYER * NN_MAX_NODES_PER_LAYER;
+  std::unique_ptr<float[]> weights_buf(new float[kMaxNodes2 * kNumLayers]);
+  std::unique_ptr<float[]> bias_buf(
+      new float[NN_MAX_NODES_PER_LAYER * kNumLayers]);
+  std::unique_ptr<float[]> inputs(
+      new float[kMaxBlocks * NN_MAX_NODES_PER_LAYER]);
+  std::unique_ptr<float[]> outputs_ref(
+      new float[kMaxBlocks * NN_MAX_NODES_PER_LAYER]);
+  std::unique_ptr<float[]> outputs_test(
+      new float[kMaxBlocks * NN_MAX_NODES_PER_LAYER]);
+  ASSERT_NE(weights_buf, nullptr);
+  ASSERT_NE(bias_buf, nullptr);
+  ASSERT_NE(inputs, nullptr);
+  ASSERT_NE(outputs_ref, nullptr);
+  ASSERT_NE(outputs_test, nullptr);
+
+  NN_CONFIG nn_config;
+  memcpy(&nn_config, &shape, sizeof(nn_config));
+  for (int i = 0; i < kNumLayers; i++) {
+    nn_config.weights[i] = &weights_buf[i * kMaxNodes2];
+    nn_config.bias[i] = &bias_buf[i * NN_MAX_NODES_PER_LAYER];
+  }
+  const int num_layers = shape.num_hidden_layers + 1;
+  for (int iter = 0; iter < 20; ++iter) {
+    for (int i = 0; i < kMaxNodes2 * num_layers; i++) {
+      weights_buf[i] = ((float)rng_.Rand31() - (1 << 30)) / (1u << 31);
+    }
+    for (int i = 0; i < NN_MAX_NODES_PER_LAYER * num_layers; i++) {
+      bias_buf[i] = ((float)rng_.Rand31() - (1 << 30)) / (1u << 31);
+    }
+    for (int num_blocks = 1; num_blocks <= kMaxBlocks; num_blocks++) {
+      for (int i = 0; i < num_blocks * shape.num_inputs; i++) {
+        inputs[i] = ((float)rng_.Rand31() - (1 << 30)) / (1u << 31);
+      }
+      const int reduce_prec = num_blocks & 1;
+      for (int i = 0; i < num_blocks; i++) {
+        av1_nn_predict_c(&inputs[i * shape.num_inputs], &nn_config,
+                         reduce_prec, &outputs_ref[i * shape.num_outputs]);
+      }
+      API_REGISTER_STATE_CHECK(GetParam()(inputs.get(), num_blocks, &nn_config,
+                                          reduce_prec, outputs_test.get()));
+      for (int i = 0; i < num_blocks * shape.num_outputs; i++) {
+        ASSERT_EQ(outputs_ref[i], outputs_test[i])
+            << "shape " << shape.num_inputs << "x" << shape.num_hidden_nodes[0]
+            << "x" << shape.num_outputs << " blocks " << num_blocks
+            << " output " << i;
+      }
+    }
+  }
+}
+
+TEST_P(NnPredictBatchTest, RandomValues) {
+  for (const NN_CONFIG &shape : shapes) RunTest(shape);
+}
+
+#if HAVE_AVX2
+INSTANTIATE_TEST_SUITE_P(AVX2, NnPredictBatchTest,
+                         ::testing::Values(av1_nn_predict_batch_avx2));
+#endif
+
+// Checks that the fixed point network follows the floating point one.
+TEST(NnPredictInt16Test, RandomValues) {
+  const int kMaxNodes2 = NN_MAX_NODES_PER_LAYER * NN_MAX_NODES_PER_LAYER;
+  const int kNumLayers = NN_MAX_HIDDEN_LAYERS + 1;
+  libaom_test::ACMRandom rng;
+  std::unique_ptr<float[]> weights_buf(new float[kMaxNodes2 * kNumLayers]);
+  std::unique_ptr<float[]> bias_buf(
+      new float[NN_MAX_NODES_PER_LAYER * kNumLayers]);
+  ASSERT_NE(weights_buf, nullptr);
+  ASSERT_NE(bias_buf, nullptr);
+  float inputs[NN_MAX_NODES_PER_LAYER] = { 0 };
+  float outputs_test[NN_MAX_NODES_PER_LAYER] = { 0 };
+  float outputs_ref[NN_MAX_NODES_PER_LAYER] = { 0 };
+
+  for (const NN_CONFIG &shape : shapes) {
+    NN_CONFIG nn_config;
+    memcpy(&nn_config, &shape, sizeof(nn_config));
+    for (int i = 0; i < kNumLayers; i++) {
+      nn_config.weights[i] = &weights_buf[i * kMaxNodes2];
+      nn_config.bias[i] = &bias_buf[i * NN_MAX_NODES_PER_LAYER];
+    }
+    std::unique_ptr<int16_t[]> int16_buf(
+        new int16_t[av1_nn_int16_buffer_size(&nn_config)]);
+    ASSERT_NE(int16_buf, nullptr);
+
+    for (int iter = 0; iter < 1000; ++iter) {
+      // Vary the scale of the inputs, as the features of the encoder models are
+      // not normalized.
+      const float input_scale = (float)(1 << (rng.Rand8() % 16));
+      for (int node = 0; node < shape.num_inputs; node++) {
+        inputs[node] =
+            input_scale * ((float)rng.Rand31() - (1 << 30)) / (1u << 31);
+      }
+      const int num_layers = shape.num_hidden_layers + 1;
+      for (int i = 0; i < kMaxNodes2 * num_layers; i++) {
+        weights_buf[i] = ((float)rng.Rand31() - (1 << 30)) / (1u << 31);
+      }
+      for (int i = 0; i < NN_MAX_NODES_PER_LAYER * num_layers; i++) {
+        bias_buf[i] = ((float)rng.Rand31() - (1 << 30)) / (1u << 31);
+      }
+      NN_CONFIG_INT16 nn_config_int16;
+      av1_nn_quantize_config(&nn_config, &nn_config_int16, int16_buf.get());
+
+      av1_nn_predict_c(inputs, &nn_config, 0, outputs_ref);
+      av1_nn_predict_int16(inputs, &nn_config_int16, 0, outputs_test);
+
+      for (int node = 0; node < shape.num_outputs; node++) {
+        ASSERT_NEAR(outputs_ref[node], outputs_test[node],
+                    2e-3f * (input_scale + fabsf(outputs_ref[node])))
+            << "shape " << shape.num_inputs << "x" << shape.num_hidden_nodes[0]
+            << "x" << shape.num_outputs << " node " << node;
+      }
+    }
+  }
+}
+
+typedef void (*NnFcInt16_Func)(const int16_t *input, const int16_t *weights,
+                               int num_inputs, int num_outputs,
+                               int32_t *output);
+
+class NnFcInt16Test : public ::testing::TestWithParam<NnFcInt16_Func> {
+ protected:
+  virtual void SetUp() {
+    input_ = reinterpret_cast<int16_t *>(
+        aom_memalign(32, sizeof(input_[0]) * NN_INT16_MAX_INPUTS));
+    weights_ = reinterpret_cast<int16_t *>(aom_memalign(
+        32,
+        sizeof(weights_[0]) * NN_MAX_NODES_PER_LAYER * NN_INT16_MAX_INPUTS));
+    ASSERT_NE(input_, nullptr);
+    ASSERT_NE(weights_, nullptr);
+  }
+
+  virtual void TearDown() {
+    aom_free(input_);
+    aom_free(weights_);
+  }
+
+  void CheckOutput(int num_inputs, int num_outputs);
+
+  libaom_test::ACMRandom rng_;
+  int16_t *input_;
+  int16_t *weights_;
+};
+GTEST_ALLOW_UNINSTANTIATED_PARAMETERIZED_TEST(NnFcInt16Test);
+
+void NnFcInt16Test::CheckOutput(int num_inputs, int num_outputs) {
+  int32_t output_ref[NN_MAX_NODES_PER_LAYER];
+  int32_t output_test[NN_MAX_NODES_PER_LAYER];
+  av1_nn_fc_int16_c(input_, weights_, num_inputs, num_outputs, output_ref);
+  API_REGISTER_STATE_CHECK(
+      GetParam()(input_, weights_, num_inputs, num_outputs, output_test));
+  for (int node = 0; node < num_outputs; node++) {
+    ASSERT_EQ(output_ref[node], output_test[node])
+        << num_inputs << "x" << num_outputs << " node " << node;
+  }
+}
+
+TEST_P(NnFcInt16Test, RandomValues) {
+  const int max_input = 1 << NN_INT16_INPUT_BITS;
+  const int max_weight = 1 << NN_INT16_WEIGHT_BITS;
+  for (int iter = 0; iter < 100; ++iter) {
+    for (int num_inputs = NN_INT16_INPUT_ALIGN;
+         num_inputs <= NN_INT16_MAX_INPUTS; num_inputs += NN_INT16_INPUT_ALIGN) {
+      const int num_outputs = 1 + rng_(NN_MAX_NODES_PER_LAYER);
+      for (int i = 0; i < num_inputs; i++) {
+        input_[i] = (int16_t)(rng_(2 * max_input + 1) - max_input);
+      }
+      for (int i = 0; i < num_inputs * num_outputs; i++) {
+        weights_[i] = (int16_t)(rng_(2 * max_weight + 1) - max_weight);
+      }
+      ASSERT_NO_FATAL_FAILURE(CheckOutput(num_inputs, num_outputs));
+    }
+  }
+}
+
+TEST_P(NnFcInt16Test, ExtremeValues) {
+  const int max_input = 1 << NN_INT16_INPUT_BITS;
+  const int max_weight = 1 << NN_INT16_WEIGHT_BITS;
+  // The largest sums av1_nn_fc_int16() has to handle.
+  for (int sign = -1; sign <= 1; sign += 2) {
+    for (int i = 0; i < NN_INT16_MAX_INPUTS; i++) input_[i] = sign * max_input;
+    for (int i = 0; i < NN_MAX_NODES_PER_LAYER * NN_INT16_MAX_INPUTS; i++) {
+      weights_[i] = max_weight;
+    }
+    for (int num_outputs = 1; num_outputs <= 8; num_outputs++) {
+      ASSERT_NO_FATAL_FAILURE(CheckOutput(NN_INT16_MAX_INPUTS, num_outputs));
+    }
+  }
+}
+
+#if HAVE_AVX2
+INSTANTIATE_TEST_SUITE_P(AVX2, NnFcInt16Test,
+                         ::testing::Values(av1_nn_fc_int16_avx2));
+#endif
+
 }  // namespace
@@ -135,6 +135,54 @@ TEST_P(AverageTest, Random) {
   }
 }
 
+typedef void (*AvgQuadFunction)(const uint8_t *s, int pitch, int x16_idx,
+                                int y16_idx, int *avg);
+
+// Arguments: x16_idx, y16_idx, avg quad function.
+typedef std::tuple<int, int, AvgQuadFunction> AvgQuadFunc;
+
+class AverageQuadTest : public AverageTestBase<uint8_t>,
+                        public ::testing::WithParamInterface<AvgQuadFunc> {
+ public:
+  AverageQuadTest() : AverageTestBase(32, 32) {}
+
+ protected:
+  void CheckAverages() {
+    const int x16_idx = GET_PARAM(0);
+    const int y16_idx = GET_PARAM(1);
+    int expected[4];
+    for (int k = 0; k < 4; k++) {
+      const int x8_idx = x16_idx + ((k & 1) << 3);
+      const int y8_idx = y16_idx + ((k >> 1) << 3);
+      expected[k] = ReferenceAverage8x8(
+          source_data_ + y8_idx * source_stride_ + x8_idx, source_stride_);
+    }
+
+    int actual[4];
+    API_REGISTER_STATE_CHECK(GET_PARAM(2)(source_data_, source_stride_,
+                                          x16_idx, y16_idx, actual));
+
+    for (int k = 0; k < 4; k++) EXPECT_EQ(expected[k], actual[k]);
+  }
+};
+
+TEST_P(AverageQuadTest, MinValue) {
+  FillConstant(0);
+  CheckAverages();
+}
+
+TEST_P(AverageQuadTest, MaxValue) {
+  FillConstant(255);
+  CheckAverages();
+}
+
+TEST_P(AverageQuadTest, Random) {
+  for (int i = 0; i < 1000; i++) {
+    FillRandom();
+    CheckAverages();
+  }
+}
+
 typedef void (*IntProRowFunc)(int16_t hbuf[16], uint8_t const *ref,
                               const int ref_stride, const int height);
 
@@ -470,6 +518,11 @@ INSTANTIATE_TEST_SUITE_P(
     ::testing::Values(make_tuple(16, 16, 1, 8, &aom_avg_8x8_c),
                       make_tuple(16, 16, 1, 4, &aom_avg_4x4_c)));
 
+INSTANTIATE_TEST_SUITE_P(C, AverageQuadTest,
+                         ::testing::Values(make_tuple(0, 0, &aom_avg_8x8_quad_c),
+                                           make_tuple(16, 16,
+                                                      &aom_avg_8x8_quad_c)));
+
 #if HAVE_SSE2
 INSTANTIATE_TEST_SUITE_P(
     SSE2, AverageTest,
@@ -480,6 +533,12 @@ INSTANTIATE_TEST_SUITE_P(
                       make_tuple(16, 16, 5, 4, &aom_avg_4x4_sse2),
                       make_tuple(32, 32, 15, 4, &aom_avg_4x4_sse2)));
 
+INSTANTIATE_TEST_SUITE_P(
+    SSE2, AverageQuadTest,
+    ::testing::Values(make_tuple(0, 0, &aom_avg_8x8_quad_sse2),
+                      make_tuple(5, 3, &aom_avg_8x8_quad_sse2),
+                      make_tuple(16, 16, &aom_avg_8x8_quad_sse2)));
+
 INSTANTIATE_TEST_SUITE_P(
     SSE2, IntProRowTest,
     ::testing::Values(make_tuple(16, &aom_int_pro_row_sse2, &aom_int_pro_row_c),
@@ -497,6 +556,14 @@ INSTANTIATE_TEST_SUITE_P(
                                  &aom_int_pro_col_c)));
 #endif
 
+#if HAVE_AVX2
+INSTANTIATE_TEST_SUITE_P(
+    AVX2, AverageQuadTest,
+    ::testing::Values(make_tuple(0, 0, &aom_avg_8x8_quad_avx2),
+                      make_tuple(5, 3, &aom_avg_8x8_quad_avx2),
+                      make_tuple(16, 16, &aom_avg_8x8_quad_avx2)));
+#endif
+
 #if HAVE_NEON
 INSTANTIATE_TEST_SUITE_P(
     NEON, AverageTest,
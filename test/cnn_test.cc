@@ -12,6 +12,9 @@
 #include <assert.h>
 #include <math.h>
 #include <stdio.h>
+#include <string.h>
+
+#include <tuple>
 
 #include "third_party/googletest/src/googletest/include/gtest/gtest.h"
 
@@ -2651,4 +2654,106 @@ INSTANTIATE_TEST_SUITE_P(AVX2, CNNConvolveTest,
                              &av1_cnn_convolve_no_maxpool_padding_valid_avx2)));
 #endif
 
+typedef void (*CNNActivateFunc)(float **output, int channels, int width,
+                                int height, int stride,
+                                ACTIVATION layer_activation);
+typedef void (*CNNAddFunc)(float **output, int channels, int width, int height,
+                           int stride, const float **add);
+typedef void (*CNNBatchnormFunc)(float **image, int channels, int width,
+                                 int height, int stride, const float *gamma,
+                                 const float *beta, const float *mean,
+                                 const float *std);
+
+typedef std::tuple<CNNActivateFunc, CNNAddFunc, CNNBatchnormFunc>
+    CNNElementwiseFuncs;
+
+// The element-wise layer functions must match the C functions exactly.
+class CNNElementwiseTest
+    : public ::testing::TestWithParam<CNNElementwiseFuncs> {
+ protected:
+  static const int kChannels = 4;
+  static const int kMaxDim = 40;
+  static const int kBufSize = kChannels * kMaxDim * (kMaxDim + 3);
+
+  float RandomValue() {
+    switch (rng_(16)) {
+      case 0: return 0.0f;
+      case 1: return -0.0f;
+      case 2:
+        return ldexpf(static_cast<float>(rng_.Rand16()) - 32768.0f,
+                      static_cast<int>(rng_(120)) - 60);
+      default:
+        return (static_cast<float>(rng_.Rand31()) - (1 << 30)) / (1 << 27);
+    }
+  }
+
+  void RunTest(int op) {
+    for (int iter = 0; iter < 200; ++iter) {
+      const int width = 1 + rng_(kMaxDim);
+      const int height = 1 + rng_(kMaxDim);
+      const int stride = width + rng_(4);
+      float *ref[kChannels], *tst[kChannels];
+      const float *add[kChannels];
+      for (int c = 0; c < kChannels; ++c) {
+        ref[c] = ref_buf_ + c * stride * height;
+        tst[c] = tst_buf_ + c * stride * height;
+        add[c] = add_buf_ + c * stride * height;
+      }
+      for (int i = 0; i < kBufSize; ++i) {
+        ref_buf_[i] = tst_buf_[i] = RandomValue();
+        add_buf_[i] = RandomValue();
+      }
+      if (op == 0) {
+        av1_cnn_add_c(ref, kChannels, width, height, stride, add);
+        std::get<1>(GetParam())(tst, kChannels, width, height, stride, add);
+      } else if (op == 1) {
+        float gamma[kChannels], beta[kChannels], mean[kChannels],
+            std[kChannels];
+        for (int c = 0; c < kChannels; ++c) {
+          gamma[c] = RandomValue();
+          beta[c] = RandomValue();
+          mean[c] = RandomValue();
+          std[c] = fabsf(RandomValue()) + 0.5f;
+        }
+        av1_cnn_batchnorm_c(ref, kChannels, width, height, stride, gamma, beta,
+                            mean, std);
+        std::get<2>(GetParam())(tst, kChannels, width, height, stride, gamma,
+                                beta, mean, std);
+      } else {
+        const ACTIVATION activation = (op == 2) ? RELU : SOFTSIGN;
+        av1_cnn_activate_c(ref, kChannels, width, height, stride, activation);
+        std::get<0>(GetParam())(tst, kChannels, width, height, stride,
+                                activation);
+      }
+      for (int i = 0; i < kBufSize; ++i) {
+        ASSERT_EQ(memcmp(&ref_buf_[i], &tst_buf_[i], sizeof(ref_buf_[i])), 0)
+            << "op " << op << " " << width << "x" << height << " index " << i
+            << ": " << ref_buf_[i] << "/" << tst_buf_[i];
+      }
+    }
+  }
+
+ private:
+  libaom_test::ACMRandom rng_;
+  float ref_buf_[kBufSize];
+  float tst_buf_[kBufSize];
+  float add_buf_[kBufSize];
+};
+GTEST_ALLOW_UNINSTANTIATED_PARAMETERIZED_TEST(CNNElementwiseTest);
+
+TEST_P(CNNElementwiseTest, Add) { RunTest(0); }
+
+TEST_P(CNNElementwiseTest, Batchnorm) { RunTest(1); }
+
+TEST_P(CNNElementwiseTest, Relu) { RunTest(2); }
+
+TEST_P(CNNElementwiseTest, Softsign) { RunTest(3); }
+
+#if HAVE_AVX2
+INSTANTIATE_TEST_SUITE_P(AVX2, CNNElementwiseTest,
+                         ::testing::Values(CNNElementwiseFuncs(
+                             &av1_cnn_activate_avx2, &av1_cnn_add_avx2,
+                             &av1_cnn_batchnorm_avx2)));
+#endif
+
 }  // namespace
@@ -9,6 +9,8 @@
  * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
  */
 
+#include <cstring>
+
 #include "third_party/googletest/src/googletest/include/gtest/gtest.h"
 
 #include "config/aom_config.h"
@@ -54,4 +56,22 @@ TEST(DecodeAPI, InvalidControlId) {
   EXPECT_EQ(AOM_CODEC_OK, aom_codec_destroy(&dec));
 }
 
+TEST(DecodeAPI, ProfileControls) {
+  aom_codec_iface_t *iface = aom_codec_av1_dx();
+  aom_codec_ctx_t dec;
+  EXPECT_EQ(AOM_CODEC_OK, aom_codec_dec_init(&dec, iface, NULL, 0));
+  EXPECT_EQ(AOM_CODEC_INVALID_PARAM,
+            aom_codec_control(&dec, AV1D_GET_PROFILE_STATS,
+                              static_cast<aom_dec_profile_stats *>(NULL)));
+  aom_dec_profile_stats stats;
+  memset(&stats, 0xff, sizeof(stats));
+  EXPECT_EQ(AOM_CODEC_OK,
+            aom_codec_control(&dec, AV1D_GET_PROFILE_STATS, &stats));
+  EXPECT_EQ(0u, stats.frame_count);
+  EXPECT_EQ(0u, stats.frame_bytes);
+  EXPECT_EQ(AOM_CODEC_OK, aom_codec_control(&dec, AV1D_SET_PROFILING, 1u));
+  EXPECT_EQ(AOM_CODEC_OK, aom_codec_control(&dec, AV1D_SET_PROFILING, 0u));
+  EXPECT_EQ(AOM_CODEC_OK, aom_codec_destroy(&dec));
+}
+
 }  // namespace
@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) 2022, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#include <algorithm>
+
+#include "third_party/googletest/src/googletest/include/gtest/gtest.h"
+#include "aom/aomdx.h"
+#include "test/codec_factory.h"
+#include "test/video_source.h"
+#include "test/util.h"
+
+namespace {
+
+const int kNumFrames = 10;
+// Profiling is enabled after the first decoded frame and disabled after this
+// many more.
+const int kNumProfiledFrames = 6;
+
+class AV1DecoderProfileTest : public ::testing::Test,
+                              public ::libaom_test::EncoderTest {
+ protected:
+  AV1DecoderProfileTest()
+      : EncoderTest(&::libaom_test::kAV1), decoded_frames_(0),
+        profiled_bytes_(0) {}
+  virtual ~AV1DecoderProfileTest() {}
+
+  virtual void SetUp() {
+    InitializeConfig(::libaom_test::kRealTime);
+    cfg_.g_lag_in_frames = 0;
+  }
+
+  virtual void PreEncodeFrameHook(::libaom_test::VideoSource *video,
+                                  ::libaom_test::Encoder *encoder) {
+    if (video->frame() == 0) encoder->Control(AOME_SET_CPUUSED, 7);
+  }
+
+  virtual bool HandleDecodeResult(const aom_codec_err_t res_dec,
+                                  libaom_test::Decoder *decoder) {
+    EXPECT_EQ(AOM_CODEC_OK, res_dec) << decoder->DecodeError();
+    if (res_dec != AOM_CODEC_OK) return false;
+    ++decoded_frames_;
+
+    aom_dec_profile_stats stats;
+    decoder->Control(AV1D_GET_PROFILE_STATS, &stats);
+    const int profiled_frames =
+        std::min(decoded_frames_ - 1, kNumProfiledFrames);
+    EXPECT_EQ(static_cast<uint64_t>(profiled_frames), stats.frame_count);
+    if (decoded_frames_ > 1 && decoded_frames_ <= kNumProfiledFrames + 1) {
+      EXPECT_GT(stats.last_frame_bytes, 0u);
+      profiled_bytes_ += stats.last_frame_bytes;
+      for (int i = 0; i < AOM_DEC_PROFILE_STAGES; ++i) {
+        EXPECT_GE(stats.last_frame_stage_time[i], 0);
+        EXPECT_GE(stats.stage_time[i], stats.last_frame_stage_time[i]);
+      }
+    }
+    EXPECT_EQ(profiled_bytes_, stats.frame_bytes);
+
+    if (decoded_frames_ == 1) {
+      decoder->Control(AV1D_SET_PROFILING, 1);
+    } else if (decoded_frames_ == kNumProfiledFrames + 1) {
+      decoder->Control(AV1D_SET_PROFILING, 0);
+    }
+    return !::testing::Test::HasFailure();
+  }
+
+  int decoded_frames_;
+  uint64_t profiled_bytes_;
+};
+
+TEST_F(AV1DecoderProfileTest, CountsProfiledFrames) {
+  ::libaom_test::RandomVideoSource video;
+  video.SetSize(128, 96);
+  video.set_limit(kNumFrames);
+  ASSERT_NO_FATAL_FAILURE(RunLoop(&video));
+  EXPECT_EQ(kNumFrames, decoded_frames_);
+}
+
+}  // namespace
@@ -0,0 +1,151 @@
+/*
+ * Copyright (c) 2022, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "third_party/googletest/src/googletest/include/gtest/gtest.h"
+
+#include "config/aom_config.h"
+#include "config/av1_rtcd.h"
+
+#include "aom_ports/aom_timer.h"
+#include "av1/common/av1_common_int.h"
+#include "av1/common/txb_common.h"
+#include "test/acm_random.h"
+#include "test/register_state_check.h"
+#include "test/util.h"
+
+namespace {
+using libaom_test::ACMRandom;
+
+typedef void (*GetCoeffCtxs2dDiagFunc)(const uint8_t *levels, int bwl,
+                                       TX_SIZE tx_size, int diag,
+                                       int row_start, int num, int8_t *nz_ctx,
+                                       int8_t *br_ctx);
+
+class DecodeTxbTest : public ::testing::TestWithParam<GetCoeffCtxs2dDiagFunc> {
+ public:
+  DecodeTxbTest() : func_(GetParam()) {}
+
+  virtual ~DecodeTxbTest() {}
+
+  void CheckOutput() {
+    const int kNumTests = 50;
+    for (int tx_size = TX_4X4; tx_size < TX_SIZES_ALL; ++tx_size) {
+      const int bwl = get_txb_bwl((TX_SIZE)tx_size);
+      const int width = get_txb_wide((TX_SIZE)tx_size);
+      const int height = get_txb_high((TX_SIZE)tx_size);
+      uint8_t *const levels = set_levels(levels_buf_, width);
+      for (int i = 0; i < kNumTests; ++i) {
+        // Decoded levels never exceed MAX_BASE_BR_RANGE, but also check the
+        // clipping with larger values.
+        const int max_level = (i & 1) ? 255 : MAX_BASE_BR_RANGE;
+        InitLevels(levels, width, height, max_level);
+        for (int diag = 1; diag < width + height - 1; ++diag) {
+          const int row_start = AOMMAX(0, diag - width + 1);
+          const int num = AOMMIN(height - 1, diag) - row_start + 1;
+          memset(nz_ref_, 0, sizeof(nz_ref_));
+          memset(br_ref_, 0, sizeof(br_ref_));
+          memset(nz_, 0, sizeof(nz_));
+          memset(br_, 0, sizeof(br_));
+          av1_get_coeff_ctxs_2d_diag_c(levels, bwl, (TX_SIZE)tx_size, diag,
+                                       row_start, num, nz_ref_, br_ref_);
+          API_REGISTER_STATE_CHECK(func_(levels, bwl, (TX_SIZE)tx_size, diag,
+                                         row_start, num, nz_, br_));
+          for (int k = 0; k < num; ++k) {
+            ASSERT_EQ(nz_ref_[k], nz_[k])
+                << "nz ctx, tx_size " << tx_size << " diag " << diag
+                << " row " << row_start + k;
+            ASSERT_EQ(br_ref_[k], br_[k])
+                << "br ctx, tx_size " << tx_size << " diag " << diag
+                << " row " << row_start + k;
+          }
+        }
+      }
+    }
+  }
+
+  void SpeedTest() {
+    const int kNumTests = 100000;
+    for (int tx_size = TX_4X4; tx_size < TX_SIZES_ALL; ++tx_size) {
+      const int bwl = get_txb_bwl((TX_SIZE)tx_size);
+      const int width = get_txb_wide((TX_SIZE)tx_size);
+      const int height = get_txb_high((TX_SIZE)tx_size);
+      uint8_t *const levels = set_levels(levels_buf_, width);
+      InitLevels(levels, width, height, MAX_BASE_BR_RANGE);
+
+      aom_usec_timer timer_ref;
+      aom_usec_timer_start(&timer_ref);
+      for (int i = 0; i < kNumTests; ++i) {
+        for (int diag = 1; diag < width + height - 1; ++diag) {
+          const int row_start = AOMMAX(0, diag - width + 1);
+          const int num = AOMMIN(height - 1, diag) - row_start + 1;
+          av1_get_coeff_ctxs_2d_diag_c(levels, bwl, (TX_SIZE)tx_size, diag,
+                                       row_start, num, nz_ref_, br_ref_);
+        }
+      }
+      aom_usec_timer_mark(&timer_ref);
+
+      aom_usec_timer timer;
+      aom_usec_timer_start(&timer);
+      for (int i = 0; i < kNumTests; ++i) {
+        for (int diag = 1; diag < width + height - 1; ++diag) {
+          const int row_start = AOMMAX(0, diag - width + 1);
+          const int num = AOMMIN(height - 1, diag) - row_start + 1;
+          func_(levels, bwl, (TX_SIZE)tx_size, diag, row_start, num, nz_,
+                br_);
+        }
+      }
+      aom_usec_timer_mark(&timer);
+
+      const int elapsed_time_ref =
+          static_cast<int>(aom_usec_timer_elapsed(&timer_ref));
+      const int elapsed_time = static_cast<int>(aom_usec_timer_elapsed(&timer));
+      printf("coeff_ctxs_2d_diag_%2dx%2d: %7.1f ms ref %7.1f ms gain %4.2f\n",
+             tx_size_wide[tx_size], tx_size_high[tx_size],
+             elapsed_time / 1000.0, elapsed_time_ref / 1000.0,
+             (elapsed_time_ref * 1.0) / (elapsed_time * 1.0));
+    }
+  }
+
+ private:
+  void InitLevels(uint8_t *levels, int width, int height, int max_level) {
+    memset(levels_buf_, 0, sizeof(levels_buf_));
+    const int stride = width + TX_PAD_HOR;
+    for (int r = 0; r < height; ++r) {
+      for (int c = 0; c < width; ++c) {
+        levels[r * stride + c] =
+            static_cast<uint8_t>(rnd_.Rand8() % (max_level + 1));
+      }
+    }
+  }
+
+  GetCoeffCtxs2dDiagFunc func_;
+  ACMRandom rnd_;
+  uint8_t levels_buf_[TX_PAD_2D];
+  int8_t nz_ref_[32];
+  int8_t br_ref_[32];
+  int8_t nz_[32];
+  int8_t br_[32];
+};
+GTEST_ALLOW_UNINSTANTIATED_PARAMETERIZED_TEST(DecodeTxbTest);
+
+TEST_P(DecodeTxbTest, GetCoeffCtxs2dDiag) { CheckOutput(); }
+
+TEST_P(DecodeTxbTest, DISABLED_SpeedTestGetCoeffCtxs2dDiag) { SpeedTest(); }
+
+#if HAVE_AVX2
+INSTANTIATE_TEST_SUITE_P(AVX2, DecodeTxbTest,
+                         ::testing::Values(av1_get_coeff_ctxs_2d_diag_avx2));
+#endif
+}  // namespace
@@ -0,0 +1,145 @@
+/*
+ * Copyright (c) 2022, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#include <vector>
+
+#include "test/codec_factory.h"
+#include "test/encode_test_driver.h"
+#include "test/i420_video_source.h"
+#include "test/util.h"
+#include "av1/encoder/firstpass.h"
+
+namespace {
+
+const double kPsnrDiffThreshold = 0.5;
+// Relative tolerance of the intra prediction error.
+const double kIntraErrorTolerance = 0.15;
+// Relative tolerance of the coded error. The decimation filters out part of
+// the noise of the motion compensated residuals, so it is looser.
+const double kCodedErrorTolerance = 0.5;
+// Tolerance of the fraction of inter coded blocks.
+const double kPcntTolerance = 0.05;
+// Tolerance of the motion vector means, which are normalized to the frame
+// dimensions.
+const double kMvTolerance = 0.01;
+
+// Compares a two pass encode whose first pass runs on a 2x decimated source
+// against one whose first pass runs at full resolution.
+class FirstpassDownscaleTest : public ::libaom_test::CodecTestWithParam<int>,
+                               public ::libaom_test::EncoderTest {
+ protected:
+  FirstpassDownscaleTest()
+      : EncoderTest(GET_PARAM(0)), cpu_used_(GET_PARAM(1)),
+        firstpass_downscale_(0) {}
+  virtual ~FirstpassDownscaleTest() {}
+
+  virtual void SetUp() {
+    InitializeConfig(::libaom_test::kTwoPassGood);
+    const aom_rational timebase = { 1, 30 };
+    cfg_.g_timebase = timebase;
+    cfg_.rc_end_usage = AOM_VBR;
+    cfg_.rc_target_bitrate = 1000;
+    cfg_.g_lag_in_frames = 19;
+    cfg_.g_threads = 0;
+    init_flags_ = AOM_CODEC_USE_PSNR;
+  }
+
+  virtual void BeginPassHook(unsigned int pass) {
+    psnr_ = 0.0;
+    nframes_ = 0;
+    if (pass == 0) stats_.clear();
+  }
+
+  virtual void StatsPktHook(const aom_codec_cx_pkt_t *pkt) {
+    ASSERT_EQ(pkt->data.twopass_stats.sz, sizeof(FIRSTPASS_STATS));
+    const FIRSTPASS_STATS *const stats =
+        reinterpret_cast<const FIRSTPASS_STATS *>(pkt->data.twopass_stats.buf);
+    stats_.push_back(*stats);
+  }
+
+  virtual void PSNRPktHook(const aom_codec_cx_pkt_t *pkt) {
+    psnr_ += pkt->data.psnr.psnr[0];
+    nframes_++;
+  }
+
+  virtual void PreEncodeFrameHook(::libaom_test::VideoSource *video,
+                                  ::libaom_test::Encoder *encoder) {
+    if (video->frame() == 0) {
+      encoder->Control(AOME_SET_CPUUSED, cpu_used_);
+      encoder->Control(AV1E_SET_FIRSTPASS_DOWNSCALE, firstpass_downscale_);
+    }
+  }
+
+  double GetAveragePsnr() const {
+    if (nframes_) return psnr_ / nframes_;
+    return 0.0;
+  }
+
+  void DoTest() {
+    libaom_test::I420VideoSource video("niklas_640_480_30.yuv", 640, 480,
+                                       cfg_.g_timebase.den, cfg_.g_timebase.num,
+                                       0, 30);
+    firstpass_downscale_ = 0;
+    ASSERT_NO_FATAL_FAILURE(RunLoop(&video));
+    const double ref_psnr = GetAveragePsnr();
+    const std::vector<FIRSTPASS_STATS> ref_stats = stats_;
+
+    firstpass_downscale_ = 1;
+    ASSERT_NO_FATAL_FAILURE(RunLoop(&video));
+    EXPECT_LT(fabs(ref_psnr - GetAveragePsnr()), kPsnrDiffThreshold)
+        << "cpu used = " << cpu_used_;
+    CompareStats(ref_stats, stats_);
+  }
+
+  // The stats of the downscaled first pass are normalized to the full
+  // resolution, so they have to follow the full resolution ones. The last
+  // packet holds the totals of the sequence.
+  void CompareStats(const std::vector<FIRSTPASS_STATS> &ref_stats,
+                    const std::vector<FIRSTPASS_STATS> &stats) {
+    ASSERT_EQ(ref_stats.size(), stats.size());
+    ASSERT_FALSE(stats.empty());
+    for (size_t i = 0; i < stats.size(); ++i) {
+      const FIRSTPASS_STATS &ref = ref_stats[i];
+      const FIRSTPASS_STATS &test = stats[i];
+      EXPECT_EQ(ref.frame, test.frame) << "packet " << i;
+      EXPECT_EQ(ref.count, test.count) << "packet " << i;
+      EXPECT_NEAR(ref.intra_error, test.intra_error,
+                  kIntraErrorTolerance * ref.intra_error)
+          << "packet " << i;
+      EXPECT_NEAR(ref.coded_error, test.coded_error,
+                  kCodedErrorTolerance * ref.coded_error)
+          << "packet " << i;
+      EXPECT_NEAR(ref.pcnt_inter, test.pcnt_inter,
+                  kPcntTolerance * ref.count)
+          << "packet " << i;
+      EXPECT_NEAR(ref.mvr_abs, test.mvr_abs, kMvTolerance * ref.count)
+          << "packet " << i;
+      EXPECT_NEAR(ref.mvc_abs, test.mvc_abs, kMvTolerance * ref.count)
+          << "packet " << i;
+      EXPECT_NEAR(ref.MVr, test.MVr, kMvTolerance * ref.count)
+          << "packet " << i;
+      EXPECT_NEAR(ref.MVc, test.MVc, kMvTolerance * ref.count)
+          << "packet " << i;
+    }
+  }
+
+  int cpu_used_;
+  unsigned int firstpass_downscale_;
+  unsigned int nframes_;
+  double psnr_;
+  std::vector<FIRSTPASS_STATS> stats_;
+};
+
+TEST_P(FirstpassDownscaleTest, CompareToFullResolution) { DoTest(); }
+
+AV1_INSTANTIATE_TEST_SUITE(FirstpassDownscaleTest,
+                           ::testing::Values(4, 6));  // cpu_used
+}  // namespace
@@ -0,0 +1,139 @@
+/*
+ * Copyright (c) 2022, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#include <vector>
+
+#include "test/codec_factory.h"
+#include "test/encode_test_driver.h"
+#include "test/i420_video_source.h"
+#include "test/util.h"
+#include "test/video_source.h"
+
+namespace {
+
+const double kPsnrDiffThreshold = 0.5;
+const int kFastestSpeed = 10;
+// A budget no frame can be encoded in, and one every frame fits in.
+const unsigned int kTightBudget = 1;
+const unsigned int kLooseBudget = 1000000000;
+
+// Encodes with a per-frame time budget that can never be met, so the speed
+// is raised up to the fastest level. Checks the speed of each frame, and the
+// quality against an encode at the fastest level.
+class FrameTimeBudgetTest : public ::libaom_test::CodecTestWithParam<int>,
+                            public ::libaom_test::EncoderTest {
+ protected:
+  FrameTimeBudgetTest()
+      : EncoderTest(GET_PARAM(0)), cpu_used_(GET_PARAM(1)),
+        frame_time_budget_(0), loose_budget_frame_(-1), frame_speed_(-1) {}
+  virtual ~FrameTimeBudgetTest() {}
+
+  virtual void SetUp() {
+    InitializeConfig(::libaom_test::kRealTime);
+    const aom_rational timebase = { 1, 30 };
+    cfg_.g_timebase = timebase;
+    cfg_.rc_end_usage = AOM_CBR;
+    cfg_.rc_target_bitrate = 1000;
+    cfg_.g_lag_in_frames = 0;
+    cfg_.g_threads = 0;
+    init_flags_ = AOM_CODEC_USE_PSNR;
+  }
+
+  virtual void BeginPassHook(unsigned int) {
+    psnr_ = 0.0;
+    nframes_ = 0;
+    frame_speeds_.clear();
+  }
+
+  virtual void PSNRPktHook(const aom_codec_cx_pkt_t *pkt) {
+    psnr_ += pkt->data.psnr.psnr[0];
+    nframes_++;
+  }
+
+  virtual void PreEncodeFrameHook(::libaom_test::VideoSource *video,
+                                  ::libaom_test::Encoder *encoder) {
+    if (video->frame() == 0) {
+      encoder->Control(AOME_SET_CPUUSED, cpu_used_);
+      encoder->Control(AV1E_SET_FRAME_TIME_BUDGET, frame_time_budget_);
+    } else if (static_cast<int>(video->frame()) == loose_budget_frame_) {
+      encoder->Control(AV1E_SET_FRAME_TIME_BUDGET, kLooseBudget);
+    }
+  }
+
+  virtual void PostEncodeFrameHook(::libaom_test::Encoder *encoder) {
+    encoder->Control(AV1E_GET_FRAME_SPEED, &frame_speed_);
+  }
+
+  // Called after PostEncodeFrameHook() for the packet of each frame.
+  virtual void FramePktHook(const aom_codec_cx_pkt_t *) {
+    frame_speeds_.push_back(frame_speed_);
+  }
+
+  double GetAveragePsnr() const {
+    if (nframes_) return psnr_ / nframes_;
+    return 0.0;
+  }
+
+  void DoTest() {
+    libaom_test::I420VideoSource video("niklas_640_480_30.yuv", 640, 480,
+                                       cfg_.g_timebase.den, cfg_.g_timebase.num,
+                                       0, 30);
+    const int cpu_used = cpu_used_;
+    cpu_used_ = 10;
+    frame_time_budget_ = 0;
+    ASSERT_NO_FATAL_FAILURE(RunLoop(&video));
+    const double ref_psnr = GetAveragePsnr();
+
+    cpu_used_ = cpu_used;
+    frame_time_budget_ = kTightBudget;
+    ASSERT_NO_FATAL_FAILURE(RunLoop(&video));
+    EXPECT_GT(GetAveragePsnr(), ref_psnr - kPsnrDiffThreshold)
+        << "cpu used = " << cpu_used_;
+  }
+
+  // Starts with a budget that cannot be met, then lifts it. The speed must
+  // rise to the fastest level and come back down to cpu_used_.
+  void DoSpeedTest() {
+    const int kNumTightFrames = 8;
+    const int kNumFrames = 50;
+    ::libaom_test::DummyVideoSource video;
+    video.SetSize(352, 288);
+    video.set_limit(kNumFrames);
+    frame_time_budget_ = kTightBudget;
+    loose_budget_frame_ = kNumTightFrames;
+    ASSERT_NO_FATAL_FAILURE(RunLoop(&video));
+    ASSERT_EQ(frame_speeds_.size(), static_cast<size_t>(kNumFrames));
+    // The key frame is encoded before any time is measured.
+    EXPECT_EQ(frame_speeds_[0], cpu_used_);
+    EXPECT_EQ(frame_speeds_[kNumTightFrames - 1], kFastestSpeed);
+    for (int i = 1; i < kNumFrames; ++i) {
+      EXPECT_LE(frame_speeds_[i], kFastestSpeed) << "frame " << i;
+      EXPECT_GE(frame_speeds_[i], cpu_used_) << "frame " << i;
+    }
+    EXPECT_EQ(frame_speeds_.back(), cpu_used_);
+  }
+
+  int cpu_used_;
+  unsigned int frame_time_budget_;
+  int loose_budget_frame_;
+  int frame_speed_;
+  std::vector<int> frame_speeds_;
+  unsigned int nframes_;
+  double psnr_;
+};
+
+TEST_P(FrameTimeBudgetTest, CompareToFastestSpeed) { DoTest(); }
+
+TEST_P(FrameTimeBudgetTest, SpeedFollowsBudget) { DoSpeedTest(); }
+
+AV1_INSTANTIATE_TEST_SUITE(FrameTimeBudgetTest,
+                           ::testing::Values(7, 8));  // cpu_used
+}  // namespace
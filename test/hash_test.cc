@@ -17,7 +17,10 @@
 #include "config/av1_rtcd.h"
 
 #include "aom_ports/aom_timer.h"
+#include "aom_mem/aom_mem.h"
+#include "aom_scale/yv12config.h"
 #include "av1/encoder/hash.h"
+#include "av1/encoder/hash_motion.h"
 #include "test/acm_random.h"
 #include "test/util.h"
 #include "third_party/googletest/src/googletest/include/gtest/gtest.h"
@@ -131,4 +134,152 @@ INSTANTIATE_TEST_SUITE_P(
                        ::testing::ValuesIn(kValidBlockSize)));
 #endif
 
+typedef void (*hash_block_2x2_row_func)(void *crc_calculator,
+                                        const uint8_t *src, int stride,
+                                        int width, uint32_t *hash1,
+                                        uint32_t *hash2, int8_t *row_same,
+                                        int8_t *col_same);
+typedef void (*hash_block_quad_row_func)(void *crc_calculator,
+                                         const uint32_t *src1,
+                                         const uint32_t *src2, int src_size,
+                                         int stride, int width, uint32_t *dst1,
+                                         uint32_t *dst2);
+typedef std::tuple<hash_block_2x2_row_func, hash_block_quad_row_func>
+    BlockHashRowParam;
+
+class AV1BlockHashRowTest : public ::testing::TestWithParam<BlockHashRowParam> {
+ protected:
+  static const int kStride = 160;
+  static const int kRows = 33;
+};
+GTEST_ALLOW_UNINSTANTIATED_PARAMETERIZED_TEST(AV1BlockHashRowTest);
+
+TEST_P(AV1BlockHashRowTest, CheckOutput) {
+  libaom_test::ACMRandom rnd(libaom_test::ACMRandom::DeterministicSeed());
+  CRC32C calc;
+  av1_crc32c_calculator_init(&calc);
+  uint8_t src[2 * kStride];
+  uint32_t hash_src[2][kRows * kStride];
+  uint32_t ref[2][kStride], out[2][kStride];
+  int8_t ref_same[2][kStride], out_same[2][kStride];
+  for (int i = 0; i < 100; ++i) {
+    // Few distinct values, so that some blocks have the same rows or columns.
+    const int mask = (i & 1) ? 0x03 : 0xff;
+    for (int j = 0; j < 2 * kStride; ++j) src[j] = rnd.Rand8() & mask;
+    const int width = 1 + rnd(kStride - 1);
+    av1_hash_block_2x2_row_c(&calc, src, kStride, width, ref[0], ref[1],
+                             ref_same[0], ref_same[1]);
+    GET_PARAM(0)(&calc, src, kStride, width, out[0], out[1], out_same[0],
+                 out_same[1]);
+    for (int j = 0; j < width; ++j) {
+      ASSERT_EQ(ref[0][j], out[0][j]) << "2x2 block " << j;
+      ASSERT_EQ(ref[1][j], out[1][j]) << "2x2 block " << j;
+      ASSERT_EQ(ref_same[0][j], out_same[0][j]) << "2x2 block " << j;
+      ASSERT_EQ(ref_same[1][j], out_same[1][j]) << "2x2 block " << j;
+    }
+
+    for (int k = 0; k < 2; ++k) {
+      for (int j = 0; j < kRows * kStride; ++j) hash_src[k][j] = rnd.Rand31();
+    }
+    const int src_size = 1 << rnd(5);
+    const int quad_width = 1 + rnd(kStride - 2 * src_size);
+    av1_hash_block_quad_row_c(&calc, hash_src[0], hash_src[1], src_size,
+                              kStride, quad_width, ref[0], ref[1]);
+    GET_PARAM(1)(&calc, hash_src[0], hash_src[1], src_size, kStride,
+                 quad_width, out[0], out[1]);
+    for (int j = 0; j < quad_width; ++j) {
+      ASSERT_EQ(ref[0][j], out[0][j]) << "quad block " << j;
+      ASSERT_EQ(ref[1][j], out[1][j]) << "quad block " << j;
+    }
+  }
+}
+
+#if HAVE_SSE4_2
+INSTANTIATE_TEST_SUITE_P(
+    SSE4_2, AV1BlockHashRowTest,
+    ::testing::Values(std::make_tuple(&av1_hash_block_2x2_row_sse4_2,
+                                      &av1_hash_block_quad_row_sse4_2)));
+#endif
+
+// Checks that the reference frame hash index updated for the changed rows only
+// matches one built from scratch, and that it finds a moved block.
+TEST(RefFrameHashIndexTest, IncrementalMatchesFull) {
+  const int kWidth = 96;
+  const int kHeight = 80;
+  libaom_test::ACMRandom rnd(libaom_test::ACMRandom::DeterministicSeed());
+  YV12_BUFFER_CONFIG frame;
+  memset(&frame, 0, sizeof(frame));
+  ASSERT_EQ(aom_alloc_frame_buffer(&frame, kWidth, kHeight, 1, 1, 0, 32, 0), 0);
+  for (int r = 0; r < kHeight; ++r) {
+    for (int c = 0; c < kWidth; ++c) {
+      frame.y_buffer[r * frame.y_stride + c] = rnd.Rand8() & 0xf0;
+    }
+  }
+
+  IntraBCHashInfo hash_info;
+  memset(&hash_info, 0, sizeof(hash_info));
+  for (int x = 0; x < 2; ++x) {
+    for (int y = 0; y < 2; ++y) {
+      hash_info.hash_value_buffer[x][y] = static_cast<uint32_t *>(aom_malloc(
+          AOM_BUFFER_SIZE_FOR_BLOCK_HASH * sizeof(uint32_t)));
+    }
+  }
+  SrcBlockHashCache cache;
+  memset(&cache, 0, sizeof(cache));
+  RefFrameHashIndex index;
+  memset(&index, 0, sizeof(index));
+  ASSERT_TRUE(
+      av1_build_ref_frame_hash_index(&hash_info, &cache, &frame, &index));
+
+  // Change a few rows, and copy a block to a new position.
+  for (int r = 21; r < 27; ++r) {
+    for (int c = 0; c < kWidth; ++c) {
+      frame.y_buffer[r * frame.y_stride + c] = rnd.Rand8() & 0xf0;
+    }
+  }
+  const int src_x = 13, src_y = 3, dst_x = 50, dst_y = 61;
+  for (int r = 0; r < 16; ++r) {
+    memcpy(frame.y_buffer + (dst_y + r) * frame.y_stride + dst_x,
+           frame.y_buffer + (src_y + r) * frame.y_stride + src_x, 16);
+  }
+  ASSERT_TRUE(
+      av1_build_ref_frame_hash_index(&hash_info, &cache, &frame, &index));
+
+  SrcBlockHashCache full_cache;
+  memset(&full_cache, 0, sizeof(full_cache));
+  RefFrameHashIndex full_index;
+  memset(&full_index, 0, sizeof(full_index));
+  ASSERT_TRUE(av1_build_ref_frame_hash_index(&hash_info, &full_cache, &frame,
+                                             &full_index));
+  ASSERT_EQ(index.num_blocks, full_index.num_blocks);
+  for (int i = 0; i < index.num_blocks; ++i) {
+    ASSERT_EQ(index.blocks[i].x, full_index.blocks[i].x);
+    ASSERT_EQ(index.blocks[i].y, full_index.blocks[i].y);
+    ASSERT_EQ(index.blocks[i].hash_value2, full_index.blocks[i].hash_value2);
+  }
+
+  uint32_t hash_value1, hash_value2;
+  av1_get_block_hash_value(
+      &hash_info, frame.y_buffer + dst_y * frame.y_stride + dst_x,
+      frame.y_stride, REF_FRAME_HASH_BLOCK_SIZE, &hash_value1, &hash_value2, 0);
+  int count;
+  const block_hash *blocks =
+      av1_ref_frame_hash_lookup(&index, hash_value1, &count);
+  int found = 0;
+  for (int i = 0; i < count; ++i) {
+    found |= blocks[i].x == src_x && blocks[i].y == src_y &&
+             blocks[i].hash_value2 == hash_value2;
+  }
+  EXPECT_TRUE(found);
+
+  av1_free_ref_frame_hash_index(&index);
+  av1_free_ref_frame_hash_index(&full_index);
+  av1_free_src_block_hash_cache(&cache);
+  av1_free_src_block_hash_cache(&full_cache);
+  for (int x = 0; x < 2; ++x) {
+    for (int y = 0; y < 2; ++y) aom_free(hash_info.hash_value_buffer[x][y]);
+  }
+  aom_free_frame_buffer(&frame);
+}
+
 }  // namespace
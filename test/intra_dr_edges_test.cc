@@ -0,0 +1,156 @@
+/*
+ * Copyright (c) 2022, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#include <string.h>
+
+#include <memory>
+
+#include "third_party/googletest/src/googletest/include/gtest/gtest.h"
+
+#include "config/aom_config.h"
+
+#include "aom_scale/yv12config.h"
+#include "av1/common/blockd.h"
+#include "av1/common/reconintra.h"
+#include "test/acm_random.h"
+
+namespace {
+
+using libaom_test::ACMRandom;
+
+const TX_SIZE kTxSizes[] = { TX_4X4,  TX_8X8,   TX_16X16, TX_32X32, TX_4X8,
+                             TX_8X4,  TX_8X16,  TX_16X8,  TX_16X32, TX_32X16,
+                             TX_4X16, TX_16X4,  TX_8X32,  TX_32X8 };
+
+// The blocks are placed in the superblock starting at (kSbMi, kSbMi) of a
+// frame of kFrameMi x kFrameMi mode info units.
+const int kFrameMi = 64;
+const int kSbMi = 16;
+const int kStride = kFrameMi * MI_SIZE;
+
+// Checks that the directional predictions built by
+// av1_predict_intra_dr_from_edges() from the edges gathered once are the same
+// as the ones of av1_predict_intra_block(), for every angle.
+class IntraDrEdgesTest : public ::testing::TestWithParam<TX_SIZE> {
+ protected:
+  IntraDrEdgesTest()
+      : rng_(ACMRandom::DeterministicSeed()),
+        frame_(new uint8_t[kStride * kStride]), xd_(new MACROBLOCKD) {}
+
+  virtual void SetUp() {
+    av1_init_intra_predictors();
+    for (int i = 0; i < kStride * kStride; ++i) frame_[i] = rng_.Rand8();
+    memset(xd_.get(), 0, sizeof(*xd_));
+    memset(&cur_buf_, 0, sizeof(cur_buf_));
+    memset(&mbmi_, 0, sizeof(mbmi_));
+    memset(&smooth_mbmi_, 0, sizeof(smooth_mbmi_));
+    mbmi_ptr_ = &mbmi_;
+    xd_->mi = &mbmi_ptr_;
+    xd_->cur_buf = &cur_buf_;
+    smooth_mbmi_.mode = SMOOTH_PRED;
+  }
+
+  // Places the block at (mi_row, mi_col) of a frame of mi_rows x mi_cols mode
+  // info units.
+  void SetupBlock(BLOCK_SIZE bsize, int mi_row, int mi_col, int mi_rows,
+                  int mi_cols, int up_available, int left_available,
+                  int smooth_neighbor) {
+    const int bh = mi_size_high[bsize];
+    const int bw = mi_size_wide[bsize];
+    mbmi_.bsize = bsize;
+    mbmi_.partition = PARTITION_NONE;
+    xd_->up_available = up_available;
+    xd_->left_available = left_available;
+    xd_->above_mbmi = up_available && smooth_neighbor ? &smooth_mbmi_ : NULL;
+    xd_->left_mbmi = left_available && smooth_neighbor ? &smooth_mbmi_ : NULL;
+    xd_->mb_to_top_edge = -GET_MV_SUBPEL(mi_row * MI_SIZE);
+    xd_->mb_to_bottom_edge = GET_MV_SUBPEL((mi_rows - bh - mi_row) * MI_SIZE);
+    xd_->mb_to_left_edge = -GET_MV_SUBPEL(mi_col * MI_SIZE);
+    xd_->mb_to_right_edge = GET_MV_SUBPEL((mi_cols - bw - mi_col) * MI_SIZE);
+    xd_->tile.mi_row_start = 0;
+    xd_->tile.mi_col_start = 0;
+    xd_->tile.mi_row_end = mi_rows;
+    xd_->tile.mi_col_end = mi_cols;
+  }
+
+  void CheckAllAngles(TX_SIZE tx_size, int mi_row, int mi_col,
+                      int enable_intra_edge_filter) {
+    const int txw = tx_size_wide[tx_size];
+    const int txh = tx_size_high[tx_size];
+    const uint8_t *const ref =
+        &frame_[mi_row * MI_SIZE * kStride + mi_col * MI_SIZE];
+    IntraDrEdges edges;
+    av1_prepare_intra_dr_edges(xd_.get(), BLOCK_64X64, enable_intra_edge_filter,
+                               txw, txh, tx_size, ref, kStride, 0, 0, 0,
+                               &edges);
+    uint8_t pred_ref[32 * 32];
+    uint8_t pred[32 * 32];
+    for (int mode = V_PRED; mode <= D67_PRED; ++mode) {
+      for (int delta = -MAX_ANGLE_DELTA; delta <= MAX_ANGLE_DELTA; ++delta) {
+        const int p_angle = mode_to_angle_map[mode] + delta * ANGLE_STEP;
+        av1_predict_intra_block(
+            xd_.get(), BLOCK_64X64, enable_intra_edge_filter, txw, txh, tx_size,
+            (PREDICTION_MODE)mode, delta * ANGLE_STEP, 0, FILTER_INTRA_MODES,
+            ref, kStride, pred_ref, 32, 0, 0, 0);
+        av1_predict_intra_dr_from_edges(&edges, p_angle, pred, 32);
+        for (int r = 0; r < txh; ++r) {
+          for (int c = 0; c < txw; ++c) {
+            ASSERT_EQ(pred_ref[r * 32 + c], pred[r * 32 + c])
+                << "angle " << p_angle << " at " << r << "x" << c
+                << " block at mi " << mi_row << "x" << mi_col << " up "
+                << xd_->up_available << " left " << xd_->left_available
+                << " edge filter " << enable_intra_edge_filter;
+          }
+        }
+      }
+    }
+  }
+
+  ACMRandom rng_;
+  std::unique_ptr<uint8_t[]> frame_;
+  std::unique_ptr<MACROBLOCKD> xd_;
+  YV12_BUFFER_CONFIG cur_buf_;
+  MB_MODE_INFO mbmi_;
+  MB_MODE_INFO smooth_mbmi_;
+  MB_MODE_INFO *mbmi_ptr_;
+};
+
+TEST_P(IntraDrEdgesTest, MatchesPredictIntraBlock) {
+  const TX_SIZE tx_size = GetParam();
+  const BLOCK_SIZE bsize = txsize_to_bsize[tx_size];
+  const int bh = mi_size_high[bsize];
+  const int bw = mi_size_wide[bsize];
+  // Every position in the superblock gives the different top-right and
+  // bottom-left availabilities. The second frame size ends in the middle of
+  // the block, which cuts its top and left edges.
+  for (int mi_row = kSbMi; mi_row < 2 * kSbMi; mi_row += bh) {
+    for (int mi_col = kSbMi; mi_col < 2 * kSbMi; mi_col += bw) {
+      for (int clip = 0; clip < 2; ++clip) {
+        const int mi_rows = clip ? mi_row + (bh + 1) / 2 : kFrameMi;
+        const int mi_cols = clip ? mi_col + (bw + 1) / 2 : kFrameMi;
+        for (int avail = 0; avail < 4; ++avail) {
+          for (int smooth = 0; smooth < 2; ++smooth) {
+            SetupBlock(bsize, mi_row, mi_col, mi_rows, mi_cols, avail & 1,
+                       avail >> 1, smooth);
+            for (int filter = 0; filter < 2; ++filter) {
+              CheckAllAngles(tx_size, mi_row, mi_col, filter);
+              if (HasFatalFailure()) return;
+            }
+          }
+        }
+      }
+    }
+  }
+}
+
+INSTANTIATE_TEST_SUITE_P(C, IntraDrEdgesTest, ::testing::ValuesIn(kTxSizes));
+
+}  // namespace
@@ -13,6 +13,7 @@
 
 #include <memory>
 
+#include "test/acm_random.h"
 #include "test/codec_factory.h"
 #include "test/encode_test_driver.h"
 #include "test/util.h"
@@ -272,4 +273,168 @@ TEST_P(RcInterfaceTest, Svc) { RunSvc(); }
 
 AV1_INSTANTIATE_TEST_SUITE(RcInterfaceTest, ::testing::Values(0, 3));
 
+aom::AV1RateControlRtcConfig BatchStreamConfig(int index) {
+  aom::AV1RateControlRtcConfig rc_cfg;
+  rc_cfg.width = 640 + 32 * index;
+  rc_cfg.height = 360 + 16 * index;
+  rc_cfg.max_quantizer = 52;
+  rc_cfg.min_quantizer = 2;
+  rc_cfg.target_bandwidth = 300 + 200 * index;
+  rc_cfg.max_intra_bitrate_pct = 1000;
+  rc_cfg.aq_mode = (index & 1) ? 3 : 0;
+  rc_cfg.ss_number_layers = 1;
+  rc_cfg.ts_number_layers = 1;
+  rc_cfg.layer_target_bitrate[0] = static_cast<int>(rc_cfg.target_bandwidth);
+  rc_cfg.max_quantizers[0] = 52;
+  rc_cfg.min_quantizers[0] = 2;
+  if (index % 3 == 2) {
+    rc_cfg.ss_number_layers = 3;
+    rc_cfg.ts_number_layers = 3;
+    for (int sl = 0; sl < 3; ++sl) {
+      rc_cfg.scaling_factor_num[sl] = 1 << sl;
+      rc_cfg.scaling_factor_den[sl] = 4;
+      rc_cfg.ts_rate_decimator[sl] = 4 >> sl;
+      for (int tl = 0; tl < 3; ++tl) {
+        const int i = sl * 3 + tl;
+        rc_cfg.layer_target_bitrate[i] = 100 * (sl + 1) + 40 * tl;
+        rc_cfg.max_quantizers[i] = 56;
+        rc_cfg.min_quantizers[i] = 2;
+      }
+    }
+  }
+  return rc_cfg;
+}
+
+// Runs interleaved streams with different configs through one batch and
+// checks the QPs against one AV1RateControlRTC per stream.
+TEST(RcInterfaceBatchTest, MatchesSingleStream) {
+  constexpr int kNumStreams = 6;
+  constexpr int kNumBatchFrames = 120;
+  std::unique_ptr<aom::AV1RateControlRTCBatch> batch =
+      aom::AV1RateControlRTCBatch::Create();
+  ASSERT_NE(batch, nullptr);
+  std::unique_ptr<aom::AV1RateControlRTC> single[kNumStreams];
+  int ids[kNumStreams];
+  for (int i = 0; i < kNumStreams; ++i) {
+    const aom::AV1RateControlRtcConfig rc_cfg = BatchStreamConfig(i);
+    single[i] = aom::AV1RateControlRTC::Create(rc_cfg);
+    ASSERT_NE(single[i], nullptr);
+    ids[i] = batch->AddStream(rc_cfg);
+    ASSERT_EQ(ids[i], i);
+  }
+
+  libaom_test::ACMRandom rnd(libaom_test::ACMRandom::DeterministicSeed());
+  int layer_frame[kNumStreams] = { 0 };
+  for (int n = 0; n < kNumBatchFrames; ++n) {
+    if (n == kNumBatchFrames / 2) {
+      // Change the bitrate of one stream midway.
+      aom::AV1RateControlRtcConfig rc_cfg = BatchStreamConfig(1);
+      rc_cfg.target_bandwidth = 2000;
+      rc_cfg.layer_target_bitrate[0] = 2000;
+      single[1]->UpdateRateControl(rc_cfg);
+      batch->UpdateRateControl(ids[1], rc_cfg);
+    }
+    // A varying subset of the streams, in a varying order.
+    int stream_ids[kNumStreams];
+    aom::FRAME_TYPE frame_types[kNumStreams];
+    int spatial_layer_ids[kNumStreams];
+    int temporal_layer_ids[kNumStreams];
+    int qps[kNumStreams];
+    uint64_t frame_sizes[kNumStreams];
+    int num = 0;
+    for (int k = 0; k < kNumStreams; ++k) {
+      const int i = (k + n) % kNumStreams;
+      if (i == n % 4) continue;
+      const aom::AV1RateControlRtcConfig rc_cfg = BatchStreamConfig(i);
+      const int frame = layer_frame[i]++;
+      const int superframe = frame / rc_cfg.ss_number_layers;
+      stream_ids[num] = ids[i];
+      frame_types[num] = frame == 0 ? KEY_FRAME : INTER_FRAME;
+      spatial_layer_ids[num] = frame % rc_cfg.ss_number_layers;
+      temporal_layer_ids[num] =
+          rc_cfg.ts_number_layers > 1 ? kTemporalId[superframe % 4] : 0;
+      aom::AV1FrameParamsRTC frame_params;
+      frame_params.frame_type = frame_types[num];
+      frame_params.spatial_layer_id = spatial_layer_ids[num];
+      frame_params.temporal_layer_id = temporal_layer_ids[num];
+      single[i]->ComputeQP(frame_params);
+      frame_sizes[num] = 500 + rnd.Rand16() % 8000;
+      ++num;
+    }
+    aom::AV1RateControlRtcBatchFrames frames;
+    frames.num_streams = num;
+    frames.stream_ids = stream_ids;
+    frames.frame_types = frame_types;
+    frames.spatial_layer_ids = spatial_layer_ids;
+    frames.temporal_layer_ids = temporal_layer_ids;
+    frames.qps = qps;
+    frames.encoded_frame_sizes = frame_sizes;
+    ASSERT_TRUE(batch->ComputeQP(frames));
+    for (int j = 0; j < num; ++j) {
+      const int i = stream_ids[j];
+      ASSERT_EQ(qps[j], single[i]->GetQP()) << "stream " << i << " frame " << n;
+      if (BatchStreamConfig(i).aq_mode) {
+        for (int seg = 0; seg < 3; ++seg) {
+          ASSERT_EQ(batch->GetDeltaQ(i)[seg], single[i]->GetDeltaQ()[seg]);
+        }
+      }
+      single[i]->PostEncodeUpdate(frame_sizes[j]);
+    }
+    ASSERT_TRUE(batch->PostEncodeUpdate(frames));
+  }
+}
+
+TEST(RcInterfaceBatchTest, InvalidStreams) {
+  std::unique_ptr<aom::AV1RateControlRTCBatch> batch =
+      aom::AV1RateControlRTCBatch::Create();
+  ASSERT_NE(batch, nullptr);
+  // Streams 0 and 1 use aq-mode 0 and 3.
+  const int ids[2] = { batch->AddStream(BatchStreamConfig(0)),
+                       batch->AddStream(BatchStreamConfig(1)) };
+  ASSERT_EQ(ids[0], 0);
+  ASSERT_EQ(ids[1], 1);
+  EXPECT_EQ(batch->GetCyclicRefreshMap(ids[0]), nullptr);
+  EXPECT_EQ(batch->GetDeltaQ(ids[0]), nullptr);
+  EXPECT_NE(batch->GetCyclicRefreshMap(ids[1]), nullptr);
+  EXPECT_NE(batch->GetDeltaQ(ids[1]), nullptr);
+
+  for (const int id : { -1, 2 }) {
+    EXPECT_FALSE(batch->UpdateRateControl(id, BatchStreamConfig(0)));
+    EXPECT_EQ(batch->GetCyclicRefreshMap(id), nullptr);
+    EXPECT_EQ(batch->GetDeltaQ(id), nullptr);
+    EXPECT_FALSE(batch->RemoveStream(id));
+  }
+  ASSERT_TRUE(batch->RemoveStream(ids[1]));
+  EXPECT_FALSE(batch->RemoveStream(ids[1]));
+  EXPECT_FALSE(batch->UpdateRateControl(ids[1], BatchStreamConfig(1)));
+  EXPECT_EQ(batch->GetCyclicRefreshMap(ids[1]), nullptr);
+  EXPECT_EQ(batch->GetDeltaQ(ids[1]), nullptr);
+
+  // A removed stream in the frames fails the call before any stream is
+  // updated.
+  const aom::FRAME_TYPE frame_types[2] = { KEY_FRAME, KEY_FRAME };
+  const int layer_ids[2] = { 0, 0 };
+  int qps[2] = { -1, -1 };
+  const uint64_t frame_sizes[2] = { 1000, 1000 };
+  aom::AV1RateControlRtcBatchFrames frames;
+  frames.num_streams = 2;
+  frames.stream_ids = ids;
+  frames.frame_types = frame_types;
+  frames.spatial_layer_ids = layer_ids;
+  frames.temporal_layer_ids = layer_ids;
+  frames.qps = qps;
+  frames.encoded_frame_sizes = frame_sizes;
+  EXPECT_FALSE(batch->ComputeQP(frames));
+  EXPECT_EQ(qps[0], -1);
+  EXPECT_FALSE(batch->PostEncodeUpdate(frames));
+  frames.num_streams = 1;
+  EXPECT_TRUE(batch->ComputeQP(frames));
+  EXPECT_GE(qps[0], 0);
+  EXPECT_TRUE(batch->PostEncodeUpdate(frames));
+
+  // The id of the removed stream is reused.
+  EXPECT_EQ(batch->AddStream(BatchStreamConfig(1)), ids[1]);
+}
+
+
 }  // namespace
@@ -0,0 +1,154 @@
+/*
+ * Copyright (c) 2022, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#include <string.h>
+
+#include <tuple>
+#include <vector>
+
+#include "third_party/googletest/src/googletest/include/gtest/gtest.h"
+
+#include "aom/aom_encoder.h"
+#include "aom/aomcx.h"
+#include "test/i420_video_source.h"
+#include "test/util.h"
+
+namespace {
+
+const int kNumSpatialLayers = 3;
+const int kNumFrames = 10;
+
+// Encodes 3 spatial layers, each predicting from the layer below with a zero
+// motion vector, through the codec API. The test encode driver gets the
+// preview frame after each layer, which would wait for the filtering of the
+// layer below before the next layer starts.
+class SvcLayerPipelineTest
+    : public ::testing::TestWithParam<std::tuple<int, unsigned int>> {
+ protected:
+  SvcLayerPipelineTest()
+      : cpu_used_(std::get<0>(GetParam())),
+        threads_(std::get<1>(GetParam())) {}
+
+  // Sets LAST to the slot of the current layer and GOLDEN to the slot of the
+  // layer below, and refreshes the slot of the current layer.
+  static void SetLayerRefs(int spatial_layer, int is_key_frame,
+                           aom_svc_ref_frame_config_t *ref_frame_config) {
+    memset(ref_frame_config, 0, sizeof(*ref_frame_config));
+    for (int i = 0; i < 7; ++i) {
+      ref_frame_config->ref_idx[i] = spatial_layer > 0 ? spatial_layer - 1 : 0;
+    }
+    ref_frame_config->ref_idx[0] = spatial_layer;
+    ref_frame_config->refresh[spatial_layer] = 1;
+    // On the superframes whose base is a key frame only GOLDEN is used.
+    ref_frame_config->reference[0] = spatial_layer == 0 || !is_key_frame;
+    ref_frame_config->reference[3] = spatial_layer > 0;
+  }
+
+  // Returns the packets of all the layers of all the frames.
+  std::vector<std::vector<uint8_t>> Encode(unsigned int pipeline) {
+    aom_codec_iface_t *const iface = aom_codec_av1_cx();
+    aom_codec_enc_cfg_t cfg;
+    EXPECT_EQ(AOM_CODEC_OK,
+              aom_codec_enc_config_default(iface, &cfg, AOM_USAGE_REALTIME));
+    cfg.g_w = 640;
+    cfg.g_h = 480;
+    cfg.g_timebase.num = 1;
+    cfg.g_timebase.den = 30;
+    cfg.g_threads = threads_;
+    cfg.g_lag_in_frames = 0;
+    cfg.g_error_resilient = 0;
+    cfg.rc_end_usage = AOM_CBR;
+    cfg.rc_target_bitrate = 800;
+    cfg.rc_min_quantizer = 2;
+    cfg.rc_max_quantizer = 60;
+    cfg.kf_max_dist = 9999;
+
+    aom_codec_ctx_t enc;
+    std::vector<std::vector<uint8_t>> packets;
+    EXPECT_EQ(AOM_CODEC_OK, aom_codec_enc_init(&enc, iface, &cfg, 0));
+    if (::testing::Test::HasFailure()) return packets;
+
+    aom_svc_params_t svc_params;
+    memset(&svc_params, 0, sizeof(svc_params));
+    svc_params.number_spatial_layers = kNumSpatialLayers;
+    svc_params.number_temporal_layers = 1;
+    svc_params.framerate_factor[0] = 1;
+    const int layer_target_bitrate[kNumSpatialLayers] = { 100, 250, 450 };
+    for (int sl = 0; sl < kNumSpatialLayers; ++sl) {
+      svc_params.max_quantizers[sl] = 60;
+      svc_params.min_quantizers[sl] = 2;
+      svc_params.layer_target_bitrate[sl] = layer_target_bitrate[sl];
+      svc_params.scaling_factor_num[sl] = 1;
+      svc_params.scaling_factor_den[sl] = 1 << (kNumSpatialLayers - 1 - sl);
+    }
+    EXPECT_EQ(AOM_CODEC_OK,
+              aom_codec_control(&enc, AOME_SET_CPUUSED, cpu_used_));
+    EXPECT_EQ(AOM_CODEC_OK,
+              aom_codec_control(&enc, AV1E_SET_SVC_PARAMS, &svc_params));
+    EXPECT_EQ(AOM_CODEC_OK,
+              aom_codec_control(&enc, AV1E_SET_SVC_LAYER_PIPELINE, pipeline));
+    EXPECT_EQ(AOM_CODEC_OK,
+              aom_codec_control(&enc, AV1E_SET_ENABLE_ORDER_HINT, 0));
+    EXPECT_EQ(AOM_CODEC_OK, aom_codec_control(&enc, AV1E_SET_DELTAQ_MODE, 0));
+
+    libaom_test::I420VideoSource video("niklas_640_480_30.yuv", 640, 480, 30,
+                                       1, 0, kNumFrames);
+    video.Begin();
+    for (int frame = 0; frame < kNumFrames && video.img() != NULL;
+         ++frame, video.Next()) {
+      for (int sl = 0; sl < kNumSpatialLayers; ++sl) {
+        aom_svc_layer_id_t layer_id = { sl, 0 };
+        aom_svc_ref_frame_config_t ref_frame_config;
+        SetLayerRefs(sl, frame == 0, &ref_frame_config);
+        EXPECT_EQ(AOM_CODEC_OK,
+                  aom_codec_control(&enc, AV1E_SET_SVC_LAYER_ID, &layer_id));
+        EXPECT_EQ(AOM_CODEC_OK,
+                  aom_codec_control(&enc, AV1E_SET_SVC_REF_FRAME_CONFIG,
+                                    &ref_frame_config));
+        EXPECT_EQ(AOM_CODEC_OK,
+                  aom_codec_encode(&enc, video.img(), video.pts(), 1, 0));
+        aom_codec_iter_t iter = NULL;
+        const aom_codec_cx_pkt_t *pkt;
+        while ((pkt = aom_codec_get_cx_data(&enc, &iter)) != NULL) {
+          if (pkt->kind != AOM_CODEC_CX_FRAME_PKT) continue;
+          const uint8_t *const buf =
+              static_cast<const uint8_t *>(pkt->data.frame.buf);
+          packets.push_back(
+              std::vector<uint8_t>(buf, buf + pkt->data.frame.sz));
+        }
+      }
+    }
+    EXPECT_EQ(AOM_CODEC_OK, aom_codec_destroy(&enc));
+    return packets;
+  }
+
+  const int cpu_used_;
+  const unsigned int threads_;
+};
+
+TEST_P(SvcLayerPipelineTest, SameBitstream) {
+  const std::vector<std::vector<uint8_t>> ref_packets = Encode(0);
+  const std::vector<std::vector<uint8_t>> packets = Encode(1);
+  ASSERT_EQ(ref_packets.size(),
+            static_cast<size_t>(kNumFrames * kNumSpatialLayers));
+  ASSERT_EQ(ref_packets.size(), packets.size());
+  for (size_t i = 0; i < packets.size(); ++i) {
+    ASSERT_EQ(ref_packets[i], packets[i])
+        << "frame " << i / kNumSpatialLayers << " layer "
+        << i % kNumSpatialLayers;
+  }
+}
+
+INSTANTIATE_TEST_SUITE_P(AV1, SvcLayerPipelineTest,
+                         ::testing::Combine(::testing::Values(7, 9, 10),
+                                            ::testing::Values(1u, 4u)));
+
+}  // namespace
@@ -76,8 +76,12 @@ list(APPEND AOM_UNIT_TEST_ENCODER_SOURCES
             "${AOM_ROOT}/test/cpu_used_firstpass_test.cc"
             "${AOM_ROOT}/test/datarate_test.cc"
             "${AOM_ROOT}/test/datarate_test.h"
+            "${AOM_ROOT}/test/decoder_profile_test.cc"
             "${AOM_ROOT}/test/svc_datarate_test.cc"
             "${AOM_ROOT}/test/encode_api_test.cc"
+            "${AOM_ROOT}/test/firstpass_downscale_test.cc"
+            "${AOM_ROOT}/test/frame_time_budget_test.cc"
+            "${AOM_ROOT}/test/svc_layer_pipeline_test.cc"
             "${AOM_ROOT}/test/encode_small_width_height_test.cc"
             "${AOM_ROOT}/test/encode_test_driver.cc"
             "${AOM_ROOT}/test/encode_test_driver.h"
@@ -105,6 +109,7 @@ if(CONFIG_REALTIME_ONLY)
                    "${AOM_ROOT}/test/cpu_speed_test.cc"
                    "${AOM_ROOT}/test/cpu_used_firstpass_test.cc"
                    "${AOM_ROOT}/test/end_to_end_psnr_test.cc"
+                   "${AOM_ROOT}/test/firstpass_downscale_test.cc"
                    "${AOM_ROOT}/test/gf_pyr_height_test.cc"
                    "${AOM_ROOT}/test/horz_superres_test.cc"
                    "${AOM_ROOT}/test/level_test.cc"
@@ -136,6 +141,7 @@ if(NOT BUILD_SHARED_LIBS)
               "${AOM_ROOT}/test/hiprec_convolve_test.cc"
               "${AOM_ROOT}/test/hiprec_convolve_test_util.cc"
               "${AOM_ROOT}/test/hiprec_convolve_test_util.h"
+              "${AOM_ROOT}/test/intra_dr_edges_test.cc"
               "${AOM_ROOT}/test/intrabc_test.cc"
               "${AOM_ROOT}/test/intrapred_test.cc"
               "${AOM_ROOT}/test/lpf_test.cc"
@@ -159,6 +165,7 @@ if(NOT BUILD_SHARED_LIBS)
                 "${AOM_ROOT}/test/cnn_test.cc"
                 "${AOM_ROOT}/test/coding_path_sync.cc"
                 "${AOM_ROOT}/test/decode_multithreaded_test.cc"
+                "${AOM_ROOT}/test/decodetxb_test.cc"
                 "${AOM_ROOT}/test/divu_small_test.cc"
                 "${AOM_ROOT}/test/dr_prediction_test.cc"
                 "${AOM_ROOT}/test/ec_test.cc"
@@ -274,6 +281,7 @@ if(NOT BUILD_SHARED_LIBS)
               "${AOM_ROOT}/test/fwht4x4_test.cc"
               "${AOM_ROOT}/test/fdct4x4_test.cc"
               "${AOM_ROOT}/test/hadamard_test.cc"
+              "${AOM_ROOT}/test/hash_test.cc"
               "${AOM_ROOT}/test/horver_correlation_test.cc"
               "${AOM_ROOT}/test/masked_sad_test.cc"
               "${AOM_ROOT}/test/masked_variance_test.cc"
@@ -340,10 +348,6 @@ if(NOT BUILD_SHARED_LIBS)
 
   endif()
 
-  if(HAVE_SSE4_2)
-    list(APPEND AOM_UNIT_TEST_ENCODER_SOURCES "${AOM_ROOT}/test/hash_test.cc")
-  endif()
-
 endif()
 
 if(CONFIG_AV1_ENCODER AND ENABLE_TESTS)